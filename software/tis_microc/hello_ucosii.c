@@ -70,7 +70,8 @@ void output(void* pdata)
   while (1)
   { 
     OSTimeDlyHMSM(0, 0, 0, 100);
-    // Read stack
+    // Read stack, tis_system.qsys only maps config and data of the stack
+    // nodes, so the count and status registers aren't reachable here
     int val = *TIS_OUTPUT;
 
     if (val != 0xFFFF) {
@@ -97,7 +98,7 @@ int main(void)
 
 	 char buffer[ASM_SIZE] = ""; // Main buffer to store all input
 	 char line[LINE_SIZE];         // Temporary buffer for each line
-	 uint16_t program[16] = {0};
+	 uint16_t program[TIS_MAX_INSTRUCTIONS] = {0};
 
 	 puts("Enter an assembly program");
 
@@ -31,6 +31,18 @@ int tis_dissassemble(uint16_t instruction, char *buffer) {
         // MOV <SRC>, <DST>
         tis_reg_t src = instruction & register_mask;
         tis_reg_t dst = (instruction >> 11) & register_mask;
+        if (instruction & broadcast_flag) {
+            // MOV <SRC>, <DST>+<DST>
+            int written = sprintf(buffer, "MOV %s, ", regs[src]);
+            const char *separator = "";
+            for (int port = UP; port <= RIGHT; port++) {
+                if (instruction & (1 << (port - UP + broadcast_shift))) {
+                    written += sprintf(&buffer[written], "%s%s", separator, regs[port]);
+                    separator = "+";
+                }
+            }
+            return written;
+        }
         return sprintf(buffer, "MOV %s, %s", regs[src], regs[dst]);
     } else if (instruction & 0x8000) {
         // MOV #<imm11>, <DST>
@@ -44,7 +56,8 @@ int tis_dissassemble(uint16_t instruction, char *buffer) {
         if (instruction & 0x1000) {
             // JMP, JEZ, JNZ, JLZ, JGZ
             tis_opcode_t opcode;
-            switch (instruction & (~imm6_mask)) {
+            uint16_t target_mask = TIS_PC_WIDTH > 6 ? (imm6_mask | jump_ext_mask) : imm6_mask;
+            switch (instruction & (~target_mask)) {
                 case 0x7000:
                     opcode = JMP;
                     break;
@@ -64,7 +77,7 @@ int tis_dissassemble(uint16_t instruction, char *buffer) {
                     return -1;
             }
             // Shows instruction address, not label
-            return sprintf(buffer, "%s 0x%x", opcodes_str[opcode], instruction & imm6_mask);
+            return sprintf(buffer, "%s 0x%x", opcodes_str[opcode], tis_jump_target(instruction));
         } else {
             // JRO
             tis_reg_t src = instruction & register_mask;
@@ -125,6 +138,26 @@ tis_reg_t tis_register_encode(const char *str) {
     return INVALID;
 }
 
+// Encodes a broadcast <DST> such as LEFT+DOWN, ports may be shortened to
+// their first letter (L+R+D) to fit the line length. Returns -1 on error.
+static int tis_broadcast_encode(char *str) {
+    static const char *short_regs[] = {[UP] = "U", [DOWN] = "D", [LEFT] = "L", [RIGHT] = "R"};
+    int ports = 0;
+    char *strtok_ptr = NULL;
+
+    for (char *name = strtok_r(str, "+", &strtok_ptr); name != NULL; name = strtok_r(NULL, "+", &strtok_ptr)) {
+        int port = UP;
+        while (port <= RIGHT && strcmp(name, regs[port]) != 0 && strcmp(name, short_regs[port]) != 0) {
+            port++;
+        }
+        if (port > RIGHT) {
+            return -1;
+        }
+        ports |= 1 << (port - UP + broadcast_shift);
+    }
+    return ports ? ports : -1;
+}
+
 // Number of operands per instruction
 static char asm_operands[] = {
     [NOP] = 0,
@@ -187,6 +220,18 @@ int tis_imm11_encode(int integer) {
     return 999;
 }
 
+uint16_t tis_jump_encode(int target) {
+    return (target & imm6_mask) | ((target << 3) & jump_ext_mask);
+}
+
+int tis_jump_target(uint16_t instruction) {
+    int target = instruction & imm6_mask;
+    if (TIS_PC_WIDTH > 6) {
+        target |= (instruction & jump_ext_mask) >> 3;
+    }
+    return target & TIS_MAX_INSTRUCTIONS;
+}
+
 // Returns number of instructions written, or -1 on error
 int tis_assemble_program(char *program, uint16_t *instructions) {
 
@@ -196,8 +241,8 @@ int tis_assemble_program(char *program, uint16_t *instructions) {
     // PC to increase after every parsed instruction
     int pc = 0;
     // Store label pointers for later linking
-    char *labels_pos[16] = {0};
-    char *labels_ref[16] = {0};
+    char *labels_pos[TIS_MAX_INSTRUCTIONS + 1] = {0};
+    char *labels_ref[TIS_MAX_INSTRUCTIONS + 1] = {0};
 
     // Pointer to current line
     char *line;
@@ -248,6 +293,12 @@ int tis_assemble_program(char *program, uint16_t *instructions) {
             }
         }
 
+        // Check for room in program memory
+        if (pc >= TIS_MAX_INSTRUCTIONS) {
+            printf("Program exceeded maximum of %d instructions\n", TIS_MAX_INSTRUCTIONS);
+            return -1;
+        }
+
         // Check for valid opcode
         tis_opcode_t opcode = tis_opcode_encode(token);
         if (opcode == -1) {
@@ -318,6 +369,22 @@ int tis_assemble_program(char *program, uint16_t *instructions) {
             return -1;
         }
 
+        // Check if <DST> lists several ports
+        if (strchr(dst, '+') != NULL) {
+            int ports = tis_broadcast_encode(dst);
+            if (ports < 0) {
+                printf("Unable to parse <DST> (%s)", dst);
+                return -1;
+            }
+            if ((instructions[pc] & 0xC000) != 0xC000) {
+                puts("Broadcast needs a register <SRC>");
+                return -1;
+            }
+            instructions[pc] |= (ANY << 11) | broadcast_flag | ports;
+            pc++;
+            continue;
+        }
+
         // Check if <DST> is register
         tis_reg_t dst_reg = tis_register_encode(dst);
         if (dst_reg != INVALID) {
@@ -349,7 +416,7 @@ int tis_assemble_program(char *program, uint16_t *instructions) {
             // Check if labels match
             if (strcmp(labels_pos[pos_pc], labels_ref[ref_pc]) == 0) {
                 // Edit instruction referencing label
-                instructions[ref_pc] |= pos_pc & imm6_mask;
+                instructions[ref_pc] |= tis_jump_encode(pos_pc);
             } 
         }
     }
@@ -363,14 +430,15 @@ void tis_disassembler_test() {
         0x0000, 0x01A5, 0x05A5, 0x0806, 
         0x0C00, 0x8AE8, 0xA358, 0xE804, 
         0xD802, 0x4800, 0x5000, 0x4000, 
-        0x6001, 
+        0x6001, 0xF459,
     };
 
     const char *instructions_str[] = {
         "NOP",          "ADD 421",      "SUB 421",       "ADD ANY",
         "SUB NIL",      "MOV 744, ACC", "MOV 856, LEFT", "MOV LEFT, RIGHT",
         "MOV UP, DOWN", "NEG",          "SWP",           "SAV",
-        "JRO ACC",      "JEZ 0x0"
+        "JRO ACC",      "MOV ACC, UP+DOWN+RIGHT",
+        "JEZ 0x0"
     };
 
     for (int i = 0; i < (sizeof(instructions_bin) / sizeof(instructions_bin[0])); i++) {
@@ -386,7 +454,8 @@ void tis_disassembler_test() {
 void tis_assembler_test() {
 	puts("Starting assembler test");
 
-    char* assembly =
+    // tis_assemble_program() tokenizes in place, so the source can't be a literal
+    char assembly[] =
         "START: NOP\n"
         "ADD 421 # TEST\n"
         "TWO: SUB 421\n"
@@ -394,13 +463,14 @@ void tis_assembler_test() {
         "SUB NIL\n"
         "MOV 744, ACC\n"
         "JEZ TWO\n"
+        "MOV ACC, U+D+RIGHT\n"
         "JRO ACC";
 
     uint16_t expected[] = {
-        0x0000, 0x01A5, 0x05A5, 0x0806, 0x0C00, 0x8AE8, 0x7042, 0x6001
+        0x0000, 0x01A5, 0x05A5, 0x0806, 0x0C00, 0x8AE8, 0x7042, 0xF459, 0x6001
     };
 
-    uint16_t result[8];
+    uint16_t result[9];
     int count = tis_assemble_program(assembly, result);
 
     printf("Encoded %d instructions\n", count);
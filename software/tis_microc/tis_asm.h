@@ -38,17 +38,38 @@ typedef enum {
     JRO,
 } tis_opcode_t;
 
+// Program counter width of the execution nodes, PC_WIDTH of tis_execution_node
+#ifndef TIS_PC_WIDTH
+#define TIS_PC_WIDTH 4
+#endif
+
+_Static_assert(TIS_PC_WIDTH >= 4 && TIS_PC_WIDTH <= 7, "TIS_PC_WIDTH must be between 4 and 7");
+
+// Instructions per node, the header takes the first halfword of program memory
+#define TIS_MAX_INSTRUCTIONS ((1 << TIS_PC_WIDTH) - 1)
+
 #define imm6_mask (0x003F)
+// Upper jump target bits, only decoded when TIS_PC_WIDTH is above 6
+#define jump_ext_mask (0x0E00)
 #define imm10_mask (0x3FF)
 #define imm11_mask (0x7FF)
 #define imm11_sign_bit (0x400)
 #define register_mask (0b111)
+// MOV <SRC>, <DST> with bit 10 set writes to every port in bits 6-3, one bit
+// per port from UP. <DST> holds ANY for nodes built without BROADCAST.
+#define broadcast_flag (0x400)
+#define broadcast_shift (3)
+#define broadcast_mask (0x78)
 
 // Returns number of written characters, excluding \0
 int tis_dissassemble(uint16_t instruction, char* buffer);
 
 int tis_assemble_program(char *program, uint16_t *instructions);
 
+// Jump target fields, imm6 extended with bits 11-9 for wide program counters
+uint16_t tis_jump_encode(int target);
+int tis_jump_target(uint16_t instruction);
+
 // Tests assembly decoding
 void tis_disassembler_test();
 void tis_assembler_test();
@@ -0,0 +1,124 @@
+/*
+ * tis_batch.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tis_batch.h"
+
+int tis_batch_load(struct tis_sim *sim, int row, int col, char *source) {
+    uint16_t instructions[TIS_SIM_MAX_INSTRUCTIONS] = {0};
+
+    int count = tis_assemble_program(source, instructions);
+    if (count < 0) {
+        return -1;
+    }
+    if (tis_sim_load(sim, row, col, instructions, count) != 0) {
+        return -1;
+    }
+    return count;
+}
+
+static int tis_batch_outputs_full(const struct tis_batch_stream outputs[], int output_count) {
+    for (int i = 0; i < output_count; i++) {
+        if (outputs[i].position < outputs[i].length) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+uint32_t tis_batch_run(struct tis_sim *sim, struct tis_batch_stream inputs[], int input_count,
+                       struct tis_batch_stream outputs[], int output_count, uint32_t max_cycles) {
+    uint32_t cycles = 0;
+
+    while (cycles < max_cycles && !(output_count && tis_batch_outputs_full(outputs, output_count))) {
+        // Keep the input stacks topped up, they hold TIS_SIM_STACK_LENGTH values
+        for (int i = 0; i < input_count; i++) {
+            struct tis_batch_stream *input = &inputs[i];
+            while (input->position < input->length &&
+                   tis_sim_push(sim, input->row, input->col, input->values[input->position]) == 0) {
+                input->position++;
+            }
+        }
+
+        tis_sim_step(sim);
+        cycles++;
+
+        for (int i = 0; i < output_count; i++) {
+            struct tis_batch_stream *output = &outputs[i];
+            while (output->position < output->length &&
+                   tis_sim_pop(sim, output->row, output->col, &output->values[output->position]) == 0) {
+                output->position++;
+            }
+        }
+    }
+    return cycles;
+}
+
+void tis_batch_retired(const struct tis_sim *sim, uint32_t retired[]) {
+    int node_count = sim->rows * sim->cols;
+    for (int i = 0; i < node_count; i++) {
+        retired[i] = sim->nodes[i].retired;
+    }
+}
+
+void tis_batch_test() {
+    puts("Starting batch test");
+
+    int failures = 0;
+    struct tis_sim sim;
+    struct tis_sim_node nodes[3];
+    char source[] = "MOV UP, ACC\nADD ACC\nMOV ACC, DOWN\n";
+    int16_t input_values[40];
+    int16_t output_values[40] = {0};
+    uint32_t retired[3];
+
+    tis_sim_init(&sim, nodes, 3, 1);
+    tis_sim_stack(&sim, 0, 0, TIS_SIM_STACK_WRITE);
+    tis_sim_stack(&sim, 2, 0, TIS_SIM_STACK_READ);
+    if (tis_batch_load(&sim, 1, 0, source) != 3) {
+        puts("Failed to load doubler");
+        failures++;
+    }
+
+    for (int i = 0; i < 40; i++) {
+        input_values[i] = i - 20;
+    }
+
+    // More values than a stack holds, so the inputs are refilled on the way
+    struct tis_batch_stream input = {0, 0, input_values, 40, 0};
+    struct tis_batch_stream output = {2, 0, output_values, 40, 0};
+
+    // Same timing as the simulator test, one value every 4 cycles
+    uint32_t cycles = tis_batch_run(&sim, &input, 1, &output, 1, 1000);
+    if (output.position != 40 || cycles != 160) {
+        printf("Failed batch run\nExpected: 40 values in 160 cycles\nResult: %lu values in %lu cycles\n",
+               (unsigned long)output.position, (unsigned long)cycles);
+        failures++;
+    }
+
+    for (int i = 0; i < 40; i++) {
+        if (output_values[i] != 2 * input_values[i]) {
+            printf("Failed at %d\nExpected: %d\nResult: %d\n", i, 2 * input_values[i], output_values[i]);
+            failures++;
+        }
+    }
+
+    tis_batch_retired(&sim, retired);
+    if (retired[0] != 0 || retired[1] != 120 || retired[2] != 0) {
+        printf("Failed retired count\nExpected: 120\nResult: %lu\n", (unsigned long)retired[1]);
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Batch success! :)");
+    }
+}
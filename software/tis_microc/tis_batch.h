@@ -0,0 +1,44 @@
+/*
+ * tis_batch.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Runs whole input streams through a tis_sim grid in one call. Streams are
+ * plain int16_t arrays owned by the caller and are read and filled in place,
+ * so a scripting binding can hand over its own array buffers without copying
+ * or calling back for each value. tis_batch_py.cpp does that for NumPy.
+ */
+
+#ifndef TIS_BATCH_H_
+#define TIS_BATCH_H_
+
+#include <stdint.h>
+
+#include "tis_sim.h"
+
+// Values exchanged with the memory mapped side of a stack node
+struct tis_batch_stream {
+    int row;
+    int col;
+    int16_t *values;
+    uint32_t length;   // Values to send, or room for received values
+    uint32_t position; // Values sent or received so far
+};
+
+// Assembles a program and loads it into a node, the source is modified by
+// the assembler. Returns the instruction count or -1.
+int tis_batch_load(struct tis_sim *sim, int row, int col, char *source);
+
+// Feeds the inputs and drains the outputs each cycle until every output is
+// full or max_cycles have run. Returns the number of cycles run.
+uint32_t tis_batch_run(struct tis_sim *sim, struct tis_batch_stream inputs[], int input_count,
+                       struct tis_batch_stream outputs[], int output_count, uint32_t max_cycles);
+
+// Copies the retired instruction count of every node, row major
+void tis_batch_retired(const struct tis_sim *sim, uint32_t retired[]);
+
+// Tests a batch run against the simulator test timings
+void tis_batch_test();
+
+#endif /* TIS_BATCH_H_ */
@@ -0,0 +1,163 @@
+/*
+ * tis_batch_py.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Python module over tis_batch, built by "make -f Makefile.host python".
+ * Streams are NumPy int16 arrays that tis_batch_run() reads and fills in
+ * place, so they have to be C contiguous int16 already and outputs have to
+ * be writable. Nothing is converted or copied. The GIL is released while the
+ * grid runs, but a Grid must only be used by one thread at a time.
+ *
+ *   grid = tis_batch.Grid(3, 1)
+ *   grid.stack(0, 0, tis_batch.STACK_WRITE)
+ *   grid.stack(2, 0, tis_batch.STACK_READ)
+ *   grid.load(1, 0, "MOV UP, ACC\nADD ACC\nMOV ACC, DOWN")
+ *   out = numpy.zeros(40, dtype=numpy.int16)
+ *   cycles, sent, received = grid.run([(0, 0, inp)], [(2, 0, out)], 1000)
+ */
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// tis_asm.h checks TIS_PC_WIDTH with the C11 spelling
+#define _Static_assert static_assert
+extern "C" {
+#include "tis_batch.h"
+}
+
+namespace py = pybind11;
+
+// int16 arrays without conversion, the pointers go to tis_batch as they are
+using tis_py_values = py::array_t<int16_t, py::array::c_style>;
+
+class tis_py_grid {
+public:
+    tis_py_grid(int rows, int cols) {
+        if (rows <= 0 || cols <= 0) {
+            throw py::value_error("grid needs at least one row and column");
+        }
+        nodes.resize(rows * cols);
+        tis_sim_init(&sim, nodes.data(), rows, cols);
+    }
+
+    void stack(int row, int col, uint16_t config) {
+        check_node(row, col);
+        tis_sim_stack(&sim, row, col, config);
+    }
+
+    int load(int row, int col, const std::string &source) {
+        check_node(row, col);
+        // The assembler tokenizes its input in place
+        std::vector<char> buffer(source.begin(), source.end());
+        buffer.push_back('\0');
+        int count = tis_batch_load(&sim, row, col, buffer.data());
+        if (count < 0) {
+            throw py::value_error("program doesn't assemble or doesn't fit in the node");
+        }
+        return count;
+    }
+
+    // Returns the cycles run and the values sent and received per stream
+    std::tuple<uint32_t, std::vector<uint32_t>, std::vector<uint32_t>> run(const py::list &inputs,
+                                                                         const py::list &outputs,
+                                                                         uint32_t max_cycles) {
+        // Holding the arrays keeps their buffers alive without the GIL
+        std::vector<tis_py_values> arrays;
+        std::vector<tis_batch_stream> input_streams = streams(inputs, false, arrays);
+        std::vector<tis_batch_stream> output_streams = streams(outputs, true, arrays);
+
+        uint32_t cycles;
+        {
+            py::gil_scoped_release release;
+            cycles = tis_batch_run(&sim, input_streams.data(), (int)input_streams.size(), output_streams.data(),
+                                   (int)output_streams.size(), max_cycles);
+        }
+
+        std::vector<uint32_t> sent, received;
+        for (const tis_batch_stream &stream : input_streams) {
+            sent.push_back(stream.position);
+        }
+        for (const tis_batch_stream &stream : output_streams) {
+            received.push_back(stream.position);
+        }
+        return std::make_tuple(cycles, sent, received);
+    }
+
+    py::array_t<uint32_t> retired() const {
+        py::array_t<uint32_t> counts(nodes.size());
+        tis_batch_retired(&sim, counts.mutable_data());
+        return counts;
+    }
+
+    uint32_t cycle() const {
+        return sim.cycle;
+    }
+
+private:
+    tis_sim sim;
+    std::vector<tis_sim_node> nodes;
+
+    void check_node(int row, int col) const {
+        if (row < 0 || row >= sim.rows || col < 0 || col >= sim.cols) {
+            throw py::index_error("node outside of the grid");
+        }
+    }
+
+    // Each entry is (row, col, array)
+    std::vector<tis_batch_stream> streams(const py::list &list, bool writable, std::vector<tis_py_values> &arrays) {
+        std::vector<tis_batch_stream> result;
+        for (const py::handle &item : list) {
+            py::tuple entry = item.cast<py::tuple>();
+            if (entry.size() != 3) {
+                throw py::value_error("streams are (row, col, array) tuples");
+            }
+            int row = entry[0].cast<int>();
+            int col = entry[1].cast<int>();
+            check_node(row, col);
+
+            py::object object = entry[2];
+            if (!tis_py_values::check_(object)) {
+                throw py::type_error("stream arrays must be C contiguous numpy.int16, no copy is made");
+            }
+            tis_py_values values = py::reinterpret_borrow<tis_py_values>(object);
+            if (values.ndim() != 1) {
+                throw py::value_error("stream arrays must be one dimensional");
+            }
+            if (writable && !values.writeable()) {
+                throw py::value_error("output arrays must be writable");
+            }
+
+            int16_t *data = writable ? values.mutable_data() : const_cast<int16_t *>(values.data());
+            result.push_back(tis_batch_stream{row, col, data, (uint32_t)values.size(), 0});
+            arrays.push_back(values);
+        }
+        return result;
+    }
+};
+
+PYBIND11_MODULE(tis_batch, m) {
+    m.doc() = "Runs NumPy int16 streams through a tis_sim grid";
+
+    m.attr("STACK_WRITE") = TIS_SIM_STACK_WRITE;
+    m.attr("STACK_READ") = TIS_SIM_STACK_READ;
+
+    py::class_<tis_py_grid>(m, "Grid")
+        .def(py::init<int, int>(), py::arg("rows"), py::arg("cols"))
+        .def("stack", &tis_py_grid::stack, py::arg("row"), py::arg("col"), py::arg("config"),
+             "Makes a node a stack, STACK_WRITE feeds the grid and STACK_READ drains it")
+        .def("load", &tis_py_grid::load, py::arg("row"), py::arg("col"), py::arg("source"),
+             "Assembles a program into an execution node, returns the instruction count")
+        .def("run", &tis_py_grid::run, py::arg("inputs"), py::arg("outputs"), py::arg("max_cycles"),
+             "Streams (row, col, array) inputs into stack nodes and fills the output arrays in place.\n"
+             "Returns (cycles, sent, received).")
+        .def("retired", &tis_py_grid::retired, "Retired instructions of every node, row major")
+        .def_property_readonly("cycle", &tis_py_grid::cycle);
+}
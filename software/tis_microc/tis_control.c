@@ -0,0 +1,232 @@
+/*
+ * tis_control.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tis_control.h"
+
+static volatile uint32_t* tis_control_reg(void *control, int reg) {
+    return (volatile uint32_t*)control + reg;
+}
+
+void* tis_grid_cdc_control(void *base, int rows, int cols) {
+    // The grid takes a power of two of node windows, at least 64 words
+    uint32_t span = TIS_GRID_NODE_SPAN;
+    while (span < TIS_GRID_NODE_SPAN * (uint32_t)(rows * cols)) {
+        span <<= 1;
+    }
+    if (span < 64 * sizeof(uint32_t)) {
+        span = 64 * sizeof(uint32_t);
+    }
+    return (uint8_t*)base + span;
+}
+
+int tis_control_frozen(void *control) {
+    return (*tis_control_reg(control, TIS_CONTROL_STATUS) & TIS_CONTROL_FROZEN) != 0;
+}
+
+int tis_control_freeze(void *control) {
+    *tis_control_reg(control, TIS_CONTROL_STATUS) = TIS_CONTROL_FREEZE;
+
+    for (int i = 0; i < TIS_CONTROL_MAX_POLLS; i++) {
+        if (tis_control_frozen(control)) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void tis_control_freeze_at(void *control, uint32_t cycle) {
+    *tis_control_reg(control, TIS_CONTROL_FREEZE_LOW) = (uint16_t)cycle;
+    *tis_control_reg(control, TIS_CONTROL_FREEZE_HIGH) = (uint16_t)(cycle >> 16);
+    *tis_control_reg(control, TIS_CONTROL_STATUS) = TIS_CONTROL_FREEZE_AT;
+}
+
+void tis_control_resume(void *control) {
+    *tis_control_reg(control, TIS_CONTROL_STATUS) = TIS_CONTROL_RESUME;
+}
+
+uint64_t tis_control_cycles(void *control) {
+    // Reading the lowest register latches the others
+    uint64_t cycles = (uint16_t)*tis_control_reg(control, TIS_CONTROL_CYCLE_LOW);
+    for (int i = 1; i < 4; i++) {
+        cycles |= (uint64_t)(uint16_t)*tis_control_reg(control, TIS_CONTROL_CYCLE_LOW + i) << (16 * i);
+    }
+    return cycles;
+}
+
+void tis_control_run(void *control, uint32_t cycles) {
+    *tis_control_reg(control, TIS_CONTROL_RUN_LOW) = (uint16_t)cycles;
+    *tis_control_reg(control, TIS_CONTROL_RUN_HIGH) = (uint16_t)(cycles >> 16);
+    *tis_control_reg(control, TIS_CONTROL_STATUS) = TIS_CONTROL_RUN;
+}
+
+int tis_control_running(void *control) {
+    return (*tis_control_reg(control, TIS_CONTROL_STATUS) & TIS_CONTROL_RUNNING) != 0;
+}
+
+uint32_t tis_control_run_wait(void *control, uint32_t cycles) {
+    uint64_t start = tis_control_cycles(control);
+    uint16_t status;
+
+    tis_control_run(control, cycles);
+    // Cycles left stay put while frozen
+    do {
+        status = *tis_control_reg(control, TIS_CONTROL_STATUS);
+    } while ((status & TIS_CONTROL_RUNNING) && !(status & TIS_CONTROL_FROZEN));
+
+    return (uint32_t)(tis_control_cycles(control) - start);
+}
+
+void tis_control_break(void *control, int node, int slot, int pc) {
+    volatile uint32_t *reg = tis_control_reg(control, TIS_CONTROL_BREAKPOINTS + node);
+    int shift = slot * TIS_CONTROL_BREAK_SHIFT;
+    uint16_t value = *reg & ~((TIS_CONTROL_BREAK_ENABLE | TIS_CONTROL_BREAK_PC) << shift);
+
+    if (pc >= 0) {
+        value |= (TIS_CONTROL_BREAK_ENABLE | (pc & TIS_CONTROL_BREAK_PC)) << shift;
+    }
+    *reg = value;
+}
+
+int tis_control_break_node(void *control) {
+    if (!(*tis_control_reg(control, TIS_CONTROL_STATUS) & TIS_CONTROL_BREAK_HIT)) {
+        return -1;
+    }
+    return (uint16_t)*tis_control_reg(control, TIS_CONTROL_BREAK_NODE);
+}
+
+int32_t tis_grid_snapshot(void *control, void *grid, int rows, int cols, const char *stack_nodes,
+                          struct tis_node_status status[]) {
+    if (tis_control_freeze(control) != 0) {
+        return -1;
+    }
+
+    int32_t cycle = (int32_t)tis_control_cycles(control);
+    size_t stack_count = strlen(stack_nodes);
+    int captured = 0;
+
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            int index = row * cols + col;
+            void *node = tis_grid_node(grid, cols, row, col);
+
+            // Reads from a stack node would pop its values
+            if ((size_t)index < stack_count && stack_nodes[index] == '1') {
+                memset(&status[index], 0, sizeof(status[index]));
+                continue;
+            }
+            // One capture takes the snapshot of every node
+            if (!captured) {
+                tis_grid_capture(grid, cols, row, col);
+                captured = 1;
+            }
+            tis_node_status(node, &status[index]);
+        }
+    }
+
+    tis_control_resume(control);
+    return cycle;
+}
+
+void tis_control_test() {
+    puts("Starting control test");
+
+    int failures = 0;
+
+    // Controller that froze at cycle 0x12345, freezing sets the frozen bit
+    static uint32_t control[TIS_CONTROL_BREAKPOINTS + 3];
+    control[TIS_CONTROL_CYCLE_LOW] = 0x2345;
+    control[TIS_CONTROL_CYCLE_HIGH] = 0x1;
+
+    // Stack input, execution node, stack output
+    static uint32_t grid[3 * TIS_GRID_NODE_SPAN / sizeof(uint32_t)];
+    struct tis_node_status status[3];
+    uint32_t *regs = (uint32_t*)tis_grid_node(grid, 1, 1, 0) + (((1 << TIS_PC_WIDTH) / 2) << TIS_COUNTERS);
+    regs[0] = (uint32_t)(uint16_t)-5 << 16 | 42;
+    regs[1] = 2;
+    grid[0] = 0xFFFF0000;
+
+    int32_t cycle = tis_grid_snapshot(control, grid, 3, 1, "101", status);
+    if (cycle != 0x12345) {
+        printf("Failed snapshot cycle\nExpected: %d\nResult: %ld\n", 0x12345, (long)cycle);
+        failures++;
+    }
+
+    // The capture write cleared the first status word
+    if (status[1].pc != 2 || status[1].acc != 0 || status[0].pc != 0) {
+        printf("Failed snapshot status\nExpected: PC 2\nResult: PC %d ACC %d\n", status[1].pc, status[1].acc);
+        failures++;
+    }
+
+    if (grid[0] != 0xFFFF0000) {
+        puts("Failed snapshot, touched a stack node");
+        failures++;
+    }
+
+    if (control[TIS_CONTROL_STATUS] != TIS_CONTROL_RESUME) {
+        printf("Failed resume\nExpected: %d\nResult: %lu\n", TIS_CONTROL_RESUME,
+               (unsigned long)control[TIS_CONTROL_STATUS]);
+        failures++;
+    }
+
+    // Upper halfwords of the cycle count
+    control[TIS_CONTROL_CYCLE_LOW + 3] = 0x8000;
+    if (tis_control_cycles(control) != 0x8000000000012345ULL) {
+        puts("Failed 64 bit cycle count");
+        failures++;
+    }
+
+    tis_control_run(control, 0x10002);
+    if (control[TIS_CONTROL_RUN_LOW] != 2 || control[TIS_CONTROL_RUN_HIGH] != 1 ||
+        control[TIS_CONTROL_STATUS] != TIS_CONTROL_RUN) {
+        puts("Failed run cycles");
+        failures++;
+    }
+
+    // Second slot keeps the first
+    tis_control_break(control, 2, 0, 5);
+    tis_control_break(control, 2, 1, 130);
+    if (control[TIS_CONTROL_BREAKPOINTS + 2] != 0x8285) {
+        printf("Failed breakpoints\nExpected: 0x8285\nResult: 0x%lX\n", (unsigned long)control[TIS_CONTROL_BREAKPOINTS + 2]);
+        failures++;
+    }
+    tis_control_break(control, 2, 0, -1);
+    if (control[TIS_CONTROL_BREAKPOINTS + 2] != 0x8200) {
+        printf("Failed clearing breakpoint\nExpected: 0x8200\nResult: 0x%lX\n",
+               (unsigned long)control[TIS_CONTROL_BREAKPOINTS + 2]);
+        failures++;
+    }
+
+    control[TIS_CONTROL_BREAK_NODE] = 2;
+    control[TIS_CONTROL_STATUS] = TIS_CONTROL_FROZEN;
+    if (tis_control_break_node(control) != -1) {
+        puts("Failed breakpoint node without a hit");
+        failures++;
+    }
+    control[TIS_CONTROL_STATUS] = TIS_CONTROL_FROZEN | TIS_CONTROL_BREAK_HIT;
+    if (tis_control_break_node(control) != 2) {
+        puts("Failed breakpoint node");
+        failures++;
+    }
+
+    // Three nodes take the windows of four, the controller at least 64 words in
+    static uint8_t cdc[4 * TIS_GRID_NODE_SPAN + 64 * sizeof(uint32_t)];
+    size_t expected = (4 * TIS_GRID_NODE_SPAN > 64 * sizeof(uint32_t)) ? 4 * TIS_GRID_NODE_SPAN : 64 * sizeof(uint32_t);
+    if ((uint8_t*)tis_grid_cdc_control(cdc, 3, 1) != cdc + expected) {
+        puts("Failed controller base of tis_grid_cdc");
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Control success! :)");
+    }
+}
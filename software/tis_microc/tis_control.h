@@ -0,0 +1,94 @@
+/*
+ * tis_control.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Freezes the grid through the registers of tis_controller. A frozen grid
+ * stops on a TIS cycle boundary with every node in the same cycle, so its
+ * state can be read at leisure and execution resumes without lost cycles.
+ * The controller also runs the grid for a set number of cycles and stops on
+ * PC breakpoints, two per node.
+ *
+ * Every register takes the lower halfword of its own word. tis_grid_cdc maps
+ * them in the upper half of its slave, tis_grid_cdc_control() gives their
+ * base from the base of the slave.
+ */
+
+#ifndef TIS_CONTROL_H_
+#define TIS_CONTROL_H_
+
+#include <stdint.h>
+
+#include "tis_node.h"
+
+// Word offsets of the registers, see tis_controller.vhd
+#define TIS_CONTROL_STATUS 0
+#define TIS_CONTROL_FREEZE_LOW 1
+#define TIS_CONTROL_FREEZE_HIGH 2
+#define TIS_CONTROL_BREAK_NODE 3
+#define TIS_CONTROL_CYCLE_LOW 4 // Up to bit 63 in the next 3 registers
+#define TIS_CONTROL_CYCLE_HIGH 5
+#define TIS_CONTROL_RUN_LOW 8
+#define TIS_CONTROL_RUN_HIGH 9
+#define TIS_CONTROL_BREAKPOINTS 16 // One register per node
+
+// Control bits, written to TIS_CONTROL_STATUS
+#define TIS_CONTROL_FREEZE 0x1
+#define TIS_CONTROL_RESUME 0x2
+#define TIS_CONTROL_FREEZE_AT 0x4
+#define TIS_CONTROL_RUN 0x8
+
+// Status bits, read from TIS_CONTROL_STATUS
+#define TIS_CONTROL_FROZEN 0x1
+#define TIS_CONTROL_PENDING 0x2
+#define TIS_CONTROL_ACTIVE 0x4
+#define TIS_CONTROL_RUNNING 0x8
+#define TIS_CONTROL_BREAK_HIT 0x10
+
+// Breakpoint register of a node, a PC and enable bit per slot
+#define TIS_CONTROL_BREAK_SLOTS 2
+#define TIS_CONTROL_BREAK_PC 0x7F
+#define TIS_CONTROL_BREAK_ENABLE 0x80
+#define TIS_CONTROL_BREAK_SHIFT 8
+
+// Polls before giving up on a freeze, a cycle takes 6 clocks
+#define TIS_CONTROL_MAX_POLLS 1000
+
+// Controller registers of a tis_grid_cdc slave at base, built with the
+// TIS_PC_WIDTH and windows of tis_node.h
+void* tis_grid_cdc_control(void *base, int rows, int cols);
+
+// Freezes after the running cycle, returns -1 when the controller didn't
+int tis_control_freeze(void *control);
+// Freezes once the given number of cycles completed
+void tis_control_freeze_at(void *control, uint32_t cycle);
+void tis_control_resume(void *control);
+int tis_control_frozen(void *control);
+
+// Completed TIS cycles since reset
+uint64_t tis_control_cycles(void *control);
+
+// Runs the given number of cycles and stops, also while tis_enable is low
+void tis_control_run(void *control, uint32_t cycles);
+int tis_control_running(void *control);
+// Runs the given number of cycles and waits for them, returns the cycles
+// that completed, fewer when a freeze or breakpoint stopped the grid
+uint32_t tis_control_run_wait(void *control, uint32_t cycles);
+
+// Stops the grid before node runs the instruction at pc, a negative pc
+// clears the slot. Resuming runs that instruction before it can hit again.
+void tis_control_break(void *control, int node, int slot, int pc);
+// Node that hit a breakpoint since the last resume, -1 without hits
+int tis_control_break_node(void *control);
+
+// Freezes the grid, reads the status of every execution node and resumes.
+// stack_nodes marks stack nodes with '1' like the generic of tis_grid, their
+// entries are cleared. Returns the cycle of the snapshot or -1.
+int32_t tis_grid_snapshot(void *control, void *grid, int rows, int cols, const char *stack_nodes,
+                          struct tis_node_status status[]);
+
+// Tests a snapshot against made up registers
+void tis_control_test();
+
+#endif /* TIS_CONTROL_H_ */
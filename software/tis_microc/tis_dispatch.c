@@ -0,0 +1,264 @@
+/*
+ * tis_dispatch.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "tis_dispatch.h"
+#include "tis_stack.h"
+#ifdef TIS_HOST_BUILD
+#include "tis_sim.h"
+#endif
+
+void* tis_dispatch_replica(const struct tis_dispatch_hw *hw, int replica) {
+    return (uint8_t*)hw->base + (uint32_t)replica * hw->replica_span;
+}
+
+static void* tis_dispatch_hw_stack(const struct tis_dispatch_hw *hw, int replica, uint32_t offset) {
+    return (uint8_t*)tis_dispatch_replica(hw, replica) + offset;
+}
+
+static int tis_dispatch_hw_push(void *ctx, int replica, int16_t value) {
+    const struct tis_dispatch_hw *hw = ctx;
+    volatile uint16_t *stack = tis_dispatch_hw_stack(hw, replica, hw->input_offset);
+
+    if (stack[TIS_STACK_STATUS] & TIS_STACK_FULL) {
+        return -1;
+    }
+    stack[TIS_STACK_DATA] = (uint16_t)value;
+    return 0;
+}
+
+static int tis_dispatch_hw_pop(void *ctx, int replica, int16_t *value) {
+    const struct tis_dispatch_hw *hw = ctx;
+    volatile uint16_t *stack = tis_dispatch_hw_stack(hw, replica, hw->output_offset);
+
+    // The status tells an empty stack apart from a value of -1
+    if (stack[TIS_STACK_STATUS] & TIS_STACK_EMPTY) {
+        return -1;
+    }
+    *value = (int16_t)stack[TIS_STACK_DATA];
+    return 0;
+}
+
+static void tis_dispatch_hw_enable(void *ctx, uint32_t mask) {
+    const struct tis_dispatch_hw *hw = ctx;
+    uint8_t *control = tis_dispatch_replica(hw, hw->replicas);
+    *(volatile uint32_t*)(control + TIS_DISPATCH_ENABLE) = mask;
+}
+
+void tis_dispatch_hw_port(struct tis_dispatch_hw *hw, uint32_t capacity, struct tis_dispatch_port *port) {
+    port->ctx = hw;
+    port->replicas = hw->replicas;
+    port->capacity = capacity;
+    port->push = tis_dispatch_hw_push;
+    port->pop = tis_dispatch_hw_pop;
+    port->enable = tis_dispatch_hw_enable;
+    port->idle = NULL;
+}
+
+int tis_dispatch_run(const struct tis_dispatch_port *port, struct tis_dispatch_job jobs[], int job_count,
+                     uint32_t max_idle) {
+    // Job index running on every replica, -1 when free
+    int running[TIS_DISPATCH_MAX_REPLICAS];
+    int replicas = port->replicas < TIS_DISPATCH_MAX_REPLICAS ? port->replicas : TIS_DISPATCH_MAX_REPLICAS;
+    uint32_t mask = 0;
+    uint32_t idle = 0;
+    int next = 0;
+    int completed = 0;
+
+    for (int i = 0; i < job_count; i++) {
+        if (port->capacity && jobs[i].input_length > port->capacity) {
+            return -1;
+        }
+        jobs[i].sent = 0;
+        jobs[i].received = 0;
+    }
+
+    for (int r = 0; r < replicas; r++) {
+        running[r] = -1;
+    }
+    port->enable(port->ctx, mask);
+
+    while (completed < job_count && idle <= max_idle) {
+        int progress = 0;
+
+        for (int r = 0; r < replicas; r++) {
+            uint32_t bit = (uint32_t)1 << r;
+
+            if (running[r] < 0) {
+                if (next == job_count) {
+                    continue;
+                }
+                running[r] = next++;
+                progress = 1;
+            }
+
+            struct tis_dispatch_job *job = &jobs[running[r]];
+            while (job->sent < job->input_length && port->push(port->ctx, r, job->input[job->sent]) == 0) {
+                job->sent++;
+                progress = 1;
+            }
+
+            if (!(mask & bit)) {
+                mask |= bit;
+                port->enable(port->ctx, mask);
+            }
+
+            while (job->received < job->output_length &&
+                   port->pop(port->ctx, r, &job->output[job->received]) == 0) {
+                job->received++;
+                progress = 1;
+            }
+
+            // Replica stops until the next job is in place
+            if (job->sent == job->input_length && job->received == job->output_length) {
+                mask &= ~bit;
+                port->enable(port->ctx, mask);
+                running[r] = -1;
+                completed++;
+            }
+        }
+
+        if (progress) {
+            idle = 0;
+        } else {
+            idle++;
+            if (port->idle) {
+                port->idle(port->ctx);
+            }
+        }
+    }
+    return completed;
+}
+
+#ifdef TIS_HOST_BUILD
+// Replicas modelled by tis_sim, each a stack input, doubler and stack output
+#define TIS_DISPATCH_TEST_REPLICAS 3
+#define TIS_DISPATCH_TEST_JOBS 8
+
+struct tis_dispatch_test_grid {
+    struct tis_sim sims[TIS_DISPATCH_TEST_REPLICAS];
+    struct tis_sim_node nodes[TIS_DISPATCH_TEST_REPLICAS][3];
+    uint32_t mask;
+};
+
+static int tis_dispatch_test_push(void *ctx, int replica, int16_t value) {
+    struct tis_dispatch_test_grid *grid = ctx;
+    return tis_sim_push(&grid->sims[replica], 0, 0, value);
+}
+
+static int tis_dispatch_test_pop(void *ctx, int replica, int16_t *value) {
+    struct tis_dispatch_test_grid *grid = ctx;
+    return tis_sim_pop(&grid->sims[replica], 2, 0, value);
+}
+
+static void tis_dispatch_test_enable(void *ctx, uint32_t mask) {
+    struct tis_dispatch_test_grid *grid = ctx;
+    grid->mask = mask;
+}
+
+// Only enabled replicas advance, like tis_active gating in hardware
+static void tis_dispatch_test_idle(void *ctx) {
+    struct tis_dispatch_test_grid *grid = ctx;
+    for (int r = 0; r < TIS_DISPATCH_TEST_REPLICAS; r++) {
+        if (grid->mask & (1 << r)) {
+            tis_sim_step(&grid->sims[r]);
+        }
+    }
+}
+
+void tis_dispatch_test() {
+    puts("Starting dispatch test");
+
+    int failures = 0;
+    static struct tis_dispatch_test_grid grid;
+    const uint16_t doubler[] = {0xC802, 0x0801, 0xD801};
+    int16_t inputs[TIS_DISPATCH_TEST_JOBS][20];
+    int16_t outputs[TIS_DISPATCH_TEST_JOBS][20] = {{0}};
+    struct tis_dispatch_job jobs[TIS_DISPATCH_TEST_JOBS];
+
+    for (int r = 0; r < TIS_DISPATCH_TEST_REPLICAS; r++) {
+        tis_sim_init(&grid.sims[r], grid.nodes[r], 3, 1);
+        tis_sim_stack(&grid.sims[r], 0, 0, TIS_SIM_STACK_WRITE);
+        tis_sim_stack(&grid.sims[r], 2, 0, TIS_SIM_STACK_READ);
+        if (tis_sim_load(&grid.sims[r], 1, 0, doubler, 3) != 0) {
+            puts("Failed to load doubler");
+            failures++;
+        }
+    }
+
+    // Jobs of different lengths, some longer than a stack holds
+    for (int i = 0; i < TIS_DISPATCH_TEST_JOBS; i++) {
+        uint32_t length = 1 + (i * 7) % 20;
+        for (uint32_t j = 0; j < length; j++) {
+            inputs[i][j] = (int16_t)(i * 20 + j - 50);
+        }
+        jobs[i] = (struct tis_dispatch_job){inputs[i], length, outputs[i], length, 0, 0};
+    }
+
+    // tis_sim_push reports full stacks, so inputs may stream in
+    struct tis_dispatch_port port = {&grid,
+                                     TIS_DISPATCH_TEST_REPLICAS,
+                                     0,
+                                     tis_dispatch_test_push,
+                                     tis_dispatch_test_pop,
+                                     tis_dispatch_test_enable,
+                                     tis_dispatch_test_idle};
+
+    int completed = tis_dispatch_run(&port, jobs, TIS_DISPATCH_TEST_JOBS, 100);
+    if (completed != TIS_DISPATCH_TEST_JOBS) {
+        printf("Failed dispatch\nExpected: %d jobs\nResult: %d jobs\n", TIS_DISPATCH_TEST_JOBS, completed);
+        failures++;
+    }
+
+    for (int i = 0; i < TIS_DISPATCH_TEST_JOBS; i++) {
+        for (uint32_t j = 0; j < jobs[i].output_length; j++) {
+            if (outputs[i][j] != 2 * inputs[i][j]) {
+                printf("Failed job %d at %lu\nExpected: %d\nResult: %d\n", i, (unsigned long)j, 2 * inputs[i][j],
+                       outputs[i][j]);
+                failures++;
+            }
+        }
+    }
+
+    // Every replica should have taken part
+    for (int r = 0; r < TIS_DISPATCH_TEST_REPLICAS; r++) {
+        if (grid.nodes[r][1].retired == 0) {
+            printf("Failed replica %d\nExpected: retired instructions\nResult: 0\n", r);
+            failures++;
+        }
+    }
+
+    if (grid.mask != 0) {
+        printf("Failed enable mask\nExpected: 0\nResult: %lu\n", (unsigned long)grid.mask);
+        failures++;
+    }
+
+    // A job without outputs completes only once its inputs went past the full stack
+    struct tis_dispatch_job sink = {inputs[5], 16, NULL, 0, 0, 0};
+    port.replicas = 1;
+    if (tis_dispatch_run(&port, &sink, 1, 100) != 1 || sink.sent != sink.input_length) {
+        printf("Failed job without outputs\nExpected: %lu inputs sent\nResult: %lu\n",
+               (unsigned long)sink.input_length, (unsigned long)sink.sent);
+        failures++;
+    }
+
+    // With a capacity, jobs longer than the input stack are refused up front
+    port.capacity = TIS_SIM_STACK_LENGTH;
+    if (tis_dispatch_run(&port, jobs, TIS_DISPATCH_TEST_JOBS, 100) != -1) {
+        puts("Failed to refuse job longer than the input stack");
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Dispatch success! :)");
+    }
+}
+#endif
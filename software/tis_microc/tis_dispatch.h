@@ -0,0 +1,78 @@
+/*
+ * tis_dispatch.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Spreads independent jobs over the replicas of a tis_replicas slave. Every
+ * replica runs one job at a time: its inputs are written to the input stack,
+ * the replica is enabled until all outputs were read from the output stack,
+ * then the next waiting job takes its place. Outputs land in the buffer of
+ * their own job, so results come back in job order whichever replica ran it.
+ */
+
+#ifndef TIS_DISPATCH_H_
+#define TIS_DISPATCH_H_
+
+#include <stdint.h>
+
+// Highest replica count of tis_replicas, one enable bit each
+#define TIS_DISPATCH_MAX_REPLICAS 32
+
+// Control registers after the last replica, see tis_replicas.vhd
+#define TIS_DISPATCH_ENABLE 0x0
+#define TIS_DISPATCH_STATUS 0x4
+
+struct tis_dispatch_job {
+    const int16_t *input;
+    uint32_t input_length;
+    int16_t *output;
+    uint32_t output_length;
+    uint32_t sent;     // Inputs written so far
+    uint32_t received; // Outputs read so far
+};
+
+// Memory mapped side of a set of replicas
+struct tis_dispatch_port {
+    void *ctx;
+    int replicas;
+    // Longest job input, 0 when push reports a full stack by itself
+    uint32_t capacity;
+    // Returns -1 when the input stack is full
+    int (*push)(void *ctx, int replica, int16_t value);
+    // Returns -1 when the output stack is empty
+    int (*pop)(void *ctx, int replica, int16_t *value);
+    // Bit per replica, gates its tis_active
+    void (*enable)(void *ctx, uint32_t mask);
+    // Called when a pass over the replicas made no progress, may be NULL
+    void (*idle)(void *ctx);
+};
+
+// tis_replicas slave, stack offsets are the byte offsets of the input and
+// output stack nodes within a replica (see tis_grid_node)
+struct tis_dispatch_hw {
+    void *base;
+    int replicas;
+    uint32_t replica_span;
+    uint32_t input_offset;
+    uint32_t output_offset;
+};
+
+// Fills in a port that talks to the hardware directly. Pushes check the full
+// flag of the input stack, so capacity may be 0 to stream longer inputs.
+void tis_dispatch_hw_port(struct tis_dispatch_hw *hw, uint32_t capacity, struct tis_dispatch_port *port);
+void* tis_dispatch_replica(const struct tis_dispatch_hw *hw, int replica);
+
+// Runs every job to completion. Returns the number of completed jobs, which
+// is less than job_count after max_idle passes without progress, or -1 when
+// a job doesn't fit in the input stack.
+int tis_dispatch_run(const struct tis_dispatch_port *port, struct tis_dispatch_job jobs[], int job_count,
+                     uint32_t max_idle);
+
+#ifdef TIS_HOST_BUILD
+// Tests the dispatcher against simulated replicas, tis_sim is only part of
+// the host build (Makefile.host)
+void tis_dispatch_test();
+#endif
+
+#endif /* TIS_DISPATCH_H_ */
@@ -0,0 +1,87 @@
+/*
+ * tis_host.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "tis_host.h"
+
+static volatile uint32_t* tis_host_reg(void *port, int reg) {
+    return (volatile uint32_t*)port + reg;
+}
+
+void tis_host_send(void *port, int16_t value) {
+    *tis_host_reg(port, TIS_HOST_DATA) = (uint32_t)(int32_t)value;
+}
+
+int16_t tis_host_receive(void *port) {
+    return (int16_t)*tis_host_reg(port, TIS_HOST_DATA);
+}
+
+int tis_host_try_send(void *port, int16_t value) {
+    if (!(*tis_host_reg(port, TIS_HOST_STATUS) & TIS_HOST_SPACE)) {
+        return -1;
+    }
+    tis_host_send(port, value);
+    return 0;
+}
+
+int tis_host_try_receive(void *port, int16_t *value) {
+    if (!(*tis_host_reg(port, TIS_HOST_STATUS) & TIS_HOST_AVAILABLE)) {
+        return -1;
+    }
+    *value = tis_host_receive(port);
+    return 0;
+}
+
+int16_t tis_host_request(void *port, int16_t value) {
+    tis_host_send(port, value);
+    return tis_host_receive(port);
+}
+
+void tis_host_irq_enable(void *port, uint32_t mask) {
+    *tis_host_reg(port, TIS_HOST_IRQ_ENABLE) = mask;
+}
+
+uint32_t tis_host_round_trip(void *port) {
+    return *tis_host_reg(port, TIS_HOST_ROUND_TRIP);
+}
+
+void tis_host_test() {
+    puts("Starting host port test");
+
+    int failures = 0;
+    static uint32_t regs[4];
+    int16_t value = 0;
+
+    // Node hasn't taken the previous value and has no answer yet
+    regs[TIS_HOST_STATUS] = 0;
+    if (tis_host_try_send(regs, 5) != -1 || tis_host_try_receive(regs, &value) != -1) {
+        puts("Failed to refuse transfers without status bits");
+        failures++;
+    }
+
+    regs[TIS_HOST_STATUS] = TIS_HOST_SPACE;
+    if (tis_host_try_send(regs, -7) != 0 || (int32_t)regs[TIS_HOST_DATA] != -7) {
+        printf("Failed send\nExpected: -7\nResult: %ld\n", (long)(int32_t)regs[TIS_HOST_DATA]);
+        failures++;
+    }
+
+    // Answers are sign extended by the port
+    regs[TIS_HOST_STATUS] = TIS_HOST_AVAILABLE;
+    regs[TIS_HOST_DATA] = (uint32_t)-998;
+    if (tis_host_try_receive(regs, &value) != 0 || value != -998) {
+        printf("Failed receive\nExpected: -998\nResult: %d\n", value);
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Host port success! :)");
+    }
+}
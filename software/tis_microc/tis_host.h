@@ -0,0 +1,47 @@
+/*
+ * tis_host.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Drives a tis_host_port, which lets the CPU stand in for the neighbour on
+ * a free side of an edge node. Values go straight to the node without a
+ * stack node in between, for requests that wait on a single answer.
+ */
+
+#ifndef TIS_HOST_H_
+#define TIS_HOST_H_
+
+#include <stdint.h>
+
+// Word offsets of the registers, see tis_host_port.vhd
+#define TIS_HOST_DATA 0
+#define TIS_HOST_STATUS 1
+#define TIS_HOST_IRQ_ENABLE 2
+#define TIS_HOST_ROUND_TRIP 3
+
+// Status and interrupt enable bits
+#define TIS_HOST_AVAILABLE 0x1
+#define TIS_HOST_SPACE 0x2
+
+// Blocking transfers, the bus waits until the node takes part. Only use them
+// while the grid runs a program that answers.
+void tis_host_send(void *port, int16_t value);
+int16_t tis_host_receive(void *port);
+
+// Non-blocking transfers, return -1 when the node isn't ready
+int tis_host_try_send(void *port, int16_t value);
+int tis_host_try_receive(void *port, int16_t *value);
+
+// Sends a value and waits for the answer
+int16_t tis_host_request(void *port, int16_t value);
+
+void tis_host_irq_enable(void *port, uint32_t mask);
+
+// Clocks from the last send to the next value from the node
+uint32_t tis_host_round_trip(void *port);
+
+// Tests the non-blocking transfers against made up registers
+void tis_host_test();
+
+#endif /* TIS_HOST_H_ */
@@ -6,16 +6,17 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "tis_node.h"
 #include "tis_asm.h"
 
-struct tis_node* configure_node(void* base, const uint16_t instructions[], char instruction_count) {
+struct tis_node* configure_node(void* base, const uint16_t instructions[], int instruction_count) {
     struct tis_node *node = (struct tis_node*) base;
 
-    node->config = instruction_count & 0xF;
+    node->config = instruction_count & TIS_NODE_CONFIG_MASK;
 
-    if (instruction_count > 15) {
+    if (instruction_count > TIS_MAX_INSTRUCTIONS) {
         return (struct tis_node*)0;
     }
 
@@ -27,7 +28,7 @@ struct tis_node* configure_node(void* base, const uint16_t instructions[], char
 }
 
 int node_info(struct tis_node* node, char buffer[]) {
-    char instruction_count = node->config & 0xF;
+    int instruction_count = node->config & TIS_NODE_CONFIG_MASK;
 
     if (!instruction_count) {
         return sprintf(buffer, "Node unconfigured\n");
@@ -46,3 +47,159 @@ int node_info(struct tis_node* node, char buffer[]) {
     return ptr_offset;
 }
 
+void* tis_grid_node(void* base, int cols, int row, int col) {
+    return (char*)base + (row * cols + col) * TIS_GRID_NODE_SPAN;
+}
+
+static const char *status_phases[] = {"RUN", "LEFT", "RIGHT", "UP", "DOWN", "FINISH"};
+static const char *status_regs[] = {"NIL", "ACC", "UP", "DOWN", "LEFT", "RIGHT", "ANY", "LAST"};
+
+static volatile struct tis_node_status_regs* tis_node_status_regs(void* node) {
+    return (volatile struct tis_node_status_regs*)((char*)node + ((sizeof(uint16_t) << TIS_PC_WIDTH) << TIS_COUNTERS));
+}
+
+void tis_grid_capture(void* base, int cols, int row, int col) {
+    *(volatile uint32_t*)tis_node_status_regs(tis_grid_node(base, cols, row, col)) = 0;
+}
+
+void tis_node_status(void* node, struct tis_node_status* status) {
+    volatile struct tis_node_status_regs *regs = tis_node_status_regs(node);
+    uint16_t state = regs->state;
+
+    status->acc = regs->acc;
+    status->bak = regs->bak;
+    status->io_value = regs->io_value;
+    status->pc = state & TIS_STATUS_PC_MASK;
+    status->phase = (state & TIS_STATUS_PHASE_MASK) >> TIS_STATUS_PHASE_SHIFT;
+    status->io_read = (state & TIS_STATUS_IO_READ) != 0;
+    status->io_write = (state & TIS_STATUS_IO_WRITE) != 0;
+    status->last = state >> TIS_STATUS_LAST_SHIFT;
+}
+
+int tis_node_status_info(const struct tis_node_status* status, char buffer[]) {
+    const char *phase = status->phase < 6 ? status_phases[status->phase] : "?";
+    int ptr_offset = sprintf(buffer, "PC %d ACC %d BAK %d %s LAST %s", status->pc, status->acc, status->bak, phase,
+                             status_regs[status->last & register_mask]);
+
+    if (status->io_read) {
+        ptr_offset += sprintf(&buffer[ptr_offset], " reading");
+    } else if (status->io_write) {
+        ptr_offset += sprintf(&buffer[ptr_offset], " writing %d", status->io_value);
+    }
+    buffer[ptr_offset++] = '\n';
+    buffer[ptr_offset] = '\0';
+    return ptr_offset;
+}
+
+void tis_node_status_test() {
+    puts("Starting node status test");
+
+    int failures = 0;
+    char buffer[64];
+    struct tis_node_status status;
+
+    // Program words, then the counters if any, then the snapshot
+    static uint32_t memory[2 << TIS_PC_WIDTH];
+    int window = ((1 << TIS_PC_WIDTH) / 2) << TIS_COUNTERS;
+
+    // ACC 9, BAK -3, writing 9 at PC 1 in TIS_RUN after reading from LEFT
+    memory[window] = (uint32_t)(uint16_t)-3 << 16 | 9;
+    memory[window + 1] = (uint32_t)9 << 16 | LEFT << TIS_STATUS_LAST_SHIFT | TIS_STATUS_IO_WRITE | 1;
+    tis_node_status(memory, &status);
+
+    if (status.acc != 9 || status.bak != -3 || status.pc != 1 || status.phase != 0 || status.io_read ||
+        !status.io_write || status.last != LEFT || status.io_value != 9) {
+        puts("Failed to decode node status");
+        failures++;
+    }
+
+    const char *expected = "PC 1 ACC 9 BAK -3 RUN LAST LEFT writing 9\n";
+    int length = tis_node_status_info(&status, buffer);
+    if (length != (int)strlen(expected) || strcmp(buffer, expected) != 0) {
+        printf("Failed status info\nExpected: %sResult: %s", expected, buffer);
+        failures++;
+    }
+
+    // Capture writes the first status word of the node
+    memory[window] = 1;
+    tis_grid_capture(memory, 1, 0, 0);
+    if (memory[window] != 0) {
+        puts("Failed to capture through the status window");
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Node status success! :)");
+    }
+}
+
+// Without hot swap the window after the status is the next node's program
+#if TIS_HOT_SWAP
+volatile uint32_t* tis_node_swap_control(void* node) {
+    return (volatile uint32_t*)((char*)node + (sizeof(uint16_t) << TIS_PC_WIDTH) * (1 + TIS_COUNTERS + TIS_STATUS));
+}
+
+int tis_node_halt(void* node, int force) {
+    volatile uint32_t *control = tis_node_swap_control(node);
+    *control = force ? TIS_SWAP_FORCE : 0;
+
+    for (int i = 0; i < TIS_SWAP_MAX_POLLS; i++) {
+        if (*control & TIS_SWAP_HALTED) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void tis_node_restart(void* node) {
+    *tis_node_swap_control(node) = TIS_SWAP_ENABLE | TIS_SWAP_RESET;
+}
+
+int tis_node_swap(void* node, const uint16_t instructions[], int instruction_count) {
+    if (tis_node_halt(node, 0) != 0 && tis_node_halt(node, 1) != 0) {
+        return -1;
+    }
+
+    // Neighbours stay blocked on the ports of the halted node meanwhile
+    configure_node(node, instructions, instruction_count);
+    tis_node_restart(node);
+    return 0;
+}
+
+void tis_node_swap_test() {
+    puts("Starting node swap test");
+
+    int failures = 0;
+
+    // Program words, then the counters and status if any, then the control word
+    static uint32_t memory[TIS_GRID_NODE_SPAN / sizeof(uint32_t)];
+    int window = ((1 << TIS_PC_WIDTH) / 2) * (1 + TIS_COUNTERS + TIS_STATUS);
+    const uint16_t program[] = {0x0005};
+
+    // Plain memory never reports a halt, the program must stay untouched
+    memory[0] = 0x1234;
+    if (tis_node_swap(memory, program, 1) != -1 || memory[0] != 0x1234) {
+        puts("Failed to leave a node that didn't halt alone");
+        failures++;
+    }
+    if (memory[window] != TIS_SWAP_FORCE) {
+        printf("Failed forced halt\nExpected: %d\nResult: %lu\n", TIS_SWAP_FORCE, (unsigned long)memory[window]);
+        failures++;
+    }
+
+    tis_node_restart(memory);
+    if (memory[window] != (TIS_SWAP_ENABLE | TIS_SWAP_RESET)) {
+        printf("Failed restart\nExpected: %d\nResult: %lu\n", TIS_SWAP_ENABLE | TIS_SWAP_RESET,
+               (unsigned long)memory[window]);
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Node swap success! :)");
+    }
+}
+#endif
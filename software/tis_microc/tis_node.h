@@ -14,13 +14,101 @@
 
 struct tis_node {
     uint16_t config;
-    uint16_t instructions[15];
+    uint16_t instructions[TIS_MAX_INSTRUCTIONS];
 };
 
-_Static_assert((sizeof(struct tis_node) == sizeof(uint16_t)*16),
+_Static_assert((sizeof(struct tis_node) == sizeof(uint16_t) << TIS_PC_WIDTH),
                "TIS Node struct incorrectly mapped to memory");
 
-struct tis_node* configure_node(void* base, const uint16_t instructions[], char instruction_count);
+// Last instruction index in the node header
+#define TIS_NODE_CONFIG_MASK ((1 << TIS_PC_WIDTH) - 1)
+
+// Whether the grid was built with the counters generic, see tis_perf.h
+#ifndef TIS_COUNTERS
+#define TIS_COUNTERS 0
+#endif
+
+// Whether the grid was built with the status generic
+#ifndef TIS_STATUS
+#define TIS_STATUS 0
+#endif
+
+// Whether the grid was built with the hot_swap generic
+#ifndef TIS_HOT_SWAP
+#define TIS_HOT_SWAP 0
+#endif
+
+// Address space of every node in a tis_grid, 8 words with the default PC width
+// and twice that for each of performance counters, status and hot swap
+#define TIS_GRID_NODE_SPAN (sizeof(uint16_t) << (TIS_PC_WIDTH + TIS_COUNTERS + TIS_STATUS + TIS_HOT_SWAP))
+
+// Runtime state snapshot after the program and the counters, see tis_execution_node.vhd
+struct tis_node_status_regs {
+    int16_t acc;
+    int16_t bak;
+    uint16_t state;
+    int16_t io_value;
+};
+
+#define TIS_STATUS_PC_MASK 0x007F
+#define TIS_STATUS_PHASE_SHIFT 8
+#define TIS_STATUS_PHASE_MASK 0x0700
+#define TIS_STATUS_IO_READ 0x0800
+#define TIS_STATUS_IO_WRITE 0x1000
+#define TIS_STATUS_LAST_SHIFT 13
+
+struct tis_node_status {
+    int16_t acc;
+    int16_t bak;
+    uint8_t pc;
+    uint8_t phase; // tis_state, 0 for TIS_RUN up to 5 for TIS_FINISH
+    uint8_t io_read;
+    uint8_t io_write;
+    uint8_t last; // Register code of the last ANY port, 0 when unset
+    int16_t io_value;
+};
+
+// Hot swap control word after the status window, see tis_execution_node.vhd
+#define TIS_SWAP_ENABLE 0x1
+#define TIS_SWAP_RESET 0x2 // Write only, ignored unless halted
+#define TIS_SWAP_HALTED 0x2 // Read only
+#define TIS_SWAP_FORCE 0x4
+#define TIS_SWAP_PENDING 0x8
+
+// Polls before giving up on a halt, the grid has to be running
+#define TIS_SWAP_MAX_POLLS 1000
+
+struct tis_node* configure_node(void* base, const uint16_t instructions[], int instruction_count);
 int node_info(struct tis_node* node, char buffer[]);
 
+// Base address of a node in a tis_grid, nodes are laid out in row major order
+void* tis_grid_node(void* base, int cols, int row, int col);
+
+// Snapshots every execution node of the grid in the same clock through the
+// status window of one of them, which must not be a stack node
+void tis_grid_capture(void* base, int cols, int row, int col);
+// Reads the last snapshot of an execution node
+void tis_node_status(void* node, struct tis_node_status* status);
+int tis_node_status_info(const struct tis_node_status* status, char buffer[]);
+
+// Tests decoding of a made up snapshot
+void tis_node_status_test();
+
+#if TIS_HOT_SWAP
+// Control word of an execution node, followed by its context
+volatile uint32_t* tis_node_swap_control(void* node);
+// Halts an execution node once its instruction retired, or at the end of
+// the cycle with force. Returns -1 when it didn't halt in time.
+int tis_node_halt(void* node, int force);
+// Resets PC, ACC, BAK and LAST of a halted node and runs it again
+void tis_node_restart(void* node);
+// Replaces the program of a running node while the rest of the grid keeps
+// going. A node blocked on a port is halted with force after the polls ran
+// out, dropping the port operation. Returns -1 when it didn't halt at all.
+int tis_node_swap(void* node, const uint16_t instructions[], int instruction_count);
+
+// Tests the control word writes of a swap on memory that never halts
+void tis_node_swap_test();
+#endif
+
 #endif /* TIS_NODE_H_ */
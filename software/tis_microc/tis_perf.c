@@ -0,0 +1,138 @@
+/*
+ * tis_perf.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tis_perf.h"
+
+// Darker is busier, by tenths of retired instructions per cycle
+static const char perf_shades[] = " .:-=+*#%@";
+static const char perf_ports[TIS_PERF_PORTS] = {'U', 'D', 'L', 'R'};
+
+volatile struct tis_perf_regs* tis_perf_node(void *node) {
+    return (volatile struct tis_perf_regs*)((uint8_t*)node + (sizeof(uint16_t) << TIS_PC_WIDTH));
+}
+
+void tis_perf_read(void *node, struct tis_perf_sample *sample) {
+    volatile struct tis_perf_regs *regs = tis_perf_node(node);
+
+    sample->cycles = regs->cycles;
+    sample->retired = regs->retired;
+    sample->any_cycles = regs->any_cycles;
+    for (int p = 0; p < TIS_PERF_PORTS; p++) {
+        sample->read_stalls[p] = regs->read_stalls[p];
+        sample->write_stalls[p] = regs->write_stalls[p];
+    }
+}
+
+void tis_perf_clear(void *node) {
+    tis_perf_node(node)->clear = 0;
+}
+
+// Port with the most stalled cycles, ANY when that took longer, '-' without stalls
+static char tis_perf_stall(const struct tis_perf_sample *sample) {
+    uint32_t most = 0;
+    char port = '-';
+
+    for (int p = 0; p < TIS_PERF_PORTS; p++) {
+        uint32_t stalls = (uint32_t)sample->read_stalls[p] + sample->write_stalls[p];
+        if (stalls > most) {
+            most = stalls;
+            port = perf_ports[p];
+        }
+    }
+
+    if (sample->any_cycles > most) {
+        port = 'A';
+    }
+    return port;
+}
+
+int tis_perf_report(const struct tis_perf_sample samples[], int rows, int cols, char *buffer, size_t size) {
+    int ptr_offset = snprintf(buffer, size, "Retired per cycle, most stalled port (A = ANY)\n");
+
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols && (size_t)ptr_offset < size; col++) {
+            const struct tis_perf_sample *sample = &samples[row * cols + col];
+            const char *separator = col + 1 < cols ? " |" : "\n";
+
+            if (sample->cycles == 0) {
+                ptr_offset += snprintf(&buffer[ptr_offset], size - ptr_offset, "         %s", separator);
+                continue;
+            }
+
+            uint32_t retired = sample->retired < sample->cycles ? sample->retired : sample->cycles;
+            uint32_t percent = (uint32_t)((uint64_t)retired * 100 / sample->cycles);
+            ptr_offset += snprintf(&buffer[ptr_offset], size - ptr_offset, " %c %3lu%% %c%s",
+                                   perf_shades[percent * 9 / 100], (unsigned long)percent,
+                                   tis_perf_stall(sample), separator);
+        }
+    }
+    return ptr_offset;
+}
+
+void tis_perf_test() {
+    puts("Starting performance counter test");
+
+    int failures = 0;
+    char buffer[256];
+
+    // Program words of a node, then its counters
+    static uint32_t memory[1 << TIS_PC_WIDTH];
+    const int window = (1 << TIS_PC_WIDTH) / 2;
+    struct tis_perf_sample sample;
+
+    memory[window + 0] = 120; // cycles
+    memory[window + 1] = 30;  // retired
+    memory[window + 3] = (uint32_t)7 << 16; // RIGHT read stalls
+    memory[window + 4] = 5;   // UP write stalls
+    memory[window + 6] = 2;   // ANY cycles
+    tis_perf_read(memory, &sample);
+
+    if (sample.cycles != 120 || sample.retired != 30 || sample.any_cycles != 2 ||
+        sample.read_stalls[TIS_PERF_RIGHT] != 7 || sample.write_stalls[TIS_PERF_UP] != 5) {
+        puts("Failed to read counter window");
+        failures++;
+    }
+
+    memory[window + 7] = 1;
+    tis_perf_clear(memory);
+    if (memory[window + 7] != 0 || memory[window - 1] != 0) {
+        puts("Failed to clear through the last counter word");
+        failures++;
+    }
+
+    // Stack node, busy node, node blocked on LEFT, node mostly waiting on ANY
+    struct tis_perf_sample samples[4] = {{0}};
+    samples[1] = (struct tis_perf_sample){100, 100, 0, {0}, {0}};
+    samples[2] = (struct tis_perf_sample){100, 25, 0, {0, 0, 70, 0}, {0}};
+    samples[3] = (struct tis_perf_sample){200, 100, 80, {0}, {0, 50, 0, 0}};
+
+    const char *expected = "Retired per cycle, most stalled port (A = ANY)\n"
+                           "          | @ 100% -\n"
+                           " :  25% L | =  50% A\n";
+    int length = tis_perf_report(samples, 2, 2, buffer, sizeof(buffer));
+    if (length != (int)strlen(expected) || strcmp(buffer, expected) != 0) {
+        printf("Failed report\nExpected:\n%sResult:\n%s", expected, buffer);
+        failures++;
+    }
+
+    // Short buffers stay terminated
+    tis_perf_report(samples, 2, 2, buffer, 20);
+    if (strlen(buffer) != 19) {
+        printf("Failed truncated report\nExpected: 19 characters\nResult: %lu\n", (unsigned long)strlen(buffer));
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Performance counters success! :)");
+    }
+}
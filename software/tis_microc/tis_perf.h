@@ -0,0 +1,68 @@
+/*
+ * tis_perf.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Reads the performance counters of execution nodes built with COUNTERS,
+ * which sit in a second window right after the program of every node.
+ * The report prints a utilization map of the grid, one cell per node with
+ * the share of cycles that retired an instruction and the port it stalled
+ * on the most, so blocked links show up at a glance over the JTAG UART.
+ */
+
+#ifndef TIS_PERF_H_
+#define TIS_PERF_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tis_node.h"
+
+// Stall counters are in PortBit order, like broadcast masks
+#define TIS_PERF_UP 0
+#define TIS_PERF_DOWN 1
+#define TIS_PERF_LEFT 2
+#define TIS_PERF_RIGHT 3
+#define TIS_PERF_PORTS 4
+
+// Stall counters stop at their maximum
+#define TIS_PERF_STALL_MAX 0xFFFF
+
+// Counter window of a node, see tis_execution_node.vhd
+struct tis_perf_regs {
+    uint32_t cycles;
+    uint32_t retired;
+    uint16_t read_stalls[TIS_PERF_PORTS];
+    uint16_t write_stalls[TIS_PERF_PORTS];
+    uint32_t any_cycles;
+    uint32_t clear; // Any write clears all counters
+};
+
+_Static_assert((sizeof(struct tis_perf_regs) == 8 * sizeof(uint32_t)),
+               "TIS performance counters incorrectly mapped to memory");
+
+// Counters of a single node at one point in time
+struct tis_perf_sample {
+    uint32_t cycles;
+    uint32_t retired;
+    uint32_t any_cycles;
+    uint16_t read_stalls[TIS_PERF_PORTS];
+    uint16_t write_stalls[TIS_PERF_PORTS];
+};
+
+// Counter window of an execution node returned by tis_grid_node. Stack nodes
+// have no counters and reads from them pop values, so leave them out.
+volatile struct tis_perf_regs* tis_perf_node(void *node);
+
+void tis_perf_read(void *node, struct tis_perf_sample *sample);
+void tis_perf_clear(void *node);
+
+// Prints a rows by cols map of samples in row major order, nodes without
+// cycles are left blank. Returns the length of the report.
+int tis_perf_report(const struct tis_perf_sample samples[], int rows, int cols, char *buffer, size_t size);
+
+// Tests the report on made up samples
+void tis_perf_test();
+
+#endif /* TIS_PERF_H_ */
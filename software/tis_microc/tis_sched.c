@@ -0,0 +1,283 @@
+/*
+ * tis_sched.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tis_control.h"
+#include "tis_sched.h"
+
+#if TIS_HOT_SWAP
+
+static int tis_sched_is_stack(const char *stack_nodes, int index) {
+    return (size_t)index < strlen(stack_nodes) && stack_nodes[index] == '1';
+}
+
+static int tis_stack_save(void *node, struct tis_node_context *context) {
+    volatile uint16_t *regs = node;
+
+    // Memory reads pop the bottom value
+    context->stack_config = regs[TIS_STACK_CONFIG];
+    context->stack_count = tis_stack_drain(node, context->stack, TIS_CONTEXT_STACK_LENGTH);
+    return 2 + context->stack_count;
+}
+
+static int tis_stack_restore(void *node, const struct tis_node_context *context) {
+    volatile uint16_t *regs = node;
+    int16_t leftover[TIS_CONTEXT_STACK_LENGTH];
+    int words = tis_stack_drain(node, leftover, TIS_CONTEXT_STACK_LENGTH);
+
+    // Memory writes push below the bottom value, so the top goes first
+    for (int i = context->stack_count - 1; i >= 0; i--) {
+        regs[TIS_STACK_DATA] = (uint16_t)context->stack[i];
+    }
+    regs[TIS_STACK_CONFIG] = context->stack_config;
+    return 2 + words + context->stack_count;
+}
+
+// The grid is frozen, so the node halts on the next clock
+static int tis_execution_save(void *node, struct tis_node_context *context) {
+    volatile uint32_t *program = node;
+    volatile uint32_t *control = tis_node_swap_control(node);
+
+    *control = TIS_SWAP_FORCE;
+    for (int i = 0; i < TIS_CONTEXT_PROGRAM_WORDS; i++) {
+        context->program[i] = program[i];
+    }
+    for (int i = 0; i < TIS_CONTEXT_REGS; i++) {
+        context->regs[i] = control[1 + i];
+    }
+    return 1 + TIS_CONTEXT_PROGRAM_WORDS + TIS_CONTEXT_REGS;
+}
+
+static int tis_execution_restore(void *node, const struct tis_node_context *context) {
+    volatile uint32_t *program = node;
+    volatile uint32_t *control = tis_node_swap_control(node);
+
+    *control = TIS_SWAP_FORCE;
+    for (int i = 0; i < TIS_CONTEXT_PROGRAM_WORDS; i++) {
+        program[i] = context->program[i];
+    }
+    for (int i = 0; i < TIS_CONTEXT_REGS; i++) {
+        control[1 + i] = context->regs[i];
+    }
+    *control = TIS_SWAP_ENABLE;
+    return 2 + TIS_CONTEXT_PROGRAM_WORDS + TIS_CONTEXT_REGS;
+}
+
+int tis_grid_save(void *grid, int rows, int cols, const char *stack_nodes, struct tis_node_context nodes[]) {
+    int words = 0;
+
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            int index = row * cols + col;
+            void *node = tis_grid_node(grid, cols, row, col);
+
+            if (tis_sched_is_stack(stack_nodes, index)) {
+                words += tis_stack_save(node, &nodes[index]);
+            } else {
+                words += tis_execution_save(node, &nodes[index]);
+            }
+        }
+    }
+    return words;
+}
+
+int tis_grid_restore(void *grid, int rows, int cols, const char *stack_nodes, const struct tis_node_context nodes[]) {
+    int words = 0;
+
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            int index = row * cols + col;
+            void *node = tis_grid_node(grid, cols, row, col);
+
+            if (tis_sched_is_stack(stack_nodes, index)) {
+                words += tis_stack_restore(node, &nodes[index]);
+            } else {
+                words += tis_execution_restore(node, &nodes[index]);
+            }
+        }
+    }
+    return words;
+}
+
+int tis_sched_init(struct tis_sched *sched, void *control, void *grid, int rows, int cols, const char *stack_nodes,
+                   int link_depth, struct tis_process processes[], int process_count, uint32_t quantum) {
+    memset(sched, 0, sizeof(*sched));
+    sched->control = control;
+    sched->grid = grid;
+    sched->rows = rows;
+    sched->cols = cols;
+    sched->stack_nodes = stack_nodes;
+    sched->link_depth = link_depth;
+    sched->processes = processes;
+    sched->process_count = process_count;
+    sched->current = -1;
+    sched->quantum = quantum;
+    return link_depth > 0 ? -1 : 0;
+}
+
+int tis_sched_switch(struct tis_sched *sched, int next) {
+    uint32_t start = sched->now ? sched->now() : 0;
+    int words = 0;
+
+    // Values in link FIFOs would go to the wrong process
+    if (sched->link_depth > 0) {
+        return -1;
+    }
+
+    if (tis_control_freeze(sched->control) != 0) {
+        return -1;
+    }
+
+    if (sched->current >= 0) {
+        words += tis_grid_save(sched->grid, sched->rows, sched->cols, sched->stack_nodes,
+                               sched->processes[sched->current].nodes);
+    }
+    words += tis_grid_restore(sched->grid, sched->rows, sched->cols, sched->stack_nodes, sched->processes[next].nodes);
+    sched->current = next;
+
+    sched->stats.switches++;
+    sched->stats.words += words;
+    if (sched->now) {
+        sched->stats.time += sched->now() - start;
+    }
+    return 0;
+}
+
+int tis_sched_run(struct tis_sched *sched, int slices) {
+    for (int i = 0; i < slices; i++) {
+        int next = (sched->current + 1) % sched->process_count;
+
+        if (tis_sched_switch(sched, next) != 0) {
+            return -1;
+        }
+
+        // Runs with tis_enable low, so the grid stops after the quantum
+        tis_control_resume(sched->control);
+        sched->processes[next].cycles += tis_control_run_wait(sched->control, sched->quantum);
+    }
+    return 0;
+}
+
+void tis_sched_benchmark(struct tis_sched *sched, int switches, struct tis_sched_stats *stats) {
+    struct tis_sched_stats before = sched->stats;
+
+    for (int i = 0; i < switches; i++) {
+        if (tis_sched_switch(sched, (sched->current + 1) % sched->process_count) != 0) {
+            break;
+        }
+    }
+
+    stats->switches = sched->stats.switches - before.switches;
+    stats->words = sched->stats.words - before.words;
+    stats->time = sched->stats.time - before.time;
+}
+
+int tis_sched_report(const struct tis_sched_stats *stats, char *buffer, size_t size) {
+    uint32_t switches = stats->switches ? stats->switches : 1;
+
+    return snprintf(buffer, size, "%lu switches, %lu words and %lu time per switch\n", (unsigned long)stats->switches,
+                    (unsigned long)(stats->words / switches), (unsigned long)(stats->time / switches));
+}
+
+static uint32_t sched_test_time;
+
+static uint32_t tis_sched_test_now(void) {
+    return sched_test_time += 5;
+}
+
+void tis_sched_test() {
+    puts("Starting scheduler test");
+
+    int failures = 0;
+    char buffer[64];
+
+    // Stack input, execution node, stack output
+    static uint32_t grid[3 * TIS_GRID_NODE_SPAN / sizeof(uint32_t)];
+    static uint32_t control[TIS_CONTROL_BREAKPOINTS];
+    static struct tis_node_context contexts[2][3];
+    struct tis_process processes[2] = {{contexts[0], 0}, {contexts[1], 0}};
+
+    void *node = tis_grid_node(grid, 1, 1, 0);
+    volatile uint32_t *regs = tis_node_swap_control(node);
+    volatile uint16_t *stack = tis_grid_node(grid, 1, 0, 0);
+
+    // Process 0 as it ran, two values 7 in the input stack
+    ((uint32_t*)node)[0] = 0x12340001;
+    regs[1] = 42;
+    regs[2] = (uint32_t)9 << 16 | TIS_STATUS_IO_WRITE | 1;
+    regs[3] = LEFT;
+    stack[TIS_STACK_CONFIG] = 1;
+    stack[TIS_STACK_WINDOW + 1] = 7;
+    stack[TIS_STACK_COUNT] = 2;
+
+    // Process 1 waits on RIGHT with -3 at PC 2
+    contexts[1][1].program[0] = 0x56780002;
+    contexts[1][1].regs[1] = (uint32_t)(uint16_t)-3 << 16 | TIS_STATUS_IO_READ | 2;
+    contexts[1][1].regs[2] = RIGHT;
+    contexts[1][0].stack_config = 1;
+    contexts[1][0].stack_count = 2;
+    contexts[1][0].stack[0] = -5; // Bottom
+    contexts[1][0].stack[1] = 6;
+
+    struct tis_sched sched;
+
+    // Buffered links are refused
+    if (tis_sched_init(&sched, control, grid, 3, 1, "101", 1, processes, 2, 100) != -1 ||
+        tis_sched_switch(&sched, 1) != -1) {
+        puts("Failed to refuse a grid with buffered links");
+        failures++;
+    }
+
+    tis_sched_init(&sched, control, grid, 3, 1, "101", 0, processes, 2, 100);
+    sched.now = tis_sched_test_now;
+    sched.current = 0;
+
+    if (tis_sched_switch(&sched, 1) != 0 || sched.current != 1) {
+        puts("Failed switch");
+        failures++;
+    }
+
+    if (contexts[0][1].program[0] != 0x12340001 || contexts[0][1].regs[0] != 42 ||
+        contexts[0][1].regs[2] != LEFT || contexts[0][0].stack_count != 2 || contexts[0][0].stack[1] != 7) {
+        puts("Failed to save process 0");
+        failures++;
+    }
+
+    // Bottom value is written last
+    if (((uint32_t*)node)[0] != 0x56780002 || regs[0] != TIS_SWAP_ENABLE || regs[3] != RIGHT ||
+        (int16_t)stack[TIS_STACK_DATA] != -5 || stack[TIS_STACK_CONFIG] != 1) {
+        puts("Failed to restore process 1");
+        failures++;
+    }
+
+    struct tis_sched_stats stats;
+    tis_sched_benchmark(&sched, 2, &stats);
+    if (stats.switches != 2 || stats.time != 10 || sched.current != 1 || stats.words == 0) {
+        printf("Failed benchmark\nExpected: 2 switches in 10\nResult: %lu switches in %lu\n",
+               (unsigned long)stats.switches, (unsigned long)stats.time);
+        failures++;
+    }
+
+    stats = (struct tis_sched_stats){4, 100, 20};
+    const char *expected = "4 switches, 25 words and 5 time per switch\n";
+    tis_sched_report(&stats, buffer, sizeof(buffer));
+    if (strcmp(buffer, expected) != 0) {
+        printf("Failed report\nExpected: %sResult: %s", expected, buffer);
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Scheduler success! :)");
+    }
+}
+
+#endif
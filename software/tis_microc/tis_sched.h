@@ -0,0 +1,101 @@
+/*
+ * tis_sched.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Time slices several grid processes on one tis_grid built with hot_swap.
+ * A process is the context of every node: the program, ACC, BAK, PC, LAST
+ * and pending port operation of execution nodes and the config and values
+ * of stack nodes. A switch freezes the grid through tis_controller, saves
+ * the running process, restores the next one and lets it run a quantum.
+ * Values buffered in links with a depth can't be read back by software, so
+ * grids with buffered links are refused. Needs a grid built with hot_swap,
+ * the module is empty otherwise.
+ */
+
+#ifndef TIS_SCHED_H_
+#define TIS_SCHED_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tis_node.h"
+#include "tis_stack.h"
+
+#if TIS_HOT_SWAP
+
+// Program words of an execution node
+#define TIS_CONTEXT_PROGRAM_WORDS ((1 << TIS_PC_WIDTH) / 2)
+// Context words after the control word, see tis_execution_node.vhd
+#define TIS_CONTEXT_REGS 3
+
+// Values saved per stack node, the stack_length generic of tis_grid
+#ifndef TIS_CONTEXT_STACK_LENGTH
+#define TIS_CONTEXT_STACK_LENGTH 15
+#endif
+
+struct tis_node_context {
+    uint32_t program[TIS_CONTEXT_PROGRAM_WORDS];
+    uint32_t regs[TIS_CONTEXT_REGS];
+    // Stack nodes only, bottom value first
+    uint16_t stack_config;
+    uint16_t stack_count;
+    int16_t stack[TIS_CONTEXT_STACK_LENGTH];
+};
+
+struct tis_process {
+    struct tis_node_context *nodes; // rows * cols in row major order
+    uint64_t cycles;                // TIS cycles run so far
+};
+
+// Cost of the switches so far, time in units of the now callback
+struct tis_sched_stats {
+    uint32_t switches;
+    uint32_t words; // Words moved over the bus
+    uint32_t time;
+};
+
+struct tis_sched {
+    void *control; // Registers of tis_controller, see tis_grid_cdc_control()
+    void *grid;
+    int rows;
+    int cols;
+    const char *stack_nodes; // '1' for stack nodes like the generic of tis_grid
+    int link_depth;          // Deepest h_link_depth or v_link_depth of the grid
+    struct tis_process *processes;
+    int process_count;
+    int current;      // Process on the grid, -1 before the first switch
+    uint32_t quantum; // TIS cycles per slice
+    // Timestamp for the stats, may be NULL
+    uint32_t (*now)(void);
+    struct tis_sched_stats stats;
+};
+
+// Moves the context between a frozen grid and memory, returns the words moved.
+// Saving halts the execution nodes and empties the stacks, restoring runs the
+// execution nodes again once the grid resumes.
+int tis_grid_save(void *grid, int rows, int cols, const char *stack_nodes, struct tis_node_context nodes[]);
+int tis_grid_restore(void *grid, int rows, int cols, const char *stack_nodes, const struct tis_node_context nodes[]);
+
+// Returns -1 when the grid has buffered links, switches fail then as well
+int tis_sched_init(struct tis_sched *sched, void *control, void *grid, int rows, int cols, const char *stack_nodes,
+                   int link_depth, struct tis_process processes[], int process_count, uint32_t quantum);
+
+// Puts a process on the grid and leaves the grid frozen, returns -1 when
+// the grid didn't freeze or has buffered links
+int tis_sched_switch(struct tis_sched *sched, int next);
+
+// Runs the processes in turn for a quantum each, returns -1 when a switch failed
+int tis_sched_run(struct tis_sched *sched, int slices);
+
+// Switches between the processes without running them to measure the cost
+void tis_sched_benchmark(struct tis_sched *sched, int switches, struct tis_sched_stats *stats);
+int tis_sched_report(const struct tis_sched_stats *stats, char *buffer, size_t size);
+
+// Tests saving and restoring against made up registers
+void tis_sched_test();
+
+#endif
+
+#endif /* TIS_SCHED_H_ */
@@ -0,0 +1,1397 @@
+/*
+ * tis_sim.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tis_sim.h"
+
+// Ports in the order tis_execution_node.vhd offers reads.
+// Writes are offered on the opposite port during the same phase.
+static const tis_reg_t phases[4] = {LEFT, RIGHT, UP, DOWN};
+
+// Keeps values in the range of the node registers
+static int16_t tis_sim_clamp(int value) {
+    if (value > 999) {
+        return 999;
+    } else if (value < -999) {
+        return -999;
+    }
+    return value;
+}
+
+static tis_reg_t tis_sim_opposite(tis_reg_t port) {
+    switch (port) {
+        case LEFT:
+            return RIGHT;
+        case RIGHT:
+            return LEFT;
+        case UP:
+            return DOWN;
+        case DOWN:
+            return UP;
+        default:
+            return port;
+    }
+}
+
+static int tis_sim_is_port(uint8_t reg) {
+    return reg >= UP && reg <= LAST;
+}
+
+static int tis_sim_phase_of(tis_reg_t port) {
+    for (int p = 0; p < 4; p++) {
+        if (phases[p] == port) {
+            return p;
+        }
+    }
+    return -1;
+}
+
+// A read completes one phase after it was offered, so a MOV between ports
+// writes in the cycle of its read when the write comes two phases later
+static int tis_sim_is_same_cycle(tis_reg_t src, tis_reg_t dst) {
+    return tis_sim_phase_of(tis_sim_opposite(dst)) >= tis_sim_phase_of(src) + 2;
+}
+
+// Decodes an instruction word the same way tis_execution_node.vhd does
+static struct tis_sim_op tis_sim_decode(uint16_t instruction) {
+    struct tis_sim_op op = {.opcode = NOP, .src = NIL, .dst = NIL, .fused = 0, .fanout = 0, .imm = 0};
+
+    switch (instruction >> 14) {
+        case 0b00:
+            // ADD/SUB, NOP is ADD 0
+            if (instruction == 0) {
+                break;
+            }
+            op.opcode = (instruction & 0x400) ? SUB : ADD;
+            if (instruction & 0x800) {
+                op.src = instruction & register_mask;
+            } else {
+                op.src = TIS_SIM_IMM;
+                op.imm = instruction & imm10_mask;
+            }
+            break;
+        case 0b10: {
+            // MOV #<imm11>, <DST>
+            int imm = instruction & imm11_mask;
+            if (imm & imm11_sign_bit) {
+                imm -= imm11_mask + 1;
+            }
+            op.opcode = MOV;
+            op.src = TIS_SIM_IMM;
+            op.imm = tis_sim_clamp(imm);
+            op.dst = (instruction >> 11) & register_mask;
+            break;
+        }
+        case 0b11:
+            // MOV <SRC>, <DST>
+            op.opcode = MOV;
+            op.src = instruction & register_mask;
+            op.dst = (instruction >> 11) & register_mask;
+            // Broadcast as decoded with BROADCAST, the bit order matches TIS_SIM_PORT_BIT
+            if (instruction & broadcast_flag) {
+                op.fanout = (instruction & broadcast_mask) >> broadcast_shift;
+            }
+            break;
+        default:
+            if (TIS_PC_WIDTH > 6 ? (instruction >> 12) == 0x7 : (instruction >> 9) == 0x38) {
+                // Jump condition in bits 8-6
+                switch ((instruction >> 6) & 0b111) {
+                    case 0b000:
+                        op.opcode = JMP;
+                        break;
+                    case 0b001:
+                        op.opcode = JEZ;
+                        break;
+                    case 0b010:
+                        op.opcode = JLZ;
+                        break;
+                    case 0b100:
+                        op.opcode = JGZ;
+                        break;
+                    case 0b110:
+                        op.opcode = JNZ;
+                        break;
+                    default:
+                        return op;
+                }
+                op.imm = tis_jump_target(instruction);
+            } else if ((instruction >> 3) == 0xC00) {
+                op.opcode = JRO;
+                op.src = instruction & register_mask;
+            } else if (instruction == 0x4800) {
+                op.opcode = NEG;
+            } else if (instruction == 0x4000) {
+                op.opcode = SAV;
+            } else if (instruction == 0x5000) {
+                op.opcode = SWP;
+            }
+            break;
+    }
+    return op;
+}
+
+static int tis_sim_has_src(const struct tis_sim_op *op) {
+    return op->opcode == MOV || op->opcode == ADD || op->opcode == SUB || op->opcode == JRO;
+}
+
+static int tis_sim_is_jump(const struct tis_sim_op *op) {
+    return op->opcode >= JMP && op->opcode <= JRO;
+}
+
+// Whether an instruction never touches a port and takes exactly one cycle.
+// LAST is excluded since it can only be resolved at run time.
+static int tis_sim_is_internal(const struct tis_sim_op *op) {
+    if (tis_sim_has_src(op) && tis_sim_is_port(op->src)) {
+        return 0;
+    }
+    if (op->opcode == MOV && tis_sim_is_port(op->dst)) {
+        return 0;
+    }
+    return 1;
+}
+
+// MOV <ACC/NIL/imm>, <port> spends its first cycle fetching the source,
+// so that cycle can end a superinstruction before the write blocks
+static int tis_sim_is_source_stage(const struct tis_sim_op *op) {
+    return op->opcode == MOV && !tis_sim_is_port(op->src) && tis_sim_is_port(op->dst);
+}
+
+static uint8_t tis_sim_next_pc(const struct tis_sim_node *node, uint8_t pc) {
+    return (pc + 1 >= node->instruction_count) ? 0 : pc + 1;
+}
+
+// Marks instruction sequences that can be executed by a single dispatch.
+// The leading instruction may block on ports; the instructions fused behind
+// it must be internal, with a jump or the source stage of a port MOV
+// allowed only in the last position, e.g. MOV <port>, ACC / ADD / MOV ACC,
+// <port> or SUB / Jcc.
+static void tis_sim_predecode(struct tis_sim_node *node, uint8_t fusion) {
+    for (int i = 0; i < node->instruction_count; i++) {
+        node->ops[i] = tis_sim_decode(node->program[i]);
+    }
+
+    if (!fusion) {
+        return;
+    }
+
+    for (int i = 0; i < node->instruction_count; i++) {
+        struct tis_sim_op *head = &node->ops[i];
+        // Only sequential instructions have a known successor
+        if (tis_sim_is_jump(head)) {
+            continue;
+        }
+
+        uint8_t pc = i;
+        while (head->fused < TIS_SIM_MAX_FUSED - 1) {
+            pc = tis_sim_next_pc(node, pc);
+            if (pc == i) {
+                break;
+            }
+
+            const struct tis_sim_op *tail = &node->ops[pc];
+            if (tis_sim_is_source_stage(tail) || tis_sim_is_jump(tail)) {
+                // Can only end a superinstruction
+                if (tis_sim_is_internal(tail) || tis_sim_is_source_stage(tail)) {
+                    head->fused++;
+                }
+                break;
+            }
+            if (!tis_sim_is_internal(tail)) {
+                break;
+            }
+            head->fused++;
+        }
+    }
+}
+
+void tis_sim_init(struct tis_sim *sim, struct tis_sim_node *nodes, int rows, int cols) {
+    memset(sim, 0, sizeof(*sim));
+    memset(nodes, 0, sizeof(*nodes) * rows * cols);
+    sim->rows = rows;
+    sim->cols = cols;
+    sim->nodes = nodes;
+    sim->active = -1;
+    sim->active_dirty = 1;
+    sim->fusion = 1;
+}
+
+struct tis_sim_node *tis_sim_node_at(struct tis_sim *sim, int row, int col) {
+    if (row < 0 || row >= sim->rows || col < 0 || col >= sim->cols) {
+        return NULL;
+    }
+    return &sim->nodes[row * sim->cols + col];
+}
+
+int tis_sim_load(struct tis_sim *sim, int row, int col, const uint16_t instructions[], int instruction_count) {
+    struct tis_sim_node *node = tis_sim_node_at(sim, row, col);
+    if (node == NULL || instruction_count < 1 || instruction_count > TIS_SIM_MAX_INSTRUCTIONS) {
+        return -1;
+    }
+
+    memset(node, 0, sizeof(*node));
+    node->kind = TIS_SIM_EXECUTION;
+    node->instruction_count = instruction_count;
+    for (int i = 0; i < instruction_count; i++) {
+        node->program[i] = instructions[i];
+    }
+    tis_sim_predecode(node, sim->fusion);
+    sim->active_dirty = 1;
+
+    return 0;
+}
+
+void tis_sim_set_fusion(struct tis_sim *sim, uint8_t fusion) {
+    int node_count = sim->rows * sim->cols;
+
+    sim->fusion = fusion;
+    for (int i = 0; i < node_count; i++) {
+        if (sim->nodes[i].kind == TIS_SIM_EXECUTION) {
+            tis_sim_predecode(&sim->nodes[i], fusion);
+        }
+    }
+}
+
+void tis_sim_stack(struct tis_sim *sim, int row, int col, uint16_t config) {
+    struct tis_sim_node *node = tis_sim_node_at(sim, row, col);
+    if (node == NULL) {
+        return;
+    }
+
+    memset(node, 0, sizeof(*node));
+    node->kind = TIS_SIM_STACK;
+    node->config = config;
+    sim->active_dirty = 1;
+}
+
+static int tis_sim_stack_push(struct tis_sim_node *node, int16_t value) {
+    if (node->count == TIS_SIM_STACK_LENGTH) {
+        return -1;
+    }
+    node->values[(node->head + node->count) % TIS_SIM_STACK_LENGTH] = tis_sim_clamp(value);
+    node->count++;
+    return 0;
+}
+
+static int16_t tis_sim_stack_pop(struct tis_sim_node *node) {
+    int16_t value = node->values[node->head];
+    node->head = (node->head + 1) % TIS_SIM_STACK_LENGTH;
+    node->count--;
+    return value;
+}
+
+int tis_sim_push(struct tis_sim *sim, int row, int col, int16_t value) {
+    struct tis_sim_node *node = tis_sim_node_at(sim, row, col);
+    if (node == NULL || node->kind != TIS_SIM_STACK) {
+        return -1;
+    }
+    return tis_sim_stack_push(node, value);
+}
+
+int tis_sim_pop(struct tis_sim *sim, int row, int col, int16_t *value) {
+    struct tis_sim_node *node = tis_sim_node_at(sim, row, col);
+    if (node == NULL || node->kind != TIS_SIM_STACK || node->count == 0) {
+        return -1;
+    }
+    *value = tis_sim_stack_pop(node);
+    return 0;
+}
+
+static struct tis_sim_node *tis_sim_neighbour(struct tis_sim *sim, int index, tis_reg_t port) {
+    int row = index / sim->cols;
+    int col = index % sim->cols;
+
+    switch (port) {
+        case LEFT:
+            return tis_sim_node_at(sim, row, col - 1);
+        case RIGHT:
+            return tis_sim_node_at(sim, row, col + 1);
+        case UP:
+            return tis_sim_node_at(sim, row - 1, col);
+        case DOWN:
+            return tis_sim_node_at(sim, row + 1, col);
+        default:
+            return NULL;
+    }
+}
+
+static int tis_sim_offers_read(const struct tis_sim_node *node, tis_reg_t port) {
+    switch (node->kind) {
+        case TIS_SIM_STACK:
+            return (node->config & TIS_SIM_STACK_READ) && node->count < TIS_SIM_STACK_LENGTH;
+        case TIS_SIM_WIRE:
+            // First wire node reads while it's empty
+            return node->channel_pos == 0 && node->ops[0].src == port && !(node->occupied & 1);
+        case TIS_SIM_SUMMARY:
+        case TIS_SIM_EXECUTION:
+            return node->offer == TIS_SIM_IO_READ && !node->done && (node->io_port == port || node->io_port == ANY);
+        default:
+            return 0;
+    }
+}
+
+static int tis_sim_offers_write(struct tis_sim *sim, const struct tis_sim_node *node, tis_reg_t port, int phase) {
+    switch (node->kind) {
+        case TIS_SIM_STACK:
+            return (node->config & TIS_SIM_STACK_WRITE) && node->count > 0;
+        case TIS_SIM_WIRE: {
+            // Last wire node writes once it has held a value for a cycle
+            const struct tis_sim_node *first = &sim->nodes[node->channel];
+            return node->channel_pos == first->channel_length - 1 && node->ops[0].dst == port &&
+                   !first->channel_out && (first->occupied >> node->channel_pos) & 1;
+        }
+        case TIS_SIM_SUMMARY:
+        case TIS_SIM_EXECUTION:
+            if (phase < node->offer_phase) {
+                return 0;
+            }
+            if (node->fanout) {
+                // Broadcast is offered on every port that hasn't taken it yet
+                return node->offer == TIS_SIM_IO_WRITE && (node->fanout & TIS_SIM_PORT_BIT(port));
+            }
+            return node->offer == TIS_SIM_IO_WRITE && !node->done && (node->io_port == port || node->io_port == ANY);
+        default:
+            return 0;
+    }
+}
+
+static int16_t tis_sim_take(struct tis_sim *sim, struct tis_sim_node *node, tis_reg_t port) {
+    if (node->kind == TIS_SIM_STACK) {
+        return tis_sim_stack_pop(node);
+    }
+    if (node->kind == TIS_SIM_WIRE) {
+        struct tis_sim_node *first = &sim->nodes[node->channel];
+        first->channel_out = 1;
+        return tis_sim_stack_pop(first);
+    }
+    if (node->fanout) {
+        // Broadcast completes with the last port
+        node->fanout &= ~TIS_SIM_PORT_BIT(port);
+        node->done = node->fanout == 0;
+        return node->io_value;
+    }
+    node->done = 1;
+    if (node->io_port == ANY) {
+        node->last = port;
+    }
+    return node->io_value;
+}
+
+static void tis_sim_give(struct tis_sim_node *node, tis_reg_t port, int16_t value) {
+    if (node->kind == TIS_SIM_STACK) {
+        tis_sim_stack_push(node, value);
+        return;
+    }
+    if (node->kind == TIS_SIM_WIRE) {
+        node->channel_in = 1;
+        tis_sim_stack_push(node, value);
+        return;
+    }
+    node->done = 1;
+    node->io_value = value;
+    if (node->io_port == ANY) {
+        node->last = port;
+    }
+}
+
+// Resolves LAST the way the hardware does when decoding
+static tis_reg_t tis_sim_resolve(const struct tis_sim_node *node, uint8_t reg) {
+    return reg == LAST ? node->last : reg;
+}
+
+static int16_t tis_sim_source(const struct tis_sim_node *node, const struct tis_sim_op *op) {
+    switch (op->src) {
+        case TIS_SIM_IMM:
+            return op->imm;
+        case ACC:
+            return node->acc;
+        default:
+            return 0;
+    }
+}
+
+static void tis_sim_set_pc(struct tis_sim_node *node, int pc) {
+    int last = node->instruction_count - 1;
+    if (pc > last) {
+        node->pc = last;
+    } else if (pc < 0) {
+        node->pc = 0;
+    } else {
+        node->pc = pc;
+    }
+}
+
+// Executes the instruction at PC with its source operand.
+// Returns 0 when a MOV still has to write its value to a port.
+static int tis_sim_execute(struct tis_sim_node *node, const struct tis_sim_op *op, int16_t value) {
+    uint8_t next = tis_sim_next_pc(node, node->pc);
+
+    switch (op->opcode) {
+        case MOV: {
+            if (op->fanout) {
+                node->io = TIS_SIM_IO_WRITE;
+                node->io_port = ANY;
+                node->fanout = op->fanout;
+                node->io_value = value;
+                return 0;
+            }
+            tis_reg_t dst = tis_sim_resolve(node, op->dst);
+            if (tis_sim_is_port(dst)) {
+                node->io = TIS_SIM_IO_WRITE;
+                node->io_port = dst;
+                node->io_value = value;
+                return 0;
+            }
+            if (dst == ACC) {
+                node->acc = value;
+            }
+            break;
+        }
+        case ADD:
+            node->acc = tis_sim_clamp(node->acc + value);
+            break;
+        case SUB:
+            node->acc = tis_sim_clamp(node->acc - value);
+            break;
+        case SWP: {
+            int16_t bak = node->bak;
+            node->bak = node->acc;
+            node->acc = bak;
+            break;
+        }
+        case SAV:
+            node->bak = node->acc;
+            break;
+        case NEG:
+            node->acc = -node->acc;
+            break;
+        case JMP:
+            next = op->imm;
+            break;
+        case JEZ:
+            next = node->acc == 0 ? op->imm : next;
+            break;
+        case JNZ:
+            next = node->acc != 0 ? op->imm : next;
+            break;
+        case JGZ:
+            next = node->acc > 0 ? op->imm : next;
+            break;
+        case JLZ:
+            next = node->acc < 0 ? op->imm : next;
+            break;
+        case JRO:
+            tis_sim_set_pc(node, node->pc + value);
+            node->retired++;
+            return 1;
+        default:
+            break;
+    }
+
+    tis_sim_set_pc(node, next);
+    node->retired++;
+    return 1;
+}
+
+#ifdef TIS_SIM_PROFILE
+static void tis_sim_profile(struct tis_sim *sim, struct tis_sim_node *node, uint8_t opcode) {
+    sim->profile[node->profile_prev][opcode]++;
+    node->profile_prev = opcode;
+}
+#endif
+
+// Retires the instruction at PC, followed by the rest of its superinstruction.
+// The fused instructions are executed right away and the node then idles for
+// the cycles they would have taken, so port timing is unchanged.
+static void tis_sim_retire(struct tis_sim *sim, struct tis_sim_node *node, int16_t value) {
+    const struct tis_sim_op *op = &node->ops[node->pc];
+    uint8_t fused = op->fused;
+
+#ifndef TIS_SIM_PROFILE
+    (void)sim;
+#endif
+
+    if (node->io == TIS_SIM_IO_WRITE) {
+        // Value was accepted by a neighbour
+        node->io = TIS_SIM_IO_NONE;
+        node->pc = tis_sim_next_pc(node, node->pc);
+        node->retired++;
+    } else {
+        node->io = TIS_SIM_IO_NONE;
+#ifdef TIS_SIM_PROFILE
+        tis_sim_profile(sim, node, op->opcode);
+#endif
+        if (!tis_sim_execute(node, op, value)) {
+            return;
+        }
+    }
+
+    for (uint8_t i = 0; i < fused; i++) {
+        op = &node->ops[node->pc];
+#ifdef TIS_SIM_PROFILE
+        tis_sim_profile(sim, node, op->opcode);
+#endif
+        tis_sim_execute(node, op, tis_sim_source(node, op));
+        node->stall++;
+    }
+}
+
+// Turns a MOV that read its source during the given phase into the write,
+// offered from the phase where tis_execution_node.vhd can offer it
+static void tis_sim_forward(struct tis_sim *sim, struct tis_sim_node *node, int phase) {
+    const struct tis_sim_op *op = &node->ops[node->pc];
+
+    if (op->opcode != MOV || phase + 2 >= 4) {
+        return;
+    }
+    if (!op->fanout && !tis_sim_is_port(tis_sim_resolve(node, op->dst))) {
+        return;
+    }
+
+#ifdef TIS_SIM_PROFILE
+    tis_sim_profile(sim, node, op->opcode);
+#else
+    (void)sim;
+#endif
+    node->io = TIS_SIM_IO_NONE;
+    tis_sim_execute(node, op, node->io_value);
+    node->offer = TIS_SIM_IO_WRITE;
+    node->offer_phase = phase + 2;
+    node->done = 0;
+}
+
+// RUN: decode the instruction at PC unless a port operation is pending
+static void tis_sim_run_phase(struct tis_sim_node *node) {
+    node->done = 0;
+    node->offer = TIS_SIM_IO_NONE;
+    node->offer_phase = 0;
+
+    if (node->stall) {
+        node->stall--;
+        return;
+    }
+
+    if (node->io != TIS_SIM_IO_NONE) {
+        node->offer = node->io;
+        return;
+    }
+
+    const struct tis_sim_op *op = &node->ops[node->pc];
+    tis_reg_t src = tis_sim_has_src(op) ? tis_sim_resolve(node, op->src) : NIL;
+
+    if (tis_sim_is_port(src)) {
+        node->io = TIS_SIM_IO_READ;
+        node->io_port = src;
+        node->offer = TIS_SIM_IO_READ;
+    } else {
+        // Fetching the source always completes within the cycle
+        node->io_value = tis_sim_source(node, op);
+        node->done = 1;
+    }
+}
+
+// FINISH: apply the result of a completed instruction
+static void tis_sim_finish_phase(struct tis_sim *sim, struct tis_sim_node *node) {
+    if (node->done) {
+        tis_sim_retire(sim, node, node->io_value);
+    }
+}
+
+// Whether a node only runs MOV <port>, <port> and hasn't started yet.
+// Turns that write in the cycle of their read are left to the plain model.
+static int tis_sim_is_wire(const struct tis_sim_node *node) {
+    if (node->kind != TIS_SIM_EXECUTION || node->instruction_count != 1 || node->io != TIS_SIM_IO_NONE) {
+        return 0;
+    }
+
+    const struct tis_sim_op *op = &node->ops[0];
+    return op->opcode == MOV && op->src >= UP && op->src <= RIGHT && op->dst >= UP && op->dst <= RIGHT &&
+           op->src != op->dst && !tis_sim_is_same_cycle(op->src, op->dst);
+}
+
+// Wire node that the given wire node writes to, if any
+static struct tis_sim_node *tis_sim_wire_next(struct tis_sim *sim, int index) {
+    tis_reg_t dst = sim->nodes[index].ops[0].dst;
+    struct tis_sim_node *next = tis_sim_neighbour(sim, index, dst);
+
+    if (next == NULL || !tis_sim_is_wire(next) || next->ops[0].src != tis_sim_opposite(dst)) {
+        return NULL;
+    }
+    return next;
+}
+
+// A wire node holds at most one value, reads while empty and writes from the
+// cycle after its read. Since transfers only depend on the state at the start
+// of a cycle, a chain of them behaves like a shift register with bubbles: one
+// occupancy bit per node plus the values in order.
+int tis_sim_collapse(struct tis_sim *sim) {
+    int node_count = sim->rows * sim->cols;
+    int channels = 0;
+
+    for (int i = 0; i < node_count; i++) {
+        if (!tis_sim_is_wire(&sim->nodes[i])) {
+            continue;
+        }
+
+        // Only start at the beginning of a chain, rings of wire nodes never move data
+        tis_reg_t src = sim->nodes[i].ops[0].src;
+        struct tis_sim_node *prev = tis_sim_neighbour(sim, i, src);
+        if (prev != NULL && tis_sim_is_wire(prev) && prev->ops[0].dst == tis_sim_opposite(src)) {
+            continue;
+        }
+
+        int index = i;
+        while (index >= 0) {
+            // Each channel keeps its values in a stack sized buffer
+            int first_index = index;
+            struct tis_sim_node *first = &sim->nodes[first_index];
+            int length = 0;
+
+            struct tis_sim_node *node = first;
+            while (node != NULL && length < TIS_SIM_STACK_LENGTH) {
+                int node_index = node - sim->nodes;
+                struct tis_sim_node *next = tis_sim_wire_next(sim, node_index);
+
+                node->channel = first_index;
+                node->channel_pos = length++;
+                node->kind = TIS_SIM_WIRE;
+
+                index = (next != NULL) ? next - sim->nodes : -1;
+                node = next;
+            }
+
+            first->channel_length = length;
+            first->occupied = 0;
+            first->head = 0;
+            first->count = 0;
+            channels++;
+        }
+    }
+
+    sim->active_dirty = 1;
+    return channels;
+}
+
+// Symbolic value while summarizing: affine in the input and in the ACC/BAK
+// an item starts with, some function of the input only, or unknown
+typedef enum {
+    TIS_SIM_FORM_AFFINE,
+    TIS_SIM_FORM_INPUT,
+    TIS_SIM_FORM_UNKNOWN,
+} tis_sim_form_kind_t;
+
+struct tis_sim_form {
+    tis_sim_form_kind_t kind;
+    int32_t input;
+    int32_t acc;
+    int32_t bak;
+    int32_t constant;
+};
+
+static struct tis_sim_form tis_sim_form_const(int32_t value) {
+    struct tis_sim_form form = {.kind = TIS_SIM_FORM_AFFINE, .constant = value};
+    return form;
+}
+
+static int tis_sim_form_is_const(struct tis_sim_form form) {
+    return form.kind == TIS_SIM_FORM_AFFINE && form.input == 0 && form.acc == 0 && form.bak == 0;
+}
+
+// Whether a value can depend on an earlier item
+static int tis_sim_form_is_stateful(struct tis_sim_form form) {
+    return form.kind == TIS_SIM_FORM_UNKNOWN || (form.kind == TIS_SIM_FORM_AFFINE && (form.acc || form.bak));
+}
+
+// Sum of two values, no longer affine once the result could saturate
+static struct tis_sim_form tis_sim_form_add(struct tis_sim_form a, struct tis_sim_form b, int sign) {
+    struct tis_sim_form form = {.kind = TIS_SIM_FORM_AFFINE};
+
+    if (a.kind == TIS_SIM_FORM_AFFINE && b.kind == TIS_SIM_FORM_AFFINE) {
+        form.input = a.input + sign * b.input;
+        form.acc = a.acc + sign * b.acc;
+        form.bak = a.bak + sign * b.bak;
+        form.constant = a.constant + sign * b.constant;
+
+        int32_t range = (abs(form.input) + abs(form.acc) + abs(form.bak)) * 999;
+        if (abs(form.constant) + range <= 999) {
+            return form;
+        }
+    }
+
+    memset(&form, 0, sizeof(form));
+    form.kind = (tis_sim_form_is_stateful(a) || tis_sim_form_is_stateful(b)) ? TIS_SIM_FORM_UNKNOWN : TIS_SIM_FORM_INPUT;
+    return form;
+}
+
+static struct tis_sim_form tis_sim_form_neg(struct tis_sim_form form) {
+    form.input = -form.input;
+    form.acc = -form.acc;
+    form.bak = -form.bak;
+    form.constant = -form.constant;
+    return form;
+}
+
+// Executes one item from PC 0 until the program wraps back to PC 0, with the
+// input and the starting ACC/BAK as symbols. The node is stateless when it
+// reads and writes a fixed port once, every jump is decided by constants and
+// the written value doesn't depend on the starting ACC/BAK.
+int tis_sim_summarize_node(const struct tis_sim_node *node, struct tis_sim_summary *summary) {
+    if (node->kind != TIS_SIM_EXECUTION) {
+        return -1;
+    }
+
+    memset(summary, 0, sizeof(*summary));
+
+    struct tis_sim_form acc = {.kind = TIS_SIM_FORM_AFFINE, .acc = 1};
+    struct tis_sim_form bak = {.kind = TIS_SIM_FORM_AFFINE, .bak = 1};
+    struct tis_sim_form input = {.kind = TIS_SIM_FORM_AFFINE, .input = 1};
+    struct tis_sim_form output = {0};
+
+    uint8_t last = node->instruction_count - 1;
+    uint8_t visited[TIS_SIM_MAX_INSTRUCTIONS] = {0};
+    uint8_t pc = 0;
+    int reads = 0;
+    int writes = 0;
+    int cycle = 0;
+    int read_cycle = 0;
+    int write_cycle = 0;
+
+    do {
+        // Looping without wrapping never finishes an item
+        if (visited[pc]) {
+            return -1;
+        }
+        visited[pc] = 1;
+
+        const struct tis_sim_op *op = &node->ops[pc];
+        uint8_t index = summary->trace_length++;
+        uint8_t next = tis_sim_next_pc(node, pc);
+        summary->trace[index] = *op;
+        cycle++;
+
+        struct tis_sim_form value = tis_sim_form_const(0);
+        if (tis_sim_has_src(op)) {
+            if (op->src == ANY || op->src == LAST) {
+                return -1;
+            } else if (tis_sim_is_port(op->src)) {
+                if (reads++) {
+                    return -1;
+                }
+                summary->in_port = op->src;
+                summary->read_index = index;
+                read_cycle = cycle;
+                value = input;
+            } else if (op->src == ACC) {
+                value = acc;
+            } else if (op->src == TIS_SIM_IMM) {
+                value = tis_sim_form_const(op->imm);
+            }
+        }
+
+        switch (op->opcode) {
+            case MOV:
+                if (op->dst == ANY || op->dst == LAST) {
+                    return -1;
+                } else if (tis_sim_is_port(op->dst)) {
+                    if (writes++ || !reads || tis_sim_form_is_stateful(value)) {
+                        return -1;
+                    }
+                    // Summary nodes write from the cycle after the read
+                    if (tis_sim_is_port(op->src) && tis_sim_is_same_cycle(op->src, op->dst)) {
+                        return -1;
+                    }
+                    output = value;
+                    summary->out_port = op->dst;
+                    summary->write_index = index;
+                    // Offered from the cycle after the source was obtained
+                    cycle++;
+                    write_cycle = cycle;
+                } else if (op->dst == ACC) {
+                    acc = value;
+                }
+                break;
+            case ADD:
+                acc = tis_sim_form_add(acc, value, 1);
+                break;
+            case SUB:
+                // Exact even when ACC is unknown
+                acc = (op->src == ACC) ? tis_sim_form_const(0) : tis_sim_form_add(acc, value, -1);
+                break;
+            case SWP: {
+                struct tis_sim_form swap = acc;
+                acc = bak;
+                bak = swap;
+                break;
+            }
+            case SAV:
+                bak = acc;
+                break;
+            case NEG:
+                acc = tis_sim_form_neg(acc);
+                break;
+            case JMP:
+            case JEZ:
+            case JNZ:
+            case JGZ:
+            case JLZ: {
+                if (op->opcode != JMP && !tis_sim_form_is_const(acc)) {
+                    return -1;
+                }
+                int32_t value = acc.constant;
+                int taken = op->opcode == JMP || (op->opcode == JEZ && value == 0) ||
+                            (op->opcode == JNZ && value != 0) || (op->opcode == JGZ && value > 0) ||
+                            (op->opcode == JLZ && value < 0);
+                if (taken) {
+                    next = (op->imm > last) ? last : op->imm;
+                }
+                break;
+            }
+            case JRO: {
+                if (!tis_sim_form_is_const(value)) {
+                    return -1;
+                }
+                int32_t target = pc + value.constant;
+                next = (target > last) ? last : (target < 0) ? 0 : target;
+                break;
+            }
+            default:
+                break;
+        }
+
+        pc = next;
+    } while (pc != 0);
+
+    if (reads != 1 || writes != 1) {
+        return -1;
+    }
+
+    summary->pre = read_cycle - 1;
+    summary->middle = write_cycle - read_cycle - 1;
+    summary->post = cycle - write_cycle;
+    summary->cycles = cycle;
+
+    if (output.kind == TIS_SIM_FORM_AFFINE) {
+        summary->affine = 1;
+        summary->scale = output.input;
+        summary->offset = output.constant;
+    }
+
+    return 0;
+}
+
+int16_t tis_sim_summary_eval(const struct tis_sim_summary *summary, int16_t input) {
+    if (summary->affine) {
+        return summary->scale * input + summary->offset;
+    }
+
+    // Output doesn't depend on the starting registers, so any will do
+    int16_t acc = 0;
+    int16_t bak = 0;
+
+    for (uint8_t i = 0; i <= summary->write_index; i++) {
+        const struct tis_sim_op *op = &summary->trace[i];
+        int16_t value = 0;
+        if (i == summary->read_index) {
+            value = input;
+        } else if (op->src == TIS_SIM_IMM) {
+            value = op->imm;
+        } else if (op->src == ACC) {
+            value = acc;
+        }
+
+        switch (op->opcode) {
+            case MOV:
+                if (i == summary->write_index) {
+                    return value;
+                } else if (op->dst == ACC) {
+                    acc = value;
+                }
+                break;
+            case ADD:
+                acc = tis_sim_clamp(acc + value);
+                break;
+            case SUB:
+                acc = tis_sim_clamp(acc - value);
+                break;
+            case SWP: {
+                int16_t swap = acc;
+                acc = bak;
+                bak = swap;
+                break;
+            }
+            case SAV:
+                bak = acc;
+                break;
+            case NEG:
+                acc = -acc;
+                break;
+            default:
+                break;
+        }
+    }
+    return 0;
+}
+
+int tis_sim_summarize(struct tis_sim *sim) {
+    int node_count = sim->rows * sim->cols;
+    int summarized = 0;
+
+    for (int i = 0; i < node_count; i++) {
+        struct tis_sim_node *node = &sim->nodes[i];
+        if (node->io != TIS_SIM_IO_NONE || node->pc != 0 || node->stall) {
+            continue;
+        }
+        if (tis_sim_summarize_node(node, &node->summary) != 0) {
+            continue;
+        }
+
+        node->kind = TIS_SIM_SUMMARY;
+        node->stall = node->summary.pre;
+        summarized++;
+    }
+    return summarized;
+}
+
+// RUN for a summary node: offer the read, or the write of its result
+static void tis_sim_summary_run_phase(struct tis_sim_node *node) {
+    node->done = 0;
+    node->offer = TIS_SIM_IO_NONE;
+
+    if (node->stall) {
+        node->stall--;
+        return;
+    }
+
+    if (node->io == TIS_SIM_IO_NONE) {
+        node->io = TIS_SIM_IO_READ;
+        node->io_port = node->summary.in_port;
+    }
+    node->offer = node->io;
+}
+
+// FINISH for a summary node: the whole item is computed once the read completes
+static void tis_sim_summary_finish_phase(struct tis_sim_node *node) {
+    const struct tis_sim_summary *summary = &node->summary;
+
+    if (!node->done) {
+        return;
+    }
+
+    if (node->io == TIS_SIM_IO_READ) {
+        node->io = TIS_SIM_IO_WRITE;
+        node->io_port = summary->out_port;
+        node->io_value = tis_sim_summary_eval(summary, node->io_value);
+        node->stall = summary->middle;
+    } else {
+        node->io = TIS_SIM_IO_NONE;
+        node->stall = summary->post + summary->pre;
+        node->retired += summary->trace_length;
+    }
+}
+
+// FINISH for a channel: values move into empty nodes, based on the occupancy
+// at the start of the cycle
+static void tis_sim_channel_finish(struct tis_sim_node *first) {
+    uint16_t last = 1 << (first->channel_length - 1);
+    uint16_t full = (last << 1) - 1;
+    uint16_t occupied = first->occupied;
+    uint16_t moved = (occupied << 1) & ~occupied & full;
+
+    occupied = (occupied & ~(moved >> 1)) | moved;
+    if (first->channel_out) {
+        occupied &= ~last;
+    }
+    if (first->channel_in) {
+        occupied |= 1;
+    }
+
+    first->occupied = occupied;
+    first->channel_in = 0;
+    first->channel_out = 0;
+}
+
+// Links the nodes that take part in a cycle, skipping unused and inner wire nodes
+static void tis_sim_link_active(struct tis_sim *sim) {
+    int node_count = sim->rows * sim->cols;
+    int *link = &sim->active;
+
+    for (int i = 0; i < node_count; i++) {
+        struct tis_sim_node *node = &sim->nodes[i];
+        if (node->kind == TIS_SIM_UNUSED || (node->kind == TIS_SIM_WIRE && node->channel_pos != 0)) {
+            continue;
+        }
+        *link = i;
+        link = &node->next_active;
+    }
+    *link = -1;
+    sim->active_dirty = 0;
+}
+
+// Stores the ports each node offers in a phase, before any transfer happens
+static void tis_sim_record_ports(struct tis_sim *sim, int phase) {
+    tis_reg_t port = phases[phase];
+    tis_reg_t opposite = tis_sim_opposite(port);
+
+    for (int i = sim->active; i >= 0; i = sim->nodes[i].next_active) {
+        struct tis_sim_node *node = &sim->nodes[i];
+        uint8_t offers = 0;
+
+        if (tis_sim_offers_read(node, port)) {
+            offers |= TIS_SIM_PORT_BIT(port);
+        }
+        if (tis_sim_offers_write(sim, node, opposite, phase)) {
+            offers |= TIS_SIM_PORT_BIT(opposite);
+        }
+        node->port_offers[phase] = offers;
+    }
+}
+
+void tis_sim_step(struct tis_sim *sim) {
+    if (sim->active_dirty) {
+        tis_sim_link_active(sim);
+    }
+
+    for (int i = sim->active; i >= 0; i = sim->nodes[i].next_active) {
+        if (sim->nodes[i].kind == TIS_SIM_EXECUTION) {
+            tis_sim_run_phase(&sim->nodes[i]);
+        } else if (sim->nodes[i].kind == TIS_SIM_SUMMARY) {
+            tis_sim_summary_run_phase(&sim->nodes[i]);
+        }
+    }
+
+    // LEFT, RIGHT, UP, DOWN: readers on a port meet the writer on the other side
+    for (int p = 0; p < 4; p++) {
+        tis_reg_t port = phases[p];
+        tis_reg_t opposite = tis_sim_opposite(port);
+
+        if (sim->record_ports) {
+            tis_sim_record_ports(sim, p);
+        }
+
+        for (int i = sim->active; i >= 0; i = sim->nodes[i].next_active) {
+            struct tis_sim_node *reader = &sim->nodes[i];
+            if (!tis_sim_offers_read(reader, port)) {
+                continue;
+            }
+
+            struct tis_sim_node *writer = tis_sim_neighbour(sim, i, port);
+            if (writer == NULL || !tis_sim_offers_write(sim, writer, opposite, p)) {
+                continue;
+            }
+
+            tis_sim_give(reader, port, tis_sim_take(sim, writer, opposite));
+            if (reader->kind == TIS_SIM_EXECUTION) {
+                tis_sim_forward(sim, reader, p);
+            }
+        }
+    }
+
+    for (int i = sim->active; i >= 0; i = sim->nodes[i].next_active) {
+        struct tis_sim_node *node = &sim->nodes[i];
+        if (node->kind == TIS_SIM_EXECUTION) {
+            tis_sim_finish_phase(sim, node);
+        } else if (node->kind == TIS_SIM_WIRE) {
+            tis_sim_channel_finish(node);
+        } else if (node->kind == TIS_SIM_SUMMARY) {
+            tis_sim_summary_finish_phase(node);
+        }
+    }
+
+    sim->cycle++;
+}
+
+void tis_sim_run(struct tis_sim *sim, uint32_t cycles) {
+    for (uint32_t i = 0; i < cycles; i++) {
+        tis_sim_step(sim);
+    }
+}
+
+#ifdef TIS_SIM_PROFILE
+static const char *profile_str[JRO + 1] = {
+    [NOP] = "NOP", [MOV] = "MOV", [ADD] = "ADD", [SUB] = "SUB", [SWP] = "SWP",
+    [SAV] = "SAV", [NEG] = "NEG", [JMP] = "JMP", [JEZ] = "JEZ", [JNZ] = "JNZ",
+    [JGZ] = "JGZ", [JLZ] = "JLZ", [JRO] = "JRO",
+};
+
+int tis_sim_profile_report(struct tis_sim *sim, char *buffer, size_t size) {
+    int ptr_offset = 0;
+
+    for (int prev = 0; prev <= JRO; prev++) {
+        for (int next = 0; next <= JRO; next++) {
+            uint32_t count = sim->profile[prev][next];
+            if (count == 0 || (size_t)ptr_offset >= size) {
+                continue;
+            }
+            ptr_offset += snprintf(&buffer[ptr_offset], size - ptr_offset, "%s %s: %lu\n",
+                                   profile_str[prev], profile_str[next], (unsigned long)count);
+        }
+    }
+    return ptr_offset;
+}
+#endif
+
+// Runs the doubling program from hello_ucosii.c between two stack nodes
+// and returns the cycle at which each output value arrived
+static int tis_sim_test_doubler(uint8_t fusion, uint32_t arrival[3], int16_t output[3]) {
+    struct tis_sim sim;
+    struct tis_sim_node nodes[3];
+    const uint16_t program[] = {
+        0xC802, // MOV UP, ACC
+        0x0801, // ADD ACC
+        0xD801, // MOV ACC, DOWN
+    };
+
+    tis_sim_init(&sim, nodes, 3, 1);
+    sim.fusion = fusion;
+    tis_sim_stack(&sim, 0, 0, TIS_SIM_STACK_WRITE);
+    tis_sim_load(&sim, 1, 0, program, 3);
+    tis_sim_stack(&sim, 2, 0, TIS_SIM_STACK_READ);
+
+    for (int i = 0; i < 3; i++) {
+        tis_sim_push(&sim, 0, 0, i + 1);
+    }
+
+    int received = 0;
+    while (received < 3 && sim.cycle < 100) {
+        tis_sim_step(&sim);
+        if (tis_sim_pop(&sim, 2, 0, &output[received]) == 0) {
+            arrival[received++] = sim.cycle;
+        }
+    }
+    return received;
+}
+
+// Sends values through a corridor of MOV UP, DOWN nodes
+static int tis_sim_test_corridor(uint8_t collapse, uint32_t arrival[3], int16_t output[3]) {
+    struct tis_sim sim;
+    struct tis_sim_node nodes[6];
+    const uint16_t wire = 0xD802; // MOV UP, DOWN
+
+    tis_sim_init(&sim, nodes, 6, 1);
+    tis_sim_stack(&sim, 0, 0, TIS_SIM_STACK_WRITE);
+    for (int row = 1; row < 5; row++) {
+        tis_sim_load(&sim, row, 0, &wire, 1);
+    }
+    tis_sim_stack(&sim, 5, 0, TIS_SIM_STACK_READ);
+
+    if (collapse && tis_sim_collapse(&sim) != 1) {
+        return 0;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        tis_sim_push(&sim, 0, 0, i + 1);
+    }
+
+    int received = 0;
+    while (received < 3 && sim.cycle < 100) {
+        tis_sim_step(&sim);
+        if (tis_sim_pop(&sim, 5, 0, &output[received]) == 0) {
+            arrival[received++] = sim.cycle;
+        }
+    }
+    return received;
+}
+
+// Sends values through a MOV LEFT, DOWN node, which writes during the cycle
+// of its read
+static int tis_sim_test_turn(uint32_t arrival[3], int16_t output[3]) {
+    struct tis_sim sim;
+    struct tis_sim_node nodes[4];
+    const uint16_t turn = 0xD804; // MOV LEFT, DOWN
+
+    tis_sim_init(&sim, nodes, 2, 2);
+    tis_sim_stack(&sim, 0, 0, TIS_SIM_STACK_WRITE);
+    tis_sim_load(&sim, 0, 1, &turn, 1);
+    tis_sim_stack(&sim, 1, 1, TIS_SIM_STACK_READ);
+
+    // Not a wire with the delay of one
+    if (tis_sim_collapse(&sim) != 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        tis_sim_push(&sim, 0, 0, i + 1);
+    }
+
+    int received = 0;
+    while (received < 3 && sim.cycle < 100) {
+        tis_sim_step(&sim);
+        if (tis_sim_pop(&sim, 1, 1, &output[received]) == 0) {
+            arrival[received++] = sim.cycle;
+        }
+    }
+    return received;
+}
+
+// Sends values from a stack input to stack outputs on the left and right,
+// either with a broadcast or with one MOV per output
+static int tis_sim_test_fanout(uint8_t broadcast, uint32_t *cycles, int16_t output[2][3]) {
+    struct tis_sim sim;
+    struct tis_sim_node nodes[6];
+    const uint16_t broadcast_program[] = {
+        0xC802, // MOV UP, ACC
+        0xF461, // MOV ACC, LEFT+RIGHT
+    };
+    const uint16_t unicast_program[] = {
+        0xC802, // MOV UP, ACC
+        0xE001, // MOV ACC, LEFT
+        0xE801, // MOV ACC, RIGHT
+    };
+
+    tis_sim_init(&sim, nodes, 2, 3);
+    tis_sim_stack(&sim, 0, 1, TIS_SIM_STACK_WRITE);
+    if (broadcast) {
+        tis_sim_load(&sim, 1, 1, broadcast_program, 2);
+    } else {
+        tis_sim_load(&sim, 1, 1, unicast_program, 3);
+    }
+    tis_sim_stack(&sim, 1, 0, TIS_SIM_STACK_READ);
+    tis_sim_stack(&sim, 1, 2, TIS_SIM_STACK_READ);
+
+    for (int i = 0; i < 3; i++) {
+        tis_sim_push(&sim, 0, 1, i + 1);
+    }
+
+    int received[2] = {0};
+    while ((received[0] < 3 || received[1] < 3) && sim.cycle < 100) {
+        tis_sim_step(&sim);
+        for (int side = 0; side < 2; side++) {
+            if (received[side] < 3 && tis_sim_pop(&sim, 1, side * 2, &output[side][received[side]]) == 0) {
+                received[side]++;
+            }
+        }
+    }
+    *cycles = sim.cycle;
+    return received[0] + received[1];
+}
+
+void tis_sim_test() {
+    puts("Starting simulator test");
+
+    int failures = 0;
+
+    // MOV UP, ACC takes 1 cycle, ADD ACC 1, MOV ACC, DOWN 2
+    const uint32_t expected_arrival[3] = {4, 8, 12};
+    const int16_t expected_output[3] = {2, 4, 6};
+
+    for (uint8_t fusion = 0; fusion < 2; fusion++) {
+        uint32_t arrival[3] = {0};
+        int16_t output[3] = {0};
+
+        if (tis_sim_test_doubler(fusion, arrival, output) != 3) {
+            printf("Missing output (fusion %d)\n", fusion);
+            failures++;
+            continue;
+        }
+
+        for (int i = 0; i < 3; i++) {
+            if (output[i] != expected_output[i] || arrival[i] != expected_arrival[i]) {
+                printf("Failed at %d (fusion %d)\nExpected: %d at %lu\nResult: %d at %lu\n", i, fusion,
+                       expected_output[i], (unsigned long)expected_arrival[i], output[i],
+                       (unsigned long)arrival[i]);
+                failures++;
+            }
+        }
+    }
+
+    // Each wire node adds a cycle of latency and passes a value every other cycle
+    const uint32_t expected_corridor[3] = {5, 7, 9};
+
+    for (uint8_t collapse = 0; collapse < 2; collapse++) {
+        uint32_t arrival[3] = {0};
+        int16_t output[3] = {0};
+
+        if (tis_sim_test_corridor(collapse, arrival, output) != 3) {
+            printf("Missing output (collapse %d)\n", collapse);
+            failures++;
+            continue;
+        }
+
+        for (int i = 0; i < 3; i++) {
+            if (output[i] != i + 1 || arrival[i] != expected_corridor[i]) {
+                printf("Failed at %d (collapse %d)\nExpected: %d at %lu\nResult: %d at %lu\n", i, collapse,
+                       i + 1, (unsigned long)expected_corridor[i], output[i], (unsigned long)arrival[i]);
+                failures++;
+            }
+        }
+    }
+
+    // A turn from LEFT to DOWN passes a value every cycle
+    const uint32_t expected_turn[3] = {1, 2, 3};
+    uint32_t turn_arrival[3] = {0};
+    int16_t turn_output[3] = {0};
+
+    if (tis_sim_test_turn(turn_arrival, turn_output) != 3) {
+        puts("Missing output (turn)");
+        failures++;
+    } else {
+        for (int i = 0; i < 3; i++) {
+            if (turn_output[i] != i + 1 || turn_arrival[i] != expected_turn[i]) {
+                printf("Failed at %d (turn)\nExpected: %d at %lu\nResult: %d at %lu\n", i, i + 1,
+                       (unsigned long)expected_turn[i], turn_output[i], (unsigned long)turn_arrival[i]);
+                failures++;
+            }
+        }
+    }
+
+    // Broadcast writes both outputs in the cycle a single MOV would take
+    uint32_t fanout_cycles[2] = {0};
+    for (uint8_t broadcast = 0; broadcast < 2; broadcast++) {
+        int16_t output[2][3] = {{0}};
+
+        if (tis_sim_test_fanout(broadcast, &fanout_cycles[broadcast], output) != 6) {
+            printf("Missing output (broadcast %d)\n", broadcast);
+            failures++;
+            continue;
+        }
+
+        for (int i = 0; i < 3; i++) {
+            if (output[0][i] != i + 1 || output[1][i] != i + 1) {
+                printf("Failed at %d (broadcast %d)\nExpected: %d\nResult: %d, %d\n", i, broadcast, i + 1,
+                       output[0][i], output[1][i]);
+                failures++;
+            }
+        }
+    }
+    if (fanout_cycles[1] >= fanout_cycles[0]) {
+        printf("Failed broadcast\nExpected: under %lu cycles\nResult: %lu cycles\n",
+               (unsigned long)fanout_cycles[0], (unsigned long)fanout_cycles[1]);
+        failures++;
+    }
+
+    // Doubling saturates, so it's replayed. Negating stays affine.
+    struct tis_sim sim;
+    struct tis_sim_node node;
+    struct tis_sim_summary summary;
+    const uint16_t doubler[] = {0xC802, 0x0801, 0xD801}; // MOV UP, ACC / ADD ACC / MOV ACC, DOWN
+    const uint16_t negate[] = {0xC802, 0x4800, 0xD801};  // MOV UP, ACC / NEG / MOV ACC, DOWN
+
+    tis_sim_init(&sim, &node, 1, 1);
+    tis_sim_load(&sim, 0, 0, doubler, 3);
+    if (tis_sim_summarize_node(&node, &summary) != 0 || summary.affine || summary.cycles != 4 ||
+        summary.middle != 2 || tis_sim_summary_eval(&summary, 600) != 999 ||
+        tis_sim_summary_eval(&summary, -21) != -42) {
+        puts("Failed to summarize doubler");
+        failures++;
+    }
+
+    tis_sim_load(&sim, 0, 0, negate, 3);
+    if (tis_sim_summarize_node(&node, &summary) != 0 || !summary.affine || summary.scale != -1 ||
+        summary.offset != 0 || tis_sim_summary_eval(&summary, 999) != -999) {
+        puts("Failed to summarize negate");
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Simulator success! :)");
+    }
+}
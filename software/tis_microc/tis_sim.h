@@ -0,0 +1,199 @@
+/*
+ * tis_sim.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Host model of a grid of TIS nodes, used to check programs and measure
+ * cycle counts without a board. One call to tis_sim_step() is one TIS cycle,
+ * i.e. the six clocks of the RUN/LEFT/RIGHT/UP/DOWN/FINISH sequence in
+ * tis_execution_node.vhd.
+ */
+
+#ifndef TIS_SIM_H_
+#define TIS_SIM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tis_asm.h"
+
+#define TIS_SIM_MAX_INSTRUCTIONS TIS_MAX_INSTRUCTIONS
+#define TIS_SIM_STACK_LENGTH 15
+
+// Longest superinstruction, counting the leading instruction
+#define TIS_SIM_MAX_FUSED 3
+
+// Operand source that isn't a register
+#define TIS_SIM_IMM 8
+
+// Stack node config bits, same as node_config in tis_stack_node.vhd
+#define TIS_SIM_STACK_WRITE 0x1
+#define TIS_SIM_STACK_READ 0x2
+
+// Bit for a port in a mask of o_*_active signals
+#define TIS_SIM_PORT_BIT(port) (1 << ((port) - UP))
+
+typedef enum {
+    TIS_SIM_UNUSED,
+    TIS_SIM_EXECUTION,
+    TIS_SIM_STACK,
+    // Pass-through node collapsed into a channel by tis_sim_collapse()
+    TIS_SIM_WIRE,
+    // Stateless node evaluated through its summary, see tis_sim_summarize()
+    TIS_SIM_SUMMARY,
+} tis_sim_kind_t;
+
+typedef enum {
+    TIS_SIM_IO_NONE,
+    TIS_SIM_IO_READ,
+    TIS_SIM_IO_WRITE,
+} tis_sim_io_t;
+
+// Predecoded instruction
+struct tis_sim_op {
+    uint8_t opcode; // tis_opcode_t
+    uint8_t src;    // tis_reg_t or TIS_SIM_IMM
+    uint8_t dst;    // tis_reg_t
+    uint8_t fused;  // Number of following instructions executed along with this one
+    uint8_t fanout; // Ports of a broadcast MOV, TIS_SIM_PORT_BIT each
+    int16_t imm;    // Immediate operand or jump target
+};
+
+// Closed form of a node that reads one value, computes and writes one value
+// without carrying state from one item to the next
+struct tis_sim_summary {
+    uint8_t in_port;
+    uint8_t out_port;
+    // Idle cycles before the read, between read and write and after the write
+    uint8_t pre;
+    uint8_t middle;
+    uint8_t post;
+    // Cycles per item when never blocked
+    uint8_t cycles;
+    // Output is scale * input + offset when no intermediate value can saturate
+    uint8_t affine;
+    int16_t scale;
+    int16_t offset;
+    // Instructions of one item, replayed when the output isn't affine
+    uint8_t trace_length;
+    uint8_t read_index;
+    uint8_t write_index;
+    struct tis_sim_op trace[TIS_SIM_MAX_INSTRUCTIONS];
+};
+
+struct tis_sim_node {
+    tis_sim_kind_t kind;
+
+    // Execution node
+    uint8_t instruction_count;
+    uint16_t program[TIS_SIM_MAX_INSTRUCTIONS];
+    struct tis_sim_op ops[TIS_SIM_MAX_INSTRUCTIONS];
+    int16_t acc;
+    int16_t bak;
+    uint8_t pc;
+    tis_reg_t last;
+
+    // Pending port operation
+    tis_sim_io_t io;
+    tis_reg_t io_port;
+    int16_t io_value;
+    // Ports that still have to take a broadcast value
+    uint8_t fanout;
+    // Port operation offered during the current cycle, from the given phase
+    tis_sim_io_t offer;
+    uint8_t offer_phase;
+    // Set once the instruction at PC can complete this cycle
+    uint8_t done;
+    // Cycles left of an already executed superinstruction
+    uint8_t stall;
+    uint32_t retired;
+
+    // Stack node
+    uint16_t config;
+    int16_t values[TIS_SIM_STACK_LENGTH];
+    uint8_t head;
+    uint8_t count;
+
+    // Wire node, the first node of a chain holds the channel state and
+    // reuses values/head/count for the values in transit
+    int channel;
+    uint8_t channel_pos;
+    uint8_t channel_length;
+    uint8_t channel_in;
+    uint8_t channel_out;
+    uint16_t occupied; // Bit per wire node holding a value
+
+    // Summary node
+    struct tis_sim_summary summary;
+
+    // Next node that needs work each cycle, -1 ends the list
+    int next_active;
+
+    // Ports offered during each LEFT/RIGHT/UP/DOWN phase of the last cycle,
+    // only kept when recording ports
+    uint8_t port_offers[4];
+
+#ifdef TIS_SIM_PROFILE
+    uint8_t profile_prev;
+#endif
+};
+
+struct tis_sim {
+    int rows;
+    int cols;
+    struct tis_sim_node *nodes; // rows * cols, row major
+    uint32_t cycle;
+    // First node of the active list, rebuilt after the grid changes
+    int active;
+    uint8_t active_dirty;
+    // Fuse instruction sequences on load, disable to compare against the plain model
+    uint8_t fusion;
+    // Keep port_offers up to date for waveform export
+    uint8_t record_ports;
+#ifdef TIS_SIM_PROFILE
+    // Retired instruction pairs, [previous][next] opcode
+    uint32_t profile[JRO + 1][JRO + 1];
+#endif
+};
+
+void tis_sim_init(struct tis_sim *sim, struct tis_sim_node *nodes, int rows, int cols);
+struct tis_sim_node *tis_sim_node_at(struct tis_sim *sim, int row, int col);
+
+// Returns -1 when the program doesn't fit in a node
+int tis_sim_load(struct tis_sim *sim, int row, int col, const uint16_t instructions[], int instruction_count);
+// Predecodes the loaded programs again, call before running
+void tis_sim_set_fusion(struct tis_sim *sim, uint8_t fusion);
+void tis_sim_stack(struct tis_sim *sim, int row, int col, uint16_t config);
+
+// Memory mapped side of a stack node, returns -1 when full/empty
+int tis_sim_push(struct tis_sim *sim, int row, int col, int16_t value);
+int tis_sim_pop(struct tis_sim *sim, int row, int col, int16_t *value);
+
+// Replaces chains of MOV <port>, <port> nodes by delay-line channels with the
+// same latency and capacity. Call after loading the grid and before running.
+// Returns the number of channels created.
+int tis_sim_collapse(struct tis_sim *sim);
+
+// Proves a node stateless by executing one item symbolically.
+// Returns -1 when the output can depend on earlier items or control flow
+// depends on data.
+int tis_sim_summarize_node(const struct tis_sim_node *node, struct tis_sim_summary *summary);
+int16_t tis_sim_summary_eval(const struct tis_sim_summary *summary, int16_t input);
+
+// Switches every stateless node to evaluation through its summary.
+// Call after loading the grid and before running, returns the node count.
+int tis_sim_summarize(struct tis_sim *sim);
+
+void tis_sim_step(struct tis_sim *sim);
+void tis_sim_run(struct tis_sim *sim, uint32_t cycles);
+
+#ifdef TIS_SIM_PROFILE
+// Lists retired instruction pairs, used to pick fusion candidates
+int tis_sim_profile_report(struct tis_sim *sim, char *buffer, size_t size);
+#endif
+
+// Tests the model against known cycle counts
+void tis_sim_test();
+
+#endif /* TIS_SIM_H_ */
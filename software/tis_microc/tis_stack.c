@@ -0,0 +1,160 @@
+/*
+ * tis_stack.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "tis_stack.h"
+
+static volatile uint16_t* tis_stack_reg(void *stack, int reg) {
+    return (volatile uint16_t*)stack + reg;
+}
+
+uint16_t tis_stack_count(void *stack) {
+    return *tis_stack_reg(stack, TIS_STACK_COUNT);
+}
+
+uint16_t tis_stack_status(void *stack) {
+    return *tis_stack_reg(stack, TIS_STACK_STATUS);
+}
+
+uint16_t tis_stack_high_water(void *stack) {
+    return *tis_stack_reg(stack, TIS_STACK_HIGH_WATER);
+}
+
+void tis_stack_clear_high_water(void *stack) {
+    *tis_stack_reg(stack, TIS_STACK_STATUS) = 0;
+}
+
+int tis_stack_drain(void *stack, int16_t values[], int max) {
+    uint16_t available = tis_stack_count(stack);
+    int count = available < max ? available : max;
+    volatile uint16_t *window = tis_stack_reg(stack, TIS_STACK_WINDOW);
+
+    // Values only leave memory side through these reads, so count stays valid
+    for (int i = 0; i < count; i++) {
+        values[i] = (int16_t)window[i % TIS_STACK_WINDOW_LENGTH];
+    }
+    return count;
+}
+
+int tis_stack_fill(void *stack, const int16_t values[], int count, int length) {
+    int space = length - tis_stack_count(stack);
+    volatile uint16_t *window = tis_stack_reg(stack, TIS_STACK_WINDOW);
+
+    if (count > space) {
+        count = space > 0 ? space : 0;
+    }
+    for (int i = 0; i < count; i++) {
+        window[i % TIS_STACK_WINDOW_LENGTH] = (uint16_t)values[i];
+    }
+    return count;
+}
+
+static volatile uint32_t* tis_stack_dma_reg(void *dma, int reg) {
+    return (volatile uint32_t*)dma + reg;
+}
+
+void tis_stack_dma_start(void *dma, const volatile void *memory, uint32_t length, int32_t stride, int to_memory,
+                         int irq) {
+    *tis_stack_dma_reg(dma, TIS_STACK_DMA_ADDRESS) = (uint32_t)(uintptr_t)memory;
+    *tis_stack_dma_reg(dma, TIS_STACK_DMA_LENGTH) = length;
+    *tis_stack_dma_reg(dma, TIS_STACK_DMA_STRIDE) = (uint32_t)stride;
+    *tis_stack_dma_reg(dma, TIS_STACK_DMA_CONTROL) = TIS_STACK_DMA_START | (to_memory ? TIS_STACK_DMA_TO_MEMORY : 0) |
+                                                     (irq ? TIS_STACK_DMA_IRQ : 0);
+}
+
+void tis_stack_dma_stop(void *dma) {
+    *tis_stack_dma_reg(dma, TIS_STACK_DMA_CONTROL) = TIS_STACK_DMA_STOP;
+}
+
+int tis_stack_dma_busy(void *dma) {
+    return *tis_stack_dma_reg(dma, TIS_STACK_DMA_CONTROL) & TIS_STACK_DMA_BUSY;
+}
+
+uint32_t tis_stack_dma_left(void *dma) {
+    return *tis_stack_dma_reg(dma, TIS_STACK_DMA_LENGTH);
+}
+
+void tis_stack_test() {
+    puts("Starting stack test");
+
+    int failures = 0;
+    static uint16_t regs[TIS_STACK_WINDOW + TIS_STACK_WINDOW_LENGTH];
+    int16_t values[12] = {0};
+    const int16_t input[12] = {1, -2, 3, -4, 5, -6, 7, -8, 9, -10, 11, -12};
+
+    // Three values buffered, a drain of two leaves the count alone
+    regs[TIS_STACK_COUNT] = 3;
+    regs[TIS_STACK_WINDOW] = (uint16_t)-7;
+    regs[TIS_STACK_WINDOW + 1] = 8;
+    int read = tis_stack_drain(regs, values, 2);
+    if (read != 2 || values[0] != -7 || values[1] != 8) {
+        printf("Failed drain\nExpected: 2 values -7 8\nResult: %d values %d %d\n", read, values[0], values[1]);
+        failures++;
+    }
+
+    // Only the values the count reports are read
+    read = tis_stack_drain(regs, values, 12);
+    if (read != 3) {
+        printf("Failed drain\nExpected: 3 values\nResult: %d values\n", read);
+        failures++;
+    }
+
+    // Five of twelve values fit, the burst wraps around the window
+    regs[TIS_STACK_COUNT] = 10;
+    int written = tis_stack_fill(regs, input, 12, 15);
+    if (written != 5 || (int16_t)regs[TIS_STACK_WINDOW + 4] != 5) {
+        printf("Failed fill\nExpected: 5 values\nResult: %d values\n", written);
+        failures++;
+    }
+
+    written = tis_stack_fill(regs, input, 12, 8);
+    if (written != 0) {
+        printf("Failed fill of a full stack\nExpected: 0 values\nResult: %d values\n", written);
+        failures++;
+    }
+
+    regs[TIS_STACK_COUNT] = 0;
+    written = tis_stack_fill(regs, input, 12, 15);
+    if (written != 12 || (int16_t)regs[TIS_STACK_WINDOW] != 9 || (int16_t)regs[TIS_STACK_WINDOW + 3] != -12) {
+        printf("Failed fill\nExpected: 12 values ending in 9 ... -12\nResult: %d values\n", written);
+        failures++;
+    }
+
+    regs[TIS_STACK_STATUS] = TIS_STACK_FULL;
+    tis_stack_clear_high_water(regs);
+    if (regs[TIS_STACK_STATUS] != 0) {
+        puts("Failed to clear the high-water mark");
+        failures++;
+    }
+
+    static uint32_t dma[TIS_STACK_DMA_NODE];
+    static int16_t memory[4];
+    tis_stack_dma_start(dma, memory, 4, sizeof(int16_t), 1, 1);
+    if (dma[TIS_STACK_DMA_ADDRESS] != (uint32_t)(uintptr_t)memory || dma[TIS_STACK_DMA_LENGTH] != 4 ||
+        dma[TIS_STACK_DMA_STRIDE] != 2 || dma[TIS_STACK_DMA_CONTROL] != 0x7) {
+        printf("Failed DMA start\nExpected: length 4 stride 2 control 0x7\nResult: length %lu stride %lu control 0x%lx\n",
+               (unsigned long)dma[TIS_STACK_DMA_LENGTH], (unsigned long)dma[TIS_STACK_DMA_STRIDE],
+               (unsigned long)dma[TIS_STACK_DMA_CONTROL]);
+        failures++;
+    }
+
+    // Negative strides walk down through memory
+    tis_stack_dma_start(dma, &memory[3], 4, -(int32_t)sizeof(int16_t), 0, 0);
+    if ((int32_t)dma[TIS_STACK_DMA_STRIDE] != -2 || dma[TIS_STACK_DMA_CONTROL] != TIS_STACK_DMA_START ||
+        !tis_stack_dma_busy(dma)) {
+        puts("Failed DMA start with a negative stride");
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Stack success! :)");
+    }
+}
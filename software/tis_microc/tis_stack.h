@@ -0,0 +1,78 @@
+/*
+ * tis_stack.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Memory mapped side of a tis_stack_node, either its own slave or a stack
+ * node in tis_grid (see tis_grid_node). The count and status registers let
+ * software move every buffered value in one burst instead of polling the
+ * data register until it reads as empty. tis_stack_dma goes further and
+ * streams values between memory and the grid without the CPU.
+ */
+
+#ifndef TIS_STACK_H_
+#define TIS_STACK_H_
+
+#include <stdint.h>
+
+// Halfword offsets of the registers, see tis_stack_node.vhd
+#define TIS_STACK_CONFIG 0
+#define TIS_STACK_DATA 1
+#define TIS_STACK_COUNT 2
+#define TIS_STACK_STATUS 3
+#define TIS_STACK_HIGH_WATER 4
+#define TIS_STACK_WINDOW 8
+#define TIS_STACK_WINDOW_LENGTH 8
+
+// Status bits
+#define TIS_STACK_EMPTY 0x1
+#define TIS_STACK_FULL 0x2
+
+// Word offsets of the tis_stack_dma registers, the stack node registers
+// follow in the lower halfword of every word from TIS_STACK_DMA_NODE
+#define TIS_STACK_DMA_CONTROL 0
+#define TIS_STACK_DMA_ADDRESS 1
+#define TIS_STACK_DMA_LENGTH 2
+#define TIS_STACK_DMA_STRIDE 3
+#define TIS_STACK_DMA_NODE 8
+
+// Control bits
+#define TIS_STACK_DMA_START 0x01
+#define TIS_STACK_DMA_TO_MEMORY 0x02
+#define TIS_STACK_DMA_IRQ 0x04
+#define TIS_STACK_DMA_STOP 0x08
+#define TIS_STACK_DMA_BUSY 0x01
+#define TIS_STACK_DMA_DONE 0x10
+
+uint16_t tis_stack_count(void *stack);
+uint16_t tis_stack_status(void *stack);
+
+// Most values held since reset or the last clear
+uint16_t tis_stack_high_water(void *stack);
+void tis_stack_clear_high_water(void *stack);
+
+// Reads up to max values in one burst, returns the number read. Memory
+// reads pop the value written last through memory, other values leave in
+// the order the grid wrote them.
+int tis_stack_drain(void *stack, int16_t values[], int max);
+
+// Writes up to count values in one burst while they fit in a stack of
+// length values, returns the number written
+int tis_stack_fill(void *stack, const int16_t values[], int count, int length);
+
+// Streams length halfwords between memory and a tis_stack_dma, the next
+// value follows stride bytes further. to_memory moves the values the grid
+// writes into the stack to memory instead of feeding memory to the grid.
+void tis_stack_dma_start(void *dma, const volatile void *memory, uint32_t length, int32_t stride, int to_memory,
+                         int irq);
+void tis_stack_dma_stop(void *dma);
+int tis_stack_dma_busy(void *dma);
+
+// Values the running transfer has left
+uint32_t tis_stack_dma_left(void *dma);
+
+// Tests the burst helpers against made up registers
+void tis_stack_test();
+
+#endif /* TIS_STACK_H_ */
@@ -0,0 +1,46 @@
+/*
+ * tis_tests.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Runs the tests of the host simulator and of the drivers on the build
+ * machine, see Makefile.host. The drivers only touch the memory they are
+ * given, so their tests run against plain arrays instead of the grid.
+ */
+
+#include "tis_asm.h"
+#include "tis_batch.h"
+#include "tis_control.h"
+#include "tis_dispatch.h"
+#include "tis_host.h"
+#include "tis_node.h"
+#include "tis_perf.h"
+#include "tis_sched.h"
+#include "tis_sim.h"
+#include "tis_stack.h"
+#include "tis_trace.h"
+#include "tis_vcd.h"
+
+int main() {
+    // Drivers, also part of the firmware
+    tis_disassembler_test();
+    tis_assembler_test();
+    tis_node_status_test();
+#if TIS_HOT_SWAP
+    tis_node_swap_test();
+    tis_sched_test();
+#endif
+    tis_perf_test();
+    tis_stack_test();
+    tis_control_test();
+    tis_host_test();
+    tis_trace_test();
+
+    // Host only
+    tis_sim_test();
+    tis_vcd_test();
+    tis_batch_test();
+    tis_dispatch_test();
+    return 0;
+}
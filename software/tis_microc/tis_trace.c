@@ -0,0 +1,124 @@
+/*
+ * tis_trace.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tis_trace.h"
+
+static const char trace_ports[] = {'U', 'D', 'L', 'R'};
+
+static volatile uint32_t* tis_trace_reg(void *base, int reg) {
+    return (volatile uint32_t*)base + reg;
+}
+
+// Values are 11 bit two's complement
+static int16_t tis_trace_value(uint32_t bits) {
+    bits &= 0x7FF;
+    return (int16_t)(bits & 0x400 ? (int32_t)bits - 0x800 : (int32_t)bits);
+}
+
+void tis_trace_start(void *base, uint32_t node_mask, enum tis_trace_trigger trigger, int trigger_node,
+                     int32_t trigger_value, int wrap) {
+    *tis_trace_reg(base, TIS_TRACE_CONTROL) = TIS_TRACE_CLEAR;
+    *tis_trace_reg(base, TIS_TRACE_SELECT) = node_mask;
+    *tis_trace_reg(base, TIS_TRACE_TRIGGER_NODE) = (uint32_t)trigger_node;
+    *tis_trace_reg(base, TIS_TRACE_TRIGGER_VALUE) = (uint32_t)trigger_value;
+    *tis_trace_reg(base, TIS_TRACE_CONTROL) = TIS_TRACE_ENABLE | (wrap ? TIS_TRACE_WRAP : 0) |
+                                              ((uint32_t)trigger << TIS_TRACE_TRIGGER_SHIFT);
+}
+
+void tis_trace_stop(void *base) {
+    *tis_trace_reg(base, TIS_TRACE_CONTROL) &= ~(uint32_t)TIS_TRACE_ENABLE;
+}
+
+uint32_t tis_trace_status(void *base) {
+    return *tis_trace_reg(base, TIS_TRACE_CONTROL);
+}
+
+int tis_trace_drain(void *base, struct tis_trace_entry entries[], int max) {
+    uint32_t available = *tis_trace_reg(base, TIS_TRACE_COUNT);
+    int count = available < (uint32_t)max ? (int)available : max;
+    volatile uint32_t *data = tis_trace_reg(base, TIS_TRACE_DATA);
+
+    // Entries only leave the buffer through these reads, so count stays valid
+    for (int i = 0; i < count; i++) {
+        uint32_t low = *data;
+        uint32_t high = *data;
+        tis_trace_decode(low, high, &entries[i]);
+    }
+    return count;
+}
+
+void tis_trace_decode(uint32_t low, uint32_t high, struct tis_trace_entry *entry) {
+    entry->acc = tis_trace_value(low);
+    entry->bak = tis_trace_value(low >> 11);
+    entry->pc = (low >> 22) & 0x7F;
+    entry->transfers = high & 0xF;
+    entry->node = (high >> 8) & 0x1F;
+    entry->cycle = high >> 16;
+}
+
+int tis_trace_print(const struct tis_trace_entry entries[], int count, char *buffer, size_t size) {
+    int ptr_offset = 0;
+
+    for (int i = 0; i < count && (size_t)ptr_offset < size; i++) {
+        const struct tis_trace_entry *entry = &entries[i];
+        char ports[5];
+
+        for (int p = 0; p < 4; p++) {
+            ports[p] = entry->transfers & (1 << p) ? trace_ports[p] : '-';
+        }
+        ports[4] = '\0';
+
+        ptr_offset += snprintf(&buffer[ptr_offset], size - ptr_offset, "%5u node %2u PC %2u ACC %4d BAK %4d %s\n",
+                               entry->cycle, entry->node, entry->pc, entry->acc, entry->bak, ports);
+    }
+    return ptr_offset;
+}
+
+void tis_trace_test() {
+    puts("Starting trace test");
+
+    int failures = 0;
+    char buffer[128];
+    struct tis_trace_entry entries[2];
+
+    // ACC 42, BAK -7, PC 2 on node 1 in cycle 5, transfer on DOWN
+    uint32_t low = 42 | ((uint32_t)(0x800 - 7) << 11) | (2u << 22);
+    uint32_t high = 0x2 | (1u << 8) | (5u << 16);
+    tis_trace_decode(low, high, &entries[0]);
+
+    if (entries[0].acc != 42 || entries[0].bak != -7 || entries[0].pc != 2 || entries[0].node != 1 ||
+        entries[0].cycle != 5 || entries[0].transfers != 0x2) {
+        printf("Failed decode\nExpected: 42 -7 2 1 5 2\nResult: %d %d %u %u %u %u\n", entries[0].acc,
+               entries[0].bak, entries[0].pc, entries[0].node, entries[0].cycle, entries[0].transfers);
+        failures++;
+    }
+
+    // Extremes of the value range
+    tis_trace_decode(999 | ((uint32_t)(0x800 - 999) << 11), 0, &entries[1]);
+    if (entries[1].acc != 999 || entries[1].bak != -999) {
+        printf("Failed decode\nExpected: 999 -999\nResult: %d %d\n", entries[1].acc, entries[1].bak);
+        failures++;
+    }
+
+    const char *expected = "    5 node  1 PC  2 ACC   42 BAK   -7 -D--\n"
+                           "    0 node  0 PC  0 ACC  999 BAK -999 ----\n";
+    int length = tis_trace_print(entries, 2, buffer, sizeof(buffer));
+    if (length != (int)strlen(expected) || strcmp(buffer, expected) != 0) {
+        printf("Failed print\nExpected:\n%sResult:\n%s", expected, buffer);
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("Trace success! :)");
+    }
+}
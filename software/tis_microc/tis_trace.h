@@ -0,0 +1,73 @@
+/*
+ * tis_trace.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Drives a tis_trace slave, which records the PC, ACC and BAK of selected
+ * grid nodes at the end of every TIS cycle. Recording starts on a trigger
+ * and the buffer is drained oldest entry first while the grid keeps running.
+ */
+
+#ifndef TIS_TRACE_H_
+#define TIS_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Word offsets of the registers, see tis_trace.vhd
+#define TIS_TRACE_CONTROL 0
+#define TIS_TRACE_SELECT 1
+#define TIS_TRACE_TRIGGER_NODE 2
+#define TIS_TRACE_TRIGGER_VALUE 3
+#define TIS_TRACE_CYCLE 4
+#define TIS_TRACE_COUNT 5
+#define TIS_TRACE_DATA 6
+
+// Control bits
+#define TIS_TRACE_ENABLE 0x01
+#define TIS_TRACE_WRAP 0x02
+#define TIS_TRACE_CLEAR 0x10
+#define TIS_TRACE_TRIGGERED 0x20
+#define TIS_TRACE_OVERFLOW 0x40
+
+#define TIS_TRACE_TRIGGER_SHIFT 2
+
+// Cycle that starts the recording
+enum tis_trace_trigger {
+    TIS_TRACE_NOW = 0,
+    TIS_TRACE_PC = 1,    // PC of the trigger node equals the value
+    TIS_TRACE_ACC = 2,   // ACC of the trigger node equals the value
+    TIS_TRACE_CYCLES = 3 // Cycle count reached the value
+};
+
+struct tis_trace_entry {
+    uint16_t cycle; // Lower bits of the cycle count
+    uint8_t node;   // Row major index in the grid
+    uint8_t pc;
+    int16_t acc;
+    int16_t bak;
+    uint8_t transfers; // Bit 0 for UP up to bit 3 for RIGHT
+};
+
+// Clears the buffer and starts recording the nodes in node_mask
+void tis_trace_start(void *base, uint32_t node_mask, enum tis_trace_trigger trigger, int trigger_node,
+                     int32_t trigger_value, int wrap);
+void tis_trace_stop(void *base);
+
+// Control register with the triggered and overflow flags
+uint32_t tis_trace_status(void *base);
+
+// Reads up to max entries in one burst, returns the number read
+int tis_trace_drain(void *base, struct tis_trace_entry entries[], int max);
+
+// Unpacks the two words of an entry
+void tis_trace_decode(uint32_t low, uint32_t high, struct tis_trace_entry *entry);
+
+// Prints one line per entry, returns the length of the text
+int tis_trace_print(const struct tis_trace_entry entries[], int count, char *buffer, size_t size);
+
+// Tests decoding and printing of made up entries
+void tis_trace_test();
+
+#endif /* TIS_TRACE_H_ */
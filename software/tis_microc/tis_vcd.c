@@ -0,0 +1,359 @@
+/*
+ * tis_vcd.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tis_vcd.h"
+
+// Signals per node, identifier 0 is the shared tis_state
+#define TIS_VCD_NODE_SIGNALS 12
+
+enum {
+    TIS_VCD_ID_PC,
+    TIS_VCD_ID_ACC,
+    TIS_VCD_ID_BAK,
+    TIS_VCD_ID_IO,
+    TIS_VCD_ID_O_ACTIVE, // LEFT, RIGHT, UP, DOWN
+    TIS_VCD_ID_I_ACTIVE = TIS_VCD_ID_O_ACTIVE + 4,
+};
+
+// Port of each o_*_active/i_*_active signal, in declaration order
+static const tis_reg_t vcd_ports[4] = {LEFT, RIGHT, UP, DOWN};
+static const char *vcd_port_names[4] = {"left", "right", "up", "down"};
+
+static void tis_vcd_flush(struct tis_vcd *vcd) {
+    fwrite(vcd->buffer, 1, vcd->used, vcd->file);
+    vcd->used = 0;
+}
+
+// Makes room for a line, value changes and declarations stay below this
+#define TIS_VCD_LINE_SIZE 64
+
+static char *tis_vcd_reserve(struct tis_vcd *vcd) {
+    if (vcd->used + TIS_VCD_LINE_SIZE > sizeof(vcd->buffer)) {
+        tis_vcd_flush(vcd);
+    }
+    return &vcd->buffer[vcd->used];
+}
+
+// Identifier characters as printable ASCII from '!' to '~'
+static int tis_vcd_id(char *out, uint32_t id) {
+    int length = 0;
+    do {
+        out[length++] = '!' + id % 94;
+        id /= 94;
+    } while (id);
+    return length;
+}
+
+static uint32_t tis_vcd_node_id(int node, int signal) {
+    return 1 + node * TIS_VCD_NODE_SIGNALS + signal;
+}
+
+static void tis_vcd_time(struct tis_vcd *vcd, uint32_t time) {
+    if (vcd->time_written && vcd->time == time) {
+        return;
+    }
+    char *out = tis_vcd_reserve(vcd);
+    vcd->used += sprintf(out, "#%lu\n", (unsigned long)time);
+    vcd->time = time;
+    vcd->time_written = 1;
+}
+
+static void tis_vcd_bit(struct tis_vcd *vcd, uint32_t time, int value, uint32_t id) {
+    tis_vcd_time(vcd, time);
+    char *out = tis_vcd_reserve(vcd);
+    int length = 0;
+    out[length++] = value ? '1' : '0';
+    length += tis_vcd_id(&out[length], id);
+    out[length++] = '\n';
+    vcd->used += length;
+}
+
+static void tis_vcd_vector(struct tis_vcd *vcd, uint32_t time, int value, int width, uint32_t id) {
+    tis_vcd_time(vcd, time);
+    char *out = tis_vcd_reserve(vcd);
+    int length = 0;
+    out[length++] = 'b';
+    for (int bit = width - 1; bit >= 0; bit--) {
+        out[length++] = ((value >> bit) & 1) ? '1' : '0';
+    }
+    out[length++] = ' ';
+    length += tis_vcd_id(&out[length], id);
+    out[length++] = '\n';
+    vcd->used += length;
+}
+
+static void tis_vcd_var(struct tis_vcd *vcd, int width, uint32_t id, const char *name) {
+    char id_str[8] = {0};
+    tis_vcd_id(id_str, id);
+    tis_vcd_reserve(vcd);
+    vcd->used += sprintf(&vcd->buffer[vcd->used], "$var wire %d %s %s $end\n", width, id_str, name);
+}
+
+void tis_vcd_init(struct tis_vcd *vcd, struct tis_sim *sim, struct tis_vcd_node nodes[], FILE *file) {
+    memset(vcd, 0, sizeof(*vcd));
+    vcd->sim = sim;
+    vcd->nodes = nodes;
+    vcd->file = file;
+    vcd->signals = TIS_VCD_ALL;
+    vcd->start = 0;
+    vcd->end = UINT32_MAX;
+
+    int node_count = sim->rows * sim->cols;
+    for (int i = 0; i < node_count; i++) {
+        memset(&nodes[i], 0, sizeof(nodes[i]));
+        nodes[i].selected = sim->nodes[i].kind != TIS_SIM_UNUSED;
+    }
+
+    // Fused instructions all change registers in one cycle, unlike the hardware
+    tis_sim_set_fusion(sim, 0);
+    sim->record_ports = 1;
+}
+
+static int tis_vcd_has_registers(const struct tis_sim_node *node) {
+    return node->kind == TIS_SIM_EXECUTION || node->kind == TIS_SIM_SUMMARY;
+}
+
+// i_*_active of a node is the facing o_*_active of its neighbour
+static uint8_t tis_vcd_inputs(struct tis_sim *sim, int index, int phase) {
+    int row = index / sim->cols;
+    int col = index % sim->cols;
+    const int offsets[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+    const tis_reg_t facing[4] = {RIGHT, LEFT, DOWN, UP};
+    uint8_t inputs = 0;
+
+    for (int p = 0; p < 4; p++) {
+        struct tis_sim_node *neighbour = tis_sim_node_at(sim, row + offsets[p][0], col + offsets[p][1]);
+        if (neighbour != NULL && (neighbour->port_offers[phase] & TIS_SIM_PORT_BIT(facing[p]))) {
+            inputs |= TIS_SIM_PORT_BIT(vcd_ports[p]);
+        }
+    }
+    return inputs;
+}
+
+static void tis_vcd_registers(struct tis_vcd *vcd, uint32_t time, int index, int force) {
+    struct tis_sim_node *node = &vcd->sim->nodes[index];
+    struct tis_vcd_node *last = &vcd->nodes[index];
+
+    if ((vcd->signals & TIS_VCD_PC) && (force || last->pc != node->pc)) {
+        tis_vcd_vector(vcd, time, node->pc, TIS_PC_WIDTH, tis_vcd_node_id(index, TIS_VCD_ID_PC));
+        last->pc = node->pc;
+    }
+    if ((vcd->signals & TIS_VCD_ACC) && (force || last->acc != node->acc)) {
+        tis_vcd_vector(vcd, time, node->acc, 11, tis_vcd_node_id(index, TIS_VCD_ID_ACC));
+        last->acc = node->acc;
+    }
+    if ((vcd->signals & TIS_VCD_BAK) && (force || last->bak != node->bak)) {
+        tis_vcd_vector(vcd, time, node->bak, 11, tis_vcd_node_id(index, TIS_VCD_ID_BAK));
+        last->bak = node->bak;
+    }
+    if ((vcd->signals & TIS_VCD_STATE) && (force || last->io != node->io)) {
+        tis_vcd_vector(vcd, time, node->io, 2, tis_vcd_node_id(index, TIS_VCD_ID_IO));
+        last->io = node->io;
+    }
+}
+
+static void tis_vcd_ports(struct tis_vcd *vcd, uint32_t time, int index, uint8_t o_active, uint8_t i_active,
+                          int force) {
+    struct tis_vcd_node *last = &vcd->nodes[index];
+
+    for (int p = 0; p < 4; p++) {
+        uint8_t bit = TIS_SIM_PORT_BIT(vcd_ports[p]);
+        if (force || ((last->o_active ^ o_active) & bit)) {
+            tis_vcd_bit(vcd, time, o_active & bit, tis_vcd_node_id(index, TIS_VCD_ID_O_ACTIVE + p));
+        }
+        if (force || ((last->i_active ^ i_active) & bit)) {
+            tis_vcd_bit(vcd, time, i_active & bit, tis_vcd_node_id(index, TIS_VCD_ID_I_ACTIVE + p));
+        }
+    }
+    last->o_active = o_active;
+    last->i_active = i_active;
+}
+
+void tis_vcd_begin(struct tis_vcd *vcd) {
+    struct tis_sim *sim = vcd->sim;
+    int node_count = sim->rows * sim->cols;
+    char name[32];
+
+    vcd->used += sprintf(vcd->buffer, "$timescale 1ns $end\n$scope module tis $end\n");
+    if (vcd->signals & TIS_VCD_STATE) {
+        tis_vcd_var(vcd, 3, 0, "tis_state");
+    }
+
+    for (int i = 0; i < node_count; i++) {
+        const struct tis_sim_node *node = &sim->nodes[i];
+        if (!vcd->nodes[i].selected) {
+            continue;
+        }
+
+        tis_vcd_reserve(vcd);
+        vcd->used += sprintf(&vcd->buffer[vcd->used], "$scope module node_%d_%d $end\n", i / sim->cols,
+                             i % sim->cols);
+        if (tis_vcd_has_registers(node)) {
+            if (vcd->signals & TIS_VCD_PC) {
+                tis_vcd_var(vcd, TIS_PC_WIDTH, tis_vcd_node_id(i, TIS_VCD_ID_PC), "debug_pc");
+            }
+            if (vcd->signals & TIS_VCD_ACC) {
+                tis_vcd_var(vcd, 11, tis_vcd_node_id(i, TIS_VCD_ID_ACC), "debug_acc");
+            }
+            if (vcd->signals & TIS_VCD_BAK) {
+                tis_vcd_var(vcd, 11, tis_vcd_node_id(i, TIS_VCD_ID_BAK), "debug_bak");
+            }
+            if (vcd->signals & TIS_VCD_STATE) {
+                tis_vcd_var(vcd, 2, tis_vcd_node_id(i, TIS_VCD_ID_IO), "node_io");
+            }
+        }
+        if (vcd->signals & TIS_VCD_PORTS) {
+            for (int p = 0; p < 4; p++) {
+                sprintf(name, "o_%s_active", vcd_port_names[p]);
+                tis_vcd_var(vcd, 1, tis_vcd_node_id(i, TIS_VCD_ID_O_ACTIVE + p), name);
+                sprintf(name, "i_%s_active", vcd_port_names[p]);
+                tis_vcd_var(vcd, 1, tis_vcd_node_id(i, TIS_VCD_ID_I_ACTIVE + p), name);
+            }
+        }
+        tis_vcd_reserve(vcd);
+        vcd->used += sprintf(&vcd->buffer[vcd->used], "$upscope $end\n");
+    }
+
+    tis_vcd_reserve(vcd);
+    vcd->used += sprintf(&vcd->buffer[vcd->used], "$upscope $end\n$enddefinitions $end\n");
+
+    // Initial values
+    uint32_t time = sim->cycle * TIS_VCD_CLOCKS_PER_CYCLE;
+    if (vcd->signals & TIS_VCD_STATE) {
+        tis_vcd_vector(vcd, time, 0, 3, 0);
+    }
+    for (int i = 0; i < node_count; i++) {
+        if (!vcd->nodes[i].selected) {
+            continue;
+        }
+        if (tis_vcd_has_registers(&sim->nodes[i])) {
+            tis_vcd_registers(vcd, time, i, 1);
+        }
+        if (vcd->signals & TIS_VCD_PORTS) {
+            tis_vcd_ports(vcd, time, i, 0, 0, 1);
+        }
+    }
+}
+
+void tis_vcd_sample(struct tis_vcd *vcd) {
+    struct tis_sim *sim = vcd->sim;
+    int node_count = sim->rows * sim->cols;
+    uint32_t cycle = sim->cycle - 1;
+
+    if (cycle < vcd->start || cycle >= vcd->end) {
+        return;
+    }
+
+    uint32_t time = cycle * TIS_VCD_CLOCKS_PER_CYCLE;
+
+    // LEFT to FINISH, offers of a phase show up as registered outputs in the next clock
+    for (int phase = 0; phase < 5; phase++) {
+        if (vcd->signals & TIS_VCD_STATE) {
+            tis_vcd_vector(vcd, time + phase + 1, phase + 1, 3, 0);
+        }
+        if (phase == 0 || !(vcd->signals & TIS_VCD_PORTS)) {
+            continue;
+        }
+
+        for (int i = 0; i < node_count; i++) {
+            if (!vcd->nodes[i].selected) {
+                continue;
+            }
+            uint8_t o_active = sim->nodes[i].port_offers[phase - 1];
+            uint8_t i_active = tis_vcd_inputs(sim, i, phase - 1);
+            if (o_active != vcd->nodes[i].o_active || i_active != vcd->nodes[i].i_active) {
+                tis_vcd_ports(vcd, time + phase + 1, i, o_active, i_active, 0);
+            }
+        }
+    }
+
+    // Registers after FINISH, at the RUN of the next cycle
+    time += TIS_VCD_CLOCKS_PER_CYCLE;
+    if (vcd->signals & TIS_VCD_STATE) {
+        tis_vcd_vector(vcd, time, 0, 3, 0);
+    }
+    for (int i = 0; i < node_count; i++) {
+        if (vcd->nodes[i].selected && tis_vcd_has_registers(&sim->nodes[i])) {
+            tis_vcd_registers(vcd, time, i, 0);
+        }
+    }
+}
+
+void tis_vcd_end(struct tis_vcd *vcd) {
+    tis_vcd_flush(vcd);
+    fflush(vcd->file);
+    vcd->sim->record_ports = 0;
+}
+
+void tis_vcd_test() {
+    puts("Starting VCD test");
+
+    int failures = 0;
+    static struct tis_sim sim;
+    static struct tis_sim_node nodes[3];
+    static struct tis_vcd vcd;
+    struct tis_vcd_node vcd_nodes[3];
+    const uint16_t doubler[] = {0xC802, 0x0801, 0xD801};
+    static char text[16384];
+    int16_t value = 0;
+
+    // Stack input, doubler and stack output
+    tis_sim_init(&sim, nodes, 3, 1);
+    tis_sim_stack(&sim, 0, 0, TIS_SIM_STACK_WRITE);
+    tis_sim_stack(&sim, 2, 0, TIS_SIM_STACK_READ);
+    tis_sim_load(&sim, 1, 0, doubler, 3);
+    tis_sim_push(&sim, 0, 0, 21);
+
+    FILE *file = tmpfile();
+    if (file == NULL) {
+        puts("Failed to open a temporary file");
+        return;
+    }
+
+    tis_vcd_init(&vcd, &sim, vcd_nodes, file);
+    tis_vcd_begin(&vcd);
+    for (int i = 0; i < 12; i++) {
+        tis_sim_step(&sim);
+        tis_vcd_sample(&vcd);
+    }
+    tis_vcd_end(&vcd);
+
+    rewind(file);
+    size_t length = fread(text, 1, sizeof(text) - 1, file);
+    text[length] = '\0';
+    fclose(file);
+
+    const char *expected[] = {
+        "$enddefinitions $end",
+        "$scope module node_1_0 $end",
+        "o_down_active",
+        "b00000010101 ", // ACC after MOV UP, ACC
+        "b00000101010 ", // ACC after ADD ACC
+    };
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        if (strstr(text, expected[i]) == NULL) {
+            printf("Failed VCD contents\nExpected: %s\n", expected[i]);
+            failures++;
+        }
+    }
+
+    // The dump doesn't change the run itself
+    if (tis_sim_pop(&sim, 2, 0, &value) != 0 || value != 42) {
+        printf("Failed output\nExpected: 42\nResult: %d\n", value);
+        failures++;
+    }
+
+    if (failures) {
+        printf("Found %d failures", failures);
+    } else {
+        puts("VCD success! :)");
+    }
+}
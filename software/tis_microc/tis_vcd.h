@@ -0,0 +1,73 @@
+/*
+ * tis_vcd.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Powerbyte7
+ *
+ * Writes tis_sim runs as VCD files for GTKWave, using the signal names of
+ * tis_execution_node.vhd so they can be compared with testbench dumps.
+ * One time unit is one clock, so each TIS cycle spans six.
+ */
+
+#ifndef TIS_VCD_H_
+#define TIS_VCD_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "tis_sim.h"
+
+#define TIS_VCD_CLOCKS_PER_CYCLE 6
+#define TIS_VCD_BUFFER_SIZE 8192
+
+// Signal groups
+#define TIS_VCD_PC 0x01
+#define TIS_VCD_ACC 0x02
+#define TIS_VCD_BAK 0x04
+#define TIS_VCD_STATE 0x08
+#define TIS_VCD_PORTS 0x10
+#define TIS_VCD_ALL 0x1F
+
+// Last written values of a node
+struct tis_vcd_node {
+    uint8_t selected;
+    uint8_t pc;
+    int16_t acc;
+    int16_t bak;
+    uint8_t io;
+    uint8_t o_active;
+    uint8_t i_active;
+};
+
+struct tis_vcd {
+    struct tis_sim *sim;
+    struct tis_vcd_node *nodes; // One per grid node
+    FILE *file;
+
+    // Filters, change before tis_vcd_begin()
+    uint8_t signals;
+    uint32_t start; // First TIS cycle to dump
+    uint32_t end;   // Cycle after the last one to dump
+
+    // Time of the last "#" line
+    uint32_t time;
+    uint8_t time_written;
+    char tis_state;
+
+    size_t used;
+    char buffer[TIS_VCD_BUFFER_SIZE];
+};
+
+// Selects all signals of all nodes for every cycle and turns off fusion
+void tis_vcd_init(struct tis_vcd *vcd, struct tis_sim *sim, struct tis_vcd_node nodes[], FILE *file);
+// Writes the header and the current values
+void tis_vcd_begin(struct tis_vcd *vcd);
+// Writes the changes of the cycle that just ran, call after tis_sim_step()
+void tis_vcd_sample(struct tis_vcd *vcd);
+// Flushes buffered output, the file stays open
+void tis_vcd_end(struct tis_vcd *vcd);
+
+// Dumps a short run to a temporary file and checks its contents
+void tis_vcd_test();
+
+#endif /* TIS_VCD_H_ */
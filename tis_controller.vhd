@@ -3,17 +3,50 @@ library ieee;
 	use ieee.numeric_std.all;
 
 	-- Used to toggle tis_active every 6 clock cycles
+	--
+	-- Registers for freezing the grid on a cycle boundary:
+	--   0: control, writing bit 0 freezes after the current cycle, bit 1
+	--      resumes, bit 2 freezes once the cycle count reaches the freeze
+	--      cycle and bit 3 runs for the run cycles. Reads back bit 0 frozen,
+	--      bit 1 freeze pending, bit 2 tis_active, bit 3 cycles left to run
+	--      and bit 4 breakpoint hit.
+	--   1: freeze cycle (15..0)
+	--   2: freeze cycle (31..16)
+	--   3: lowest node that hit a breakpoint (read)
+	--   4: completed cycles (15..0), latches the upper bits
+	--   5: completed cycles (31..16) at the last read of the lower bits
+	--   6: completed cycles (47..32)
+	--   7: completed cycles (63..48)
+	--   8: run cycles (15..0), reads the cycles left
+	--   9: run cycles (31..16)
+	--   16 + n: breakpoints of node n, PC (6..0) with enable bit 7 and a
+	--           second PC (14..8) with enable bit 15
+	-- A frozen controller ignores tis_enable and tis_step_once until resumed,
+	-- then continues with the next cycle. Running for a number of cycles
+	-- acts like tis_enable and stops by itself. Breakpoints freeze the grid
+	-- before a cycle starts with a node at a matching PC, so the instruction
+	-- there hasn't run yet. They are ignored in the first cycle after resume.
 
 entity tis_controller is
+	generic (
+		-- Nodes on debug_pc, each with two breakpoints
+		nodes         : natural range 0 to 48 := 0
+	);
 	port (
 		clock, resetn : in  std_logic;
 		read, write   : in  std_logic;
+		address       : in  std_logic_vector(5 downto 0) := (others => '0');
 		readdata      : out std_logic_vector(15 downto 0);
 		writedata     : in  std_logic_vector(15 downto 0);
 
 		tis_enable    : in  std_logic; -- Signal to enable TIS
 		tis_step_once : in  std_logic; -- Signal to step once despite disable
-		tis_active    : out std_logic  -- Whether TIS is currently enabled
+		tis_active    : out std_logic; -- Whether TIS is currently enabled
+		-- One-hot phase of the cycle for nodes built without their own state
+		-- machine, bit 0 is TIS_RUN up to bit 5 for TIS_FINISH
+		tis_phase     : out std_logic_vector(5 downto 0);
+		-- PC of every node from tis_grid, 7 bits each
+		debug_pc      : in  std_logic_vector(7 * nodes - 1 downto 0) := (others => '0')
 	);
 end entity;
 
@@ -24,11 +57,101 @@ architecture rtl of tis_controller is
 
 	signal tis_step_done : std_logic := '0'; -- Used to step once
 	signal active        : std_logic := '0'; -- Used to step once
+
+	signal frozen        : std_logic             := '0'; -- Held on a cycle boundary until resumed
+	signal freeze_next   : std_logic             := '0'; -- Freeze after the current cycle
+	signal freeze_armed  : std_logic             := '0'; -- Freeze once freeze_cycle is reached
+	signal freeze_cycle  : unsigned(31 downto 0) := (others => '0');
+	signal cycle         : unsigned(63 downto 0) := (others => '0');
+	signal cycle_upper   : std_logic_vector(63 downto 16) := (others => '0');
+
+	signal run_cycles    : unsigned(31 downto 0) := (others => '0');
+	signal run_left      : unsigned(31 downto 0) := (others => '0'); -- Cycles until running stops
+	signal run_enable    : std_logic; -- tis_enable or running for a number of cycles
+
+	type breakpoint_words is array (0 to nodes - 1) of std_logic_vector(15 downto 0);
+
+	signal breakpoints   : breakpoint_words := (others => (others => '0'));
+	signal break_match   : natural range 0 to nodes; -- Lowest matching node, nodes when none
+	signal break_now     : std_logic; -- Hold the nodes before this cycle starts
+	signal break_skip    : std_logic := '0'; -- Resumed from a breakpoint, let one cycle pass
+	signal break_hit     : std_logic := '0';
+	signal break_node    : natural range 0 to nodes := 0;
 begin
 
-	readdata <= (others => '0');
+	-- Nodes stay in TIS_RUN while the controller freezes on a breakpoint
+	tis_active <= active and not break_now;
 
-	tis_active <= active;
+	run_enable <= '1' when tis_enable = '1' or run_left /= 0 else '0';
+
+	breakpoint_match: process (breakpoints, debug_pc)
+		variable pc : std_logic_vector(6 downto 0);
+	begin
+		break_match <= nodes;
+		for n in nodes - 1 downto 0 loop
+			pc := debug_pc(7 * n + 6 downto 7 * n);
+			if (breakpoints(n)(7) = '1' and breakpoints(n)(6 downto 0) = pc) or
+			   (breakpoints(n)(15) = '1' and breakpoints(n)(14 downto 8) = pc) then
+				break_match <= n;
+			end if;
+		end loop;
+	end process;
+
+	break_now <= '1' when node_state = TIS_RUN and active = '1' and frozen = '0' and break_skip = '0' and break_match < nodes else '0';
+
+	-- Matches the state of the nodes whenever tis_active is high
+	phase_bus: for i in 0 to 5 generate
+		tis_phase(i) <= '1' when tis_state'pos(node_state) = i else '0';
+	end generate;
+
+	registers: process (clock, resetn) is
+	begin
+		if resetn = '0' then
+			readdata <= (others => '0');
+			cycle_upper <= (others => '0');
+			freeze_cycle <= (others => '0');
+			run_cycles <= (others => '0');
+			breakpoints <= (others => (others => '0'));
+		elsif rising_edge(clock) then
+			if read = '1' then
+				readdata <= (others => '0');
+				case to_integer(unsigned(address)) is
+					when 0 =>
+						readdata(0) <= frozen;
+						readdata(1) <= freeze_next or freeze_armed;
+						readdata(2) <= active;
+						if run_left /= 0 then
+							readdata(3) <= '1';
+						end if;
+						readdata(4) <= break_hit;
+					when 1 => readdata <= std_logic_vector(freeze_cycle(15 downto 0));
+					when 2 => readdata <= std_logic_vector(freeze_cycle(31 downto 16));
+					when 3 => readdata <= std_logic_vector(to_unsigned(break_node, 16));
+					when 4 =>
+						readdata <= std_logic_vector(cycle(15 downto 0));
+						cycle_upper <= std_logic_vector(cycle(63 downto 16));
+					when 5 => readdata <= cycle_upper(31 downto 16);
+					when 6 => readdata <= cycle_upper(47 downto 32);
+					when 7 => readdata <= cycle_upper(63 downto 48);
+					when 8 => readdata <= std_logic_vector(run_left(15 downto 0));
+					when 9 => readdata <= std_logic_vector(run_left(31 downto 16));
+					when 16 to 16 + nodes - 1 => readdata <= breakpoints(to_integer(unsigned(address)) - 16);
+					when others => null;
+				end case;
+			end if;
+
+			if write = '1' then
+				case to_integer(unsigned(address)) is
+					when 1 => freeze_cycle(15 downto 0) <= unsigned(writedata);
+					when 2 => freeze_cycle(31 downto 16) <= unsigned(writedata);
+					when 8 => run_cycles(15 downto 0) <= unsigned(writedata);
+					when 9 => run_cycles(31 downto 16) <= unsigned(writedata);
+					when 16 to 16 + nodes - 1 => breakpoints(to_integer(unsigned(address)) - 16) <= writedata;
+					when others => null;
+				end case;
+			end if;
+		end if;
+	end process;
 
 	process (clock, resetn) is
 	begin
@@ -36,31 +159,72 @@ begin
 			node_state <= TIS_RUN;
 			tis_step_done <= '0';
 			active <= '0';
+			frozen <= '0';
+			freeze_next <= '0';
+			freeze_armed <= '0';
+			cycle <= (others => '0');
+			run_left <= (others => '0');
+			break_skip <= '0';
+			break_hit <= '0';
+			break_node <= 0;
 		elsif rising_edge(clock) then
+			if write = '1' and unsigned(address) = 0 then
+				if writedata(1) = '1' then
+					frozen <= '0';
+					freeze_next <= '0';
+					freeze_armed <= '0';
+					break_skip <= break_hit;
+					break_hit <= '0';
+				end if;
+				if writedata(0) = '1' then
+					freeze_next <= '1';
+				end if;
+				if writedata(2) = '1' then
+					freeze_armed <= '1';
+				end if;
+				if writedata(3) = '1' then
+					run_left <= run_cycles;
+				end if;
+			end if;
+
 			case node_state is
 				when TIS_RUN =>
 					node_state <= TIS_RUN;
 
-					if tis_enable = '0' and active = '0' and tis_step_once = '1' and tis_step_done = '0' then
+					if frozen = '1' then
+						-- Wait for resume
+						null;
+					elsif (freeze_next = '1' or (freeze_armed = '1' and cycle >= freeze_cycle)) and active = '0' then
+						-- Already between cycles
+						frozen <= '1';
+						freeze_next <= '0';
+						freeze_armed <= '0';
+					elsif break_now = '1' then
+						-- Nodes didn't see tis_active, the cycle hasn't started
+						active <= '0';
+						frozen <= '1';
+						break_hit <= '1';
+						break_node <= break_match;
+					elsif run_enable = '0' and active = '0' and tis_step_once = '1' and tis_step_done = '0' then
 						-- Don't go to next state yet, need extra clock cycle to keep synced state
 						node_state <= TIS_RUN;
 						active <= '1';
-					elsif tis_enable = '0' and active = '1' and tis_step_once = '1' and tis_step_done = '0' then
+					elsif run_enable = '0' and active = '1' and tis_step_once = '1' and tis_step_done = '0' then
 						node_state <= TIS_LEFT;
 						tis_step_done <= '1';
-					elsif tis_enable = '1' and active = '0' then
+					elsif run_enable = '1' and active = '0' then
 						-- Don't go to next state yet, need extra clock cycle to keep synced state
 						node_state <= TIS_RUN;
 						active <= '1';
-					elsif tis_enable = '1' and active = '1' then
+					elsif run_enable = '1' and active = '1' then
 						node_state <= TIS_LEFT;
-					elsif tis_enable = '0' then
+					elsif run_enable = '0' then
 						-- Cycle already started, complete it
 						node_state <= TIS_LEFT;
 					end if;
 
 					-- Don't allow stepping while enabled
-					if tis_enable = '1' then
+					if run_enable = '1' then
 						tis_step_done <= '1';
 					end if;
 
@@ -73,15 +237,30 @@ begin
 				when TIS_DOWN =>
 					node_state <= TIS_FINISH;
 				when TIS_FINISH =>
+					if active = '1' then
+						cycle <= cycle + 1;
+						break_skip <= '0';
+						if run_left /= 0 then
+							run_left <= run_left - 1;
+						end if;
+					end if;
 
-					-- Disable when enable flag drops
-					if tis_enable = '0' then
+					-- Disable when enable flag drops or the last cycle to run is done
+					if tis_enable = '0' and run_left <= 1 then
 						active <= '0';
 						if tis_step_once = '0' then
 							tis_step_done <= '0';
 						end if;
 					end if;
 
+					-- Freeze on the boundary of this cycle
+					if active = '1' and (freeze_next = '1' or (freeze_armed = '1' and cycle + 1 >= freeze_cycle)) then
+						active <= '0';
+						frozen <= '1';
+						freeze_next <= '0';
+						freeze_armed <= '0';
+					end if;
+
 					node_state <= TIS_RUN;
 			end case;
 		end if;
@@ -34,30 +34,57 @@ architecture rtl of tis_controller_tb is
 	signal clock_tb          : std_logic                     := '0';
 	signal resetn_tb         : std_logic                     := '1';
 	signal read_tb, write_tb : std_logic                     := '0';
+	signal address_tb        : std_logic_vector(5 downto 0)  := (others => '0');
 	signal readdata_tb       : std_logic_vector(15 downto 0);
 	signal writedata_tb      : std_logic_vector(15 downto 0) := (others => '0');
 	signal tis_enable_tb     : std_logic                     := '1';
 	signal tis_step_once_tb  : std_logic                     := '0';
 	signal tis_active_tb     : std_logic;
+	signal tis_phase_tb      : std_logic_vector(5 downto 0);
+	signal debug_pc_tb       : std_logic_vector(6 downto 0)  := (others => '0');
 
 begin
 	-- Port map
 	left_node: entity work.tis_controller
+		generic map (
+			nodes => 1
+		)
 		port map (
 
 			clock         => clock_tb,
 			resetn        => resetn_tb,
 			read          => read_tb,
 			write         => write_tb,
+			address       => address_tb,
 			readdata      => readdata_tb,
 			writedata     => writedata_tb,
 			-- TIS signals
 			tis_enable    => tis_enable_tb,
 			tis_step_once => tis_step_once_tb,
-			tis_active    => tis_active_tb
+			tis_active    => tis_active_tb,
+			tis_phase     => tis_phase_tb,
+			debug_pc      => debug_pc_tb
 		);
 
 	process
+		variable start_cycle : natural;
+
+		procedure ControllerWrite(addr : natural; value : std_logic_vector(15 downto 0)) is
+		begin
+			write_tb <= '1';
+			address_tb <= std_logic_vector(to_unsigned(addr, address_tb'length));
+			writedata_tb <= value;
+			ClockPulse(clock_tb);
+			write_tb <= '0';
+		end procedure;
+
+		procedure ControllerRead(addr : natural) is
+		begin
+			read_tb <= '1';
+			address_tb <= std_logic_vector(to_unsigned(addr, address_tb'length));
+			ClockPulse(clock_tb);
+			read_tb <= '0';
+		end procedure;
 	begin
 
 		-- Test init
@@ -66,7 +93,13 @@ begin
 		ClockPulse(clock_tb);
 		assert tis_active_tb = '1' report "Expected tis_active high afer first clock cycle" severity error;
 		TisPulse(clock_tb);
-		TisPulse(clock_tb);
+
+		-- Phase bus walks from TIS_RUN to TIS_FINISH and back
+		assert tis_phase_tb = "000001" report "Expected TIS_RUN on tis_phase, got " & to_string(tis_phase_tb) severity error;
+		for i in 1 to 6 loop
+			ClockPulse(clock_tb);
+			assert tis_phase_tb = std_logic_vector(shift_left(to_unsigned(1, 6), i mod 6)) report "Expected phase " & to_string(i mod 6) & " on tis_phase, got " & to_string(tis_phase_tb) severity error;
+		end loop;
 		assert tis_active_tb = '1' report "Expected tis_active high afer two instruction cycles" severity error;
 
 		-- Test disable
@@ -84,7 +117,106 @@ begin
 		assert tis_active_tb = '0' report "Expected tis_active low afer finishing step" severity error;
 		ClockPulse(clock_tb);
 		assert tis_active_tb = '0' report "Expected tis_active low afer finishing step" severity error;
+		tis_step_once_tb <= '0';
+
+		-- Freeze three cycles after enabling
+		ControllerRead(4);
+		start_cycle := to_integer(unsigned(readdata_tb));
+		ControllerWrite(1, std_logic_vector(to_unsigned(start_cycle + 3, 16)));
+		ControllerWrite(2, x"0000");
+		ControllerWrite(0, x"0004");
+
+		ControllerRead(0);
+		assert readdata_tb = x"0002" report "Expected pending freeze, got " & to_string(readdata_tb) severity error;
 
+		tis_enable_tb <= '1';
+		for i in 1 to 6 loop
+			TisPulse(clock_tb);
+		end loop;
+		assert tis_active_tb = '0' report "Expected tis_active low while frozen" severity error;
+
+		ControllerRead(0);
+		assert readdata_tb = x"0001" report "Expected frozen status, got " & to_string(readdata_tb) severity error;
+		ControllerRead(4);
+		assert to_integer(unsigned(readdata_tb)) = start_cycle + 3 report "Expected freeze after cycle " & to_string(start_cycle + 3) & ", got " & to_string(to_integer(unsigned(readdata_tb))) severity error;
+		ControllerRead(5);
+		assert readdata_tb = x"0000" report "Expected upper cycle count 0, got " & to_string(readdata_tb) severity error;
+
+		-- Resume takes one clock to resync, like enabling
+		ControllerWrite(0, x"0002");
+		ClockPulse(clock_tb);
+		assert tis_active_tb = '1' report "Expected tis_active high after resuming" severity error;
+		assert tis_phase_tb = "000001" report "Expected resume in TIS_RUN, got " & to_string(tis_phase_tb) severity error;
+
+		-- Freeze at the end of the running cycle
+		TisPulse(clock_tb);
+		ClockPulse(clock_tb);
+		ControllerWrite(0, x"0001");
+		TisPulse(clock_tb);
+		assert tis_active_tb = '0' report "Expected tis_active low after freezing" severity error;
+		assert tis_phase_tb = "000001" report "Expected freeze in TIS_RUN, got " & to_string(tis_phase_tb) severity error;
+		ControllerRead(0);
+		assert readdata_tb = x"0001" report "Expected frozen status, got " & to_string(readdata_tb) severity error;
+		tis_enable_tb <= '0';
+		ControllerWrite(0, x"0002");
+
+		-- Run for four cycles while disabled
+		ControllerRead(4);
+		start_cycle := to_integer(unsigned(readdata_tb));
+		ControllerWrite(8, x"0004");
+		ControllerWrite(9, x"0000");
+		ControllerWrite(0, x"0008");
+		ControllerRead(0);
+		assert readdata_tb(3) = '1' report "Expected cycles left to run, got " & to_string(readdata_tb) severity error;
+
+		for i in 1 to 8 loop
+			TisPulse(clock_tb);
+		end loop;
+		assert tis_active_tb = '0' report "Expected tis_active low after running" severity error;
+
+		ControllerRead(0);
+		assert readdata_tb = x"0000" report "Expected idle status after running, got " & to_string(readdata_tb) severity error;
+		ControllerRead(4);
+		assert to_integer(unsigned(readdata_tb)) = start_cycle + 4 report "Expected " & to_string(start_cycle + 4) & " cycles after running, got " & to_string(to_integer(unsigned(readdata_tb))) severity error;
+		ControllerRead(6);
+		assert readdata_tb = x"0000" report "Expected cycle count bits 47..32 at 0, got " & to_string(readdata_tb) severity error;
+
+		-- Breakpoint on PC 5 of node 0
+		debug_pc_tb <= "0000011";
+		ControllerWrite(16, x"0085");
+		tis_enable_tb <= '1';
+		TisPulse(clock_tb);
+		TisPulse(clock_tb);
+		assert tis_active_tb = '1' report "Expected tis_active high before reaching the breakpoint" severity error;
+
+		debug_pc_tb <= "0000101";
+		TisPulse(clock_tb);
+		TisPulse(clock_tb);
+		assert tis_active_tb = '0' report "Expected tis_active low on the breakpoint" severity error;
+		assert tis_phase_tb = "000001" report "Expected breakpoint in TIS_RUN, got " & to_string(tis_phase_tb) severity error;
+
+		ControllerRead(0);
+		assert readdata_tb = x"0011" report "Expected breakpoint hit status, got " & to_string(readdata_tb) severity error;
+		ControllerRead(3);
+		assert readdata_tb = x"0000" report "Expected breakpoint on node 0, got " & to_string(readdata_tb) severity error;
+		ControllerRead(4);
+		start_cycle := to_integer(unsigned(readdata_tb));
+		TisPulse(clock_tb);
+		ControllerRead(4);
+		assert to_integer(unsigned(readdata_tb)) = start_cycle report "Expected cycle count to hold on the breakpoint" severity error;
+
+		-- Resuming runs the instruction at the breakpoint once
+		ControllerWrite(0, x"0002");
+		ClockPulse(clock_tb);
+		assert tis_active_tb = '1' report "Expected tis_active high after resuming from the breakpoint" severity error;
+		TisPulse(clock_tb);
+		assert tis_active_tb = '0' report "Expected the breakpoint to hit again" severity error;
+		ControllerRead(4);
+		assert to_integer(unsigned(readdata_tb)) = start_cycle + 1 report "Expected one cycle past the breakpoint, got " & to_string(to_integer(unsigned(readdata_tb))) severity error;
+
+		ControllerWrite(16, x"0000");
+		tis_enable_tb <= '0';
+		ControllerWrite(0, x"0002");
 
 		report "Testbench success!!!" severity note;
 		std.env.stop;
@@ -0,0 +1,97 @@
+-- altera vhdl_input_version vhdl_2008
+library IEEE;
+	use IEEE.std_logic_1164.all;
+	use IEEE.numeric_std.all;
+
+	-- FIFO between two unrelated clocks. Both pointers cross in gray code
+	-- through two flip-flops, so full and empty are pessimistic for a couple
+	-- of clocks but never wrong. The head entry is shown ahead on read_data.
+
+entity tis_dcfifo is
+	generic (
+		width      : positive;
+		-- Holds 2 ** depth_bits entries
+		depth_bits : positive := 2
+	);
+	port (
+		-- Write side
+		write_clock, write_resetn : in  std_logic;
+		write                     : in  std_logic;
+		write_data                : in  std_logic_vector(width - 1 downto 0);
+		full                      : out std_logic;
+		-- Read side
+		read_clock, read_resetn   : in  std_logic;
+		read                      : in  std_logic;
+		read_data                 : out std_logic_vector(width - 1 downto 0);
+		empty                     : out std_logic
+	);
+end entity;
+
+architecture rtl of tis_dcfifo is
+	type fifo is array (0 to 2 ** depth_bits - 1) of std_logic_vector(width - 1 downto 0);
+
+	pure function ToGray(value : unsigned) return std_logic_vector is
+	begin
+		return std_logic_vector(value xor shift_right(value, 1));
+	end function;
+
+	signal values : fifo;
+
+	-- Pointers carry an extra wrap bit to tell full from empty
+	signal write_ptr  : unsigned(depth_bits downto 0)        := (others => '0');
+	signal write_gray : std_logic_vector(depth_bits downto 0) := (others => '0');
+	signal read_ptr   : unsigned(depth_bits downto 0)        := (others => '0');
+	signal read_gray  : std_logic_vector(depth_bits downto 0) := (others => '0');
+
+	-- Pointer of the other side, two flip-flops deep
+	signal read_gray_meta, read_gray_sync   : std_logic_vector(depth_bits downto 0) := (others => '0');
+	signal write_gray_meta, write_gray_sync : std_logic_vector(depth_bits downto 0) := (others => '0');
+
+	signal is_full, is_empty : std_logic;
+begin
+
+	-- Full when the writer is a whole lap ahead, which in gray code flips the two upper bits
+	is_full <= '1' when write_gray = (not read_gray_sync(depth_bits downto depth_bits - 1)) & read_gray_sync(depth_bits - 2 downto 0) else '0';
+	is_empty <= '1' when read_gray = write_gray_sync else '0';
+
+	full <= is_full;
+	empty <= is_empty;
+	read_data <= values(to_integer(read_ptr(depth_bits - 1 downto 0)));
+
+	write_side: process (write_clock, write_resetn)
+	begin
+		if write_resetn = '0' then
+			write_ptr <= (others => '0');
+			write_gray <= (others => '0');
+			read_gray_meta <= (others => '0');
+			read_gray_sync <= (others => '0');
+		elsif rising_edge(write_clock) then
+			read_gray_meta <= read_gray;
+			read_gray_sync <= read_gray_meta;
+
+			if write = '1' and is_full = '0' then
+				values(to_integer(write_ptr(depth_bits - 1 downto 0))) <= write_data;
+				write_ptr <= write_ptr + 1;
+				write_gray <= ToGray(write_ptr + 1);
+			end if;
+		end if;
+	end process;
+
+	read_side: process (read_clock, read_resetn)
+	begin
+		if read_resetn = '0' then
+			read_ptr <= (others => '0');
+			read_gray <= (others => '0');
+			write_gray_meta <= (others => '0');
+			write_gray_sync <= (others => '0');
+		elsif rising_edge(read_clock) then
+			write_gray_meta <= write_gray;
+			write_gray_sync <= write_gray_meta;
+
+			if read = '1' and is_empty = '0' then
+				read_ptr <= read_ptr + 1;
+				read_gray <= ToGray(read_ptr + 1);
+			end if;
+		end if;
+	end process;
+end architecture;
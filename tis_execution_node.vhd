@@ -4,64 +4,132 @@ library IEEE;
 	use IEEE.numeric_std.all;
 
 entity tis_execution_node is
+	generic (
+		-- Offer all ports in parallel with valid/ready handshakes instead of
+		-- one direction per tis_state, retiring up to one instruction per clock.
+		-- o_*_active then marks a valid write and o_*_ready a pending read.
+		-- The handshake generic of tis_grid sets it on every node and link,
+		-- tis_host_port only speaks the phased protocol.
+		HANDSHAKE : boolean := false;
+		-- Keep the round robin but retire instructions that don't use a port
+		-- in any clock instead of once per cycle. Ignored with HANDSHAKE.
+		PIPELINED : boolean := false;
+		-- Take the phase from tis_phase instead of a private state machine and
+		-- keep the program in LUT RAM. The program isn't cleared on reset,
+		-- Q_export only carries the header and program words only read back
+		-- while tis_active is low, otherwise as 0.
+		COMPACT   : boolean := false;
+		-- Program counter bits, the node holds 2 ** PC_WIDTH - 1 instructions
+		-- in 2 ** (PC_WIDTH - 1) words. Above 6 jumps use the extended encoding.
+		PC_WIDTH  : positive range 4 to 7 := 4;
+		-- Decode MOV <SRC>, <DST> with bit 10 set as a broadcast to the ports
+		-- in bits 6..3 (UP, DOWN, LEFT, RIGHT from bit 3). The value is offered
+		-- on each of them in its own phase and the MOV retires once all took it.
+		-- Only the round robin processor supports it, otherwise it's MOV to ANY.
+		BROADCAST : boolean := false;
+		-- Performance counters in a second window of 2 ** (PC_WIDTH - 1) words
+		-- after the program, which takes one more address bit:
+		--   0: TIS cycles while active  1: instructions retired
+		--   2: read stalls UP | DOWN    3: read stalls LEFT | RIGHT
+		--   4: write stalls UP | DOWN   5: write stalls LEFT | RIGHT
+		--   6: cycles waiting on ANY    7: any write clears all counters
+		-- Stalls are cycles that end with the port operation still pending,
+		-- counted in saturating 16 bit halves. Retired instructions and stalls
+		-- follow the round robin processor and stay at 0 in the other modes.
+		COUNTERS  : boolean := false;
+		-- Snapshot of the runtime state in the window after the counters, or
+		-- after the program without COUNTERS, which takes one more address bit:
+		--   0: ACC (15..0), BAK (31..16)
+		--   1: PC (6..0), tis_state (10..8), pending read (11) and write (12),
+		--      last ANY port (15..13), pending I/O value (31..16)
+		-- Writing the window takes the snapshot. status_capture takes it in
+		-- the same clock as the other nodes, so a grid can be read coherently.
+		STATUS    : boolean := false;
+		-- Control word in the window after the status, or the last window
+		-- before it, which takes one more address bit. Writes set bit 0 to
+		-- enable, bit 1 to reset PC, ACC, BAK and LAST while halted and bit 2
+		-- to halt with a port operation pending. Reads back bit 0 enable,
+		-- bit 1 halted, bit 2 forced and bit 3 a pending port operation.
+		-- A disabled node halts in TIS_RUN once its instruction retired and
+		-- offers nothing on its ports, so neighbours block until it runs
+		-- again and the program can be swapped. The context follows the
+		-- control word and can be written while halted:
+		--   1: ACC (15..0), BAK (31..16)
+		--   2: like status word 1, the tis_state bits are read only
+		--   3: source port (2..0), destination port (5..3), broadcast ports (11..8)
+		-- Only the round robin processor supports it.
+		HOT_SWAP  : boolean := false
+	);
 	port (
 		clock, resetn  : in  std_logic;
 		read, write    : in  std_logic;
-		address        : in  std_logic_vector(2 downto 0);
+		address        : in  std_logic_vector(PC_WIDTH - 2 + boolean'pos(COUNTERS) + boolean'pos(STATUS) + boolean'pos(HOT_SWAP) downto 0);
 		readdata       : out std_logic_vector(31 downto 0);
 		writedata      : in  std_logic_vector(31 downto 0);
 		byteenable     : in  std_logic_vector(3 downto 0);
 		Q_export       : out std_logic_vector(31 downto 0);
 		-- Used to avoid early start without initialized program
 		tis_active     : in  std_logic;
+		-- One-hot phase from tis_controller, only used when COMPACT
+		tis_phase      : in  std_logic_vector(5 downto 0) := (others => '0');
+		-- Takes the STATUS snapshot, shared by the nodes of a grid
+		status_capture : in  std_logic := '0';
 		-- Left conduit
 		i_left         : in  std_logic_vector(10 downto 0);
 		i_left_active  : in  std_logic := '0';
 		o_left         : out std_logic_vector(10 downto 0);
 		o_left_active  : out std_logic;
+		i_left_ready   : in  std_logic := '0';
+		o_left_ready   : out std_logic;
 		-- Right conduit
 		i_right        : in  std_logic_vector(10 downto 0);
 		i_right_active : in  std_logic := '0';
 		o_right        : out std_logic_vector(10 downto 0);
 		o_right_active : out std_logic;
+		i_right_ready  : in  std_logic := '0';
+		o_right_ready  : out std_logic;
 		-- Up conduit
 		i_up           : in  std_logic_vector(10 downto 0);
 		i_up_active    : in  std_logic := '0';
 		o_up           : out std_logic_vector(10 downto 0);
 		o_up_active    : out std_logic;
+		i_up_ready     : in  std_logic := '0';
+		o_up_ready     : out std_logic;
 		-- Down conduit
 		i_down         : in  std_logic_vector(10 downto 0);
 		i_down_active  : in  std_logic := '0';
 		o_down         : out std_logic_vector(10 downto 0);
 		o_down_active  : out std_logic;
+		i_down_ready   : in  std_logic := '0';
+		o_down_ready   : out std_logic;
 		-- For debugging purposes
 		debug_acc      : out std_logic_vector(10 downto 0);
 		debug_bak      : out std_logic_vector(10 downto 0);
-		debug_pc       : out unsigned(3 downto 0)
+		debug_pc       : out unsigned(PC_WIDTH - 1 downto 0)
 	);
 end entity;
 
 architecture rtl of tis_execution_node is
 	-- Avalon Memory
-	type registers is array (0 to 7) of std_logic_vector(31 downto 0);
+	type registers is array (0 to 2 ** (PC_WIDTH - 1) - 1) of std_logic_vector(31 downto 0);
 	signal regs : registers;
 
 	procedure IncrementPC(
-			signal pc               : inout unsigned(3 downto 0);
-			signal last_instruction : in    unsigned(3 downto 0)
+			signal pc               : inout unsigned;
+			signal last_instruction : in    unsigned
 		) is
 	begin
 		if pc = last_instruction then
-			pc <= (others => '0');
+			pc <= (pc'range => '0');
 		else
 			pc <= pc + 1;
 		end if;
 	end procedure;
 
 	procedure SetPC(
-			signal pc               : out unsigned(3 downto 0);
-			signal last_instruction : in  unsigned(3 downto 0);
-			signal value            : in  std_logic_vector(3 downto 0)
+			signal pc               : out unsigned;
+			signal last_instruction : in  unsigned;
+			signal value            : in  std_logic_vector
 		) is
 	begin
 		if unsigned(value) < last_instruction then
@@ -72,8 +140,8 @@ architecture rtl of tis_execution_node is
 	end procedure;
 
 	procedure OffsetsetPC(
-			signal pc               : inout unsigned(3 downto 0);
-			signal last_instruction : in    unsigned(3 downto 0);
+			signal pc               : inout unsigned;
+			signal last_instruction : in    unsigned;
 			signal value            : in    std_logic_vector(3 downto 0)
 		) is
 	begin
@@ -85,7 +153,7 @@ architecture rtl of tis_execution_node is
 				pc <= last_instruction;
 			end if;
 		else
-			pc <= (others => '0');
+			pc <= (pc'range => '0');
 		end if;
 
 	end procedure;
@@ -107,6 +175,98 @@ architecture rtl of tis_execution_node is
 	constant JGZ : std_logic_vector(2 downto 0) := "100";
 	constant JNZ : std_logic_vector(2 downto 0) := "110";
 
+	-- Jumps keep the condition in bits 8..6 and the target in bits 5..0.
+	-- Wider program counters extend the target with bits 11..9.
+	function IsJump(instruction : std_logic_vector(15 downto 0)) return boolean is
+	begin
+		if PC_WIDTH > 6 then
+			return instruction(15 downto 12) = "0111";
+		else
+			return instruction(15 downto 9) = "0111000";
+		end if;
+	end function;
+
+	function JumpTarget(instruction : std_logic_vector(15 downto 0)) return std_logic_vector is
+		variable target : std_logic_vector(8 downto 0) := instruction(11 downto 9) & instruction(5 downto 0);
+	begin
+		return target(PC_WIDTH - 1 downto 0);
+	end function;
+
+	-- Port operand of an instruction, NIL for instructions without one
+	function SourcePort(
+			instruction : std_logic_vector(15 downto 0);
+			last        : std_logic_vector(2 downto 0)
+		) return std_logic_vector is
+		variable src : std_logic_vector(2 downto 0) := instruction(2 downto 0);
+	begin
+		if not ((instruction(15 downto 14) = "00" and instruction(11) = '1') or
+		        instruction(15 downto 14) = "11" or
+		        instruction(15 downto 3) = "0110000000000") then
+			return NIL;
+		end if;
+
+		if src = LAST then
+			src := last;
+		end if;
+
+		if src = NIL or src = ACC then
+			return NIL;
+		end if;
+		return src;
+	end function;
+
+	-- Port written by a MOV, NIL for other instructions and ACC/NIL destinations
+	function DestinationPort(
+			instruction : std_logic_vector(15 downto 0);
+			last        : std_logic_vector(2 downto 0)
+		) return std_logic_vector is
+		variable dst : std_logic_vector(2 downto 0) := instruction(13 downto 11);
+	begin
+		if instruction(15) = '0' then
+			return NIL;
+		end if;
+
+		if dst = LAST then
+			dst := last;
+		end if;
+
+		if dst = NIL or dst = ACC then
+			return NIL;
+		end if;
+		return dst;
+	end function;
+
+	-- Port tried by ANY in a slot, in the order of the round robin phases:
+	-- reads go LEFT, RIGHT, UP, DOWN and writes go RIGHT, LEFT, DOWN, UP
+	function ScanPort(
+			port_reg : std_logic_vector(2 downto 0);
+			slot     : unsigned(1 downto 0);
+			is_write : boolean
+		) return std_logic_vector is
+		type port_order is array (0 to 3) of std_logic_vector(2 downto 0);
+		constant READ_ORDER  : port_order := (LEFT, RIGHT, UP, DOWN);
+		constant WRITE_ORDER : port_order := (RIGHT, LEFT, DOWN, UP);
+	begin
+		if port_reg /= ANY then
+			return port_reg;
+		elsif is_write then
+			return WRITE_ORDER(to_integer(slot));
+		else
+			return READ_ORDER(to_integer(slot));
+		end if;
+	end function;
+
+	function IsPort(port_reg : std_logic_vector(2 downto 0)) return boolean is
+	begin
+		return port_reg = UP or port_reg = DOWN or port_reg = LEFT or port_reg = RIGHT;
+	end function;
+
+	-- Bit of a port in a broadcast mask
+	function PortBit(port_reg : std_logic_vector(2 downto 0)) return natural is
+	begin
+		return to_integer(unsigned(port_reg)) - to_integer(unsigned(UP));
+	end function;
+
 	type tis_state is (TIS_RUN, TIS_LEFT, TIS_RIGHT, TIS_UP, TIS_DOWN, TIS_FINISH);
 
 	signal node_state    : tis_state                    := TIS_RUN; -- Write/Read direction of node
@@ -120,91 +280,553 @@ architecture rtl of tis_execution_node is
 	-- node_last gets set after recieving/writing using ANY
 	signal node_last : std_logic_vector(2 downto 0) := NIL;
 
+	-- Ports that still have to take a broadcast value
+	signal node_fanout : std_logic_vector(3 downto 0) := (others => '0');
+
 	-- Addressable CPU register
 	signal node_acc : integer range - 999 to 999 := 0;
 	-- Non-addressable CPU register
 	signal node_bak : integer range - 999 to 999 := 0;
 	-- Program Counter
-	signal node_pc : unsigned(3 downto 0) := (others => '0');
+	signal node_pc : unsigned(PC_WIDTH - 1 downto 0) := (others => '0');
 	-- Instruction at current PC
 	signal current_instruction      : std_logic_vector(15 downto 0);
-	signal last_instruction_address : unsigned(3 downto 0);
+	signal last_instruction_address : unsigned(PC_WIDTH - 1 downto 0);
+	signal jump_target              : std_logic_vector(PC_WIDTH - 1 downto 0);
+
+	-- Context words hold 16 bit values, ACC and friends stay within TIS range
+	function TisValue(bits : std_logic_vector(15 downto 0)) return integer is
+	begin
+		if signed(bits) > 999 then
+			return 999;
+		elsif signed(bits) < - 999 then
+			return - 999;
+		end if;
+		return to_integer(signed(bits));
+	end function;
+
+	-- Register windows after the program
+	constant COUNTER_WINDOW : natural := 1;
+	constant STATUS_WINDOW  : natural := 1 + boolean'pos(COUNTERS);
+	constant SWAP_WINDOW    : natural := 1 + boolean'pos(COUNTERS) + boolean'pos(STATUS);
+
+	-- Avalon accesses to the program, the rest goes to the other windows
+	signal program_address  : std_logic_vector(PC_WIDTH - 2 downto 0);
+	signal program_write    : std_logic;
+	signal window           : natural range 0 to 7;
+	signal read_window      : natural range 0 to 7 := 0; -- Window of the last read
+	signal memory_readdata  : std_logic_vector(31 downto 0);
+	signal counter_readdata : std_logic_vector(31 downto 0) := (others => '0');
+	signal status_readdata  : std_logic_vector(31 downto 0) := (others => '0');
+	signal swap_readdata    : std_logic_vector(31 downto 0) := (others => '0');
+
+	-- Hot swap, the node stays out of the cycles while node_halt is set
+	signal swap_enable : std_logic := '1';
+	signal swap_force  : std_logic := '0';
+	signal node_halted : std_logic := '0';
+	signal node_halt   : std_logic := '0';
+	signal node_clear  : std_logic := '0'; -- Resets the registers of a halted node
+	signal node_load   : std_logic := '0'; -- Writes a context word of a halted node
 
 begin
-	Q_export  <= regs(0);
 	debug_acc <= std_logic_vector(to_signed(node_acc, debug_acc'length));
 	debug_bak <= std_logic_vector(to_signed(node_bak, debug_acc'length));
 	debug_pc  <= node_pc;
 
-	last_instruction_address <= unsigned(regs(0)(3 downto 0));
+	jump_target <= JumpTarget(current_instruction);
+
+	program_address <= address(PC_WIDTH - 2 downto 0);
+	window <= to_integer(unsigned(address(address'high downto PC_WIDTH - 1))) when COUNTERS or STATUS or HOT_SWAP else 0;
+	program_write <= write when window = 0 else '0';
 
-	memory_bus: process (clock, resetn)
+	readdata <= memory_readdata when read_window = 0 else
+	            counter_readdata when COUNTERS and read_window = COUNTER_WINDOW else
+	            status_readdata when STATUS and read_window = STATUS_WINDOW else
+	            swap_readdata when HOT_SWAP and read_window = SWAP_WINDOW else
+	            (others => '0');
+
+	read_select: process (clock, resetn)
 	begin
 		if resetn = '0' then
-			regs <= (others => (others => '0'));
+			read_window <= 0;
 		elsif rising_edge(clock) then
 			if read = '1' then
-				readdata <= regs(to_integer(unsigned(address)));
-			elsif write = '1' then
-				for i in 0 to 3 loop
-					if byteenable(i) = '1' then
-						regs(to_integer(unsigned(address)))(i * 8 + 7 downto i * 8) <= writedata(i * 8 + 7 downto i * 8);
-					end if;
-				end loop;
+				read_window <= window;
 			end if;
 		end if;
 	end process;
 
-	instruction_fetch: process (node_pc, regs)
+	-- Program in registers, cleared on reset
+	register_memory: if not COMPACT generate
+		Q_export <= regs(0);
+
+		last_instruction_address <= unsigned(regs(0)(PC_WIDTH - 1 downto 0));
+
+		memory_bus: process (clock, resetn)
+		begin
+			if resetn = '0' then
+				regs <= (others => (others => '0'));
+			elsif rising_edge(clock) then
+				if read = '1' then
+					memory_readdata <= regs(to_integer(unsigned(program_address)));
+				elsif program_write = '1' then
+					for i in 0 to 3 loop
+						if byteenable(i) = '1' then
+							regs(to_integer(unsigned(program_address)))(i * 8 + 7 downto i * 8) <= writedata(i * 8 + 7 downto i * 8);
+						end if;
+					end loop;
+				end if;
+			end if;
+		end process;
+
+		instruction_fetch: process (node_pc, regs)
+		begin
+			-- Get the current intstruction by reading address in program counter
+			if node_pc(0) = '0' then
+				current_instruction <= regs(to_integer(node_pc(PC_WIDTH - 1 downto 1)))(31 downto 16);
+			else
+				current_instruction <= regs(to_integer(node_pc(PC_WIDTH - 1 downto 1)) + 1)(15 downto 0);
+			end if;
+		end process;
+	end generate;
+
+	-- Program in LUT RAM with the same layout, one RAM per halfword.
+	-- The header is mirrored in a register since it's read every clock.
+	-- Each RAM has a single read port, shared by the instruction fetch and
+	-- the Avalon readback. The readback takes it only while the nodes are
+	-- stopped, so a read never changes the fetched instruction.
+	lutram_memory: if COMPACT generate
+		type halfwords is array (0 to 2 ** (PC_WIDTH - 1) - 1) of std_logic_vector(15 downto 0);
+		signal upper_words   : halfwords;
+		signal lower_words   : halfwords;
+		signal header        : std_logic_vector(15 downto 0) := (others => '0');
+		signal readback      : boolean;
+		signal upper_address : unsigned(PC_WIDTH - 2 downto 0);
+		signal lower_address : unsigned(PC_WIDTH - 2 downto 0);
+		signal upper_word    : std_logic_vector(15 downto 0);
+		signal lower_word    : std_logic_vector(15 downto 0);
+
+		attribute ramstyle : string;
+		attribute ramstyle of upper_words, lower_words : signal is "MLAB, no_rw_check";
 	begin
-		-- Get the current intstruction by reading address in program counter
-		if node_pc(0) = '0' then
-			current_instruction <= regs(to_integer(node_pc(3 downto 1)))(31 downto 16);
-		else
-			current_instruction <= regs(to_integer(node_pc(3 downto 1)) + 1)(15 downto 0);
-		end if;
-	end process;
+		Q_export <= x"0000" & header;
+
+		last_instruction_address <= unsigned(header(PC_WIDTH - 1 downto 0));
+
+		-- Even instructions sit in the upper, odd ones in the lower halfwords
+		readback <= read = '1' and tis_active = '0';
+		upper_address <= unsigned(program_address) when readback else node_pc(PC_WIDTH - 1 downto 1);
+		lower_address <= unsigned(program_address) when readback else node_pc(PC_WIDTH - 1 downto 1) + 1;
+		upper_word <= upper_words(to_integer(upper_address));
+		lower_word <= lower_words(to_integer(lower_address));
+
+		current_instruction <= upper_word when node_pc(0) = '0' else lower_word;
+
+		memory_bus: process (clock)
+		begin
+			if rising_edge(clock) then
+				if read = '1' then
+					memory_readdata <= (others => '0');
+					if readback then
+						memory_readdata <= upper_word & lower_word;
+					end if;
+				elsif program_write = '1' then
+					for i in 0 to 1 loop
+						if byteenable(i) = '1' then
+							lower_words(to_integer(unsigned(program_address)))(i * 8 + 7 downto i * 8) <= writedata(i * 8 + 7 downto i * 8);
+						end if;
+						if byteenable(i + 2) = '1' then
+							upper_words(to_integer(unsigned(program_address)))(i * 8 + 7 downto i * 8) <= writedata(i * 8 + 23 downto i * 8 + 16);
+						end if;
+					end loop;
+				end if;
+			end if;
+		end process;
+
+		header_register: process (clock, resetn)
+		begin
+			if resetn = '0' then
+				header <= (others => '0');
+			elsif rising_edge(clock) then
+				if read = '0' and program_write = '1' and unsigned(program_address) = 0 then
+					for i in 0 to 1 loop
+						if byteenable(i) = '1' then
+							header(i * 8 + 7 downto i * 8) <= writedata(i * 8 + 7 downto i * 8);
+						end if;
+					end loop;
+				end if;
+			end if;
+		end process;
+	end generate;
+
+	performance_counters: if COUNTERS generate
+		type stall_counters is array (0 to 3) of unsigned(15 downto 0);
+
+		signal cycles           : unsigned(31 downto 0) := (others => '0');
+		signal retired          : unsigned(31 downto 0) := (others => '0');
+		signal any_cycles       : unsigned(31 downto 0) := (others => '0');
+		-- Indexed by PortBit, like broadcast masks
+		signal read_stalls      : stall_counters        := (others => (others => '0'));
+		signal write_stalls     : stall_counters        := (others => (others => '0'));
+
+		function Saturate(count : unsigned(15 downto 0)) return unsigned is
+		begin
+			if count = x"FFFF" then
+				return count;
+			end if;
+			return count + 1;
+		end function;
+	begin
+		counters: process (clock, resetn)
+		begin
+			if resetn = '0' then
+				cycles <= (others => '0');
+				retired <= (others => '0');
+				any_cycles <= (others => '0');
+				read_stalls <= (others => (others => '0'));
+				write_stalls <= (others => (others => '0'));
+			elsif rising_edge(clock) then
+				if read = '1' then
+					case to_integer(unsigned(program_address)) is
+						when 0 => counter_readdata <= std_logic_vector(cycles);
+						when 1 => counter_readdata <= std_logic_vector(retired);
+						when 2 => counter_readdata <= std_logic_vector(read_stalls(1) & read_stalls(0));
+						when 3 => counter_readdata <= std_logic_vector(read_stalls(3) & read_stalls(2));
+						when 4 => counter_readdata <= std_logic_vector(write_stalls(1) & write_stalls(0));
+						when 5 => counter_readdata <= std_logic_vector(write_stalls(3) & write_stalls(2));
+						when 6 => counter_readdata <= std_logic_vector(any_cycles);
+						when others => counter_readdata <= (others => '0');
+					end case;
+				end if;
+
+				if write = '1' and window = COUNTER_WINDOW and to_integer(unsigned(program_address)) = 7 then
+					cycles <= (others => '0');
+					retired <= (others => '0');
+					any_cycles <= (others => '0');
+					read_stalls <= (others => (others => '0'));
+					write_stalls <= (others => (others => '0'));
+				elsif tis_active = '1' and node_halt = '0' then
+					if node_state = TIS_FINISH then
+						cycles <= cycles + 1;
+					end if;
+
+					if not HANDSHAKE and not PIPELINED then
+						-- Next instruction gets decoded once the previous one retired
+						if node_state = TIS_RUN and node_io_read = '0' and node_io_write = '0' then
+							retired <= retired + 1;
+						end if;
+
+						-- Port operations that don't complete in this cycle, a read
+						-- from DOWN or a write to UP can still complete in TIS_FINISH
+						if node_state = TIS_FINISH then
+							if node_io_read = '1' then
+								if o_down_active = '1' and i_down_active = '1' and (node_src_reg = DOWN or node_src_reg = ANY) then
+									null;
+								elsif node_src_reg = ANY then
+									any_cycles <= any_cycles + 1;
+								elsif IsPort(node_src_reg) then
+									read_stalls(PortBit(node_src_reg)) <= Saturate(read_stalls(PortBit(node_src_reg)));
+								end if;
+							elsif node_io_write = '1' then
+								if node_fanout /= "0000" then
+									for p in 0 to 3 loop
+										if node_fanout(p) = '1' and not (p = PortBit(UP) and o_up_active = '1' and i_up_active = '1') then
+											write_stalls(p) <= Saturate(write_stalls(p));
+										end if;
+									end loop;
+								elsif o_up_active = '1' and i_up_active = '1' and (node_dst_reg = UP or node_dst_reg = ANY) then
+									null;
+								elsif node_dst_reg = ANY then
+									any_cycles <= any_cycles + 1;
+								elsif IsPort(node_dst_reg) then
+									write_stalls(PortBit(node_dst_reg)) <= Saturate(write_stalls(PortBit(node_dst_reg)));
+								end if;
+							end if;
+						end if;
+					end if;
+				end if;
+			end if;
+		end process;
+	end generate;
+
+	runtime_status: if STATUS generate
+		type status_words is array (0 to 1) of std_logic_vector(31 downto 0);
+
+		signal snapshot : status_words := (others => (others => '0'));
+	begin
+		status: process (clock, resetn)
+		begin
+			if resetn = '0' then
+				snapshot <= (others => (others => '0'));
+				status_readdata <= (others => '0');
+			elsif rising_edge(clock) then
+				if read = '1' then
+					if unsigned(program_address) < 2 then
+						status_readdata <= snapshot(to_integer(unsigned(program_address)));
+					else
+						status_readdata <= (others => '0');
+					end if;
+				end if;
+
+				if status_capture = '1' or (write = '1' and window = STATUS_WINDOW) then
+					snapshot(0) <= std_logic_vector(to_signed(node_bak, 16) & to_signed(node_acc, 16));
+					snapshot(1) <= std_logic_vector(to_signed(node_io_value, 16)) & node_last & node_io_write & node_io_read &
+					               std_logic_vector(to_unsigned(tis_state'pos(node_state), 3)) & '0' &
+					               std_logic_vector(resize(node_pc, 7));
+				end if;
+			end if;
+		end process;
+	end generate;
+
+	hot_swap_control: if HOT_SWAP generate
+		signal boundary : boolean;
+	begin
+		-- Between instructions in TIS_RUN, or between cycles while the grid is stopped
+		boundary <= tis_active = '0' or node_state = TIS_RUN;
+
+		node_halt <= node_halted when not boundary else
+		             '1' when swap_enable = '0' and ((node_io_read = '0' and node_io_write = '0') or swap_force = '1') else
+		             '0';
+
+		node_clear <= '1' when write = '1' and window = SWAP_WINDOW and unsigned(program_address) = 0 and writedata(1) = '1' and node_halted = '1' else '0';
+		node_load <= '1' when write = '1' and window = SWAP_WINDOW and unsigned(program_address) /= 0 and node_halted = '1' else '0';
+
+		swap: process (clock, resetn)
+		begin
+			if resetn = '0' then
+				swap_enable <= '1';
+				swap_force <= '0';
+				node_halted <= '0';
+				swap_readdata <= (others => '0');
+			elsif rising_edge(clock) then
+				if read = '1' then
+					swap_readdata <= (others => '0');
+					case to_integer(unsigned(program_address)) is
+						when 0 =>
+							swap_readdata(0) <= swap_enable;
+							swap_readdata(1) <= node_halted;
+							swap_readdata(2) <= swap_force;
+							swap_readdata(3) <= node_io_read or node_io_write;
+						when 1 =>
+							swap_readdata <= std_logic_vector(to_signed(node_bak, 16) & to_signed(node_acc, 16));
+						when 2 =>
+							swap_readdata <= std_logic_vector(to_signed(node_io_value, 16)) & node_last & node_io_write & node_io_read &
+							                 std_logic_vector(to_unsigned(tis_state'pos(node_state), 3)) & '0' &
+							                 std_logic_vector(resize(node_pc, 7));
+						when 3 =>
+							swap_readdata(2 downto 0) <= node_src_reg;
+							swap_readdata(5 downto 3) <= node_dst_reg;
+							swap_readdata(11 downto 8) <= node_fanout;
+						when others => null;
+					end case;
+				end if;
+
+				if write = '1' and window = SWAP_WINDOW and unsigned(program_address) = 0 then
+					swap_enable <= writedata(0);
+					swap_force <= writedata(2);
+				end if;
+
+				node_halted <= node_halt;
+			end if;
+		end process;
+	end generate;
+
+	-- Phase of the round robin, unused in handshake mode
+	private_phase: if not COMPACT generate
+		sequencer: process (clock, resetn)
+		begin
+			if resetn = '0' then
+				node_state <= TIS_RUN;
+			elsif rising_edge(clock) then
+				if tis_active = '1' then
+					case node_state is
+						when TIS_RUN =>
+							node_state <= TIS_LEFT;
+						when TIS_LEFT =>
+							node_state <= TIS_RIGHT;
+						when TIS_RIGHT =>
+							node_state <= TIS_UP;
+						when TIS_UP =>
+							node_state <= TIS_DOWN;
+						when TIS_DOWN =>
+							node_state <= TIS_FINISH;
+						when TIS_FINISH =>
+							node_state <= TIS_RUN;
+					end case;
+				end if;
+			end if;
+		end process;
+	end generate;
+
+	shared_phase: if COMPACT generate
+		node_state <= TIS_LEFT when tis_phase(1) = '1' else
+		              TIS_RIGHT when tis_phase(2) = '1' else
+		              TIS_UP when tis_phase(3) = '1' else
+		              TIS_DOWN when tis_phase(4) = '1' else
+		              TIS_FINISH when tis_phase(5) = '1' else
+		              TIS_RUN;
+	end generate;
 
 	o_left  <= std_logic_vector(to_signed(node_io_value, o_left'length));
 	o_right <= std_logic_vector(to_signed(node_io_value, o_right'length));
 	o_up    <= std_logic_vector(to_signed(node_io_value, o_up'length));
 	o_down  <= std_logic_vector(to_signed(node_io_value, o_down'length));
 
-	processor: process (clock, resetn)
-	begin
-		if resetn = '0' then
-			node_state <= TIS_RUN;
-			node_acc <= 0;
-			node_bak <= 0;
-			node_pc <= (others => '0');
-			node_last <= NIL;
-			node_io_value <= 0;
-			node_src_reg <= NIL;
-			node_io_value <= 0;
-			node_dst_reg <= NIL;
-			node_state <= TIS_RUN;
-		elsif rising_edge(clock) then
-			if tis_active = '1' then
-				-- Capture ACC from previous ALU operation
-				case node_state is
-					when TIS_RUN =>
-						-- DEBUG
-						-- report "PC: " & to_string(to_integer(node_pc)) & " ACC: " & to_string(node_acc) severity note;
-						-- Only proceed without ongoing I/O operation
-						if (node_io_read = '0') and (node_io_write = '0') then
-							-- Decode Instruction
-							case current_instruction(15 downto 14) is
-								when "00" => -- ADD/SUB
-									node_io_read <= '0';
-									node_io_write <= '0';
+	-- Six clock round robin, ports are offered one direction per tis_state
+	round_robin: if not HANDSHAKE and not PIPELINED generate
+		o_left_ready  <= '0';
+		o_right_ready <= '0';
+		o_up_ready    <= '0';
+		o_down_ready  <= '0';
 
-									-- Avoids previous register from skipping a read on a port 
-									node_src_reg <= "111"; 
+		processor: process (clock, resetn)
+			-- Broadcast write in a phase: the port offered during the previous
+			-- phase is done once taken, then the port of this phase is offered
+			procedure Broadcast(
+					taken_port : std_logic_vector(2 downto 0);
+					taken      : std_logic;
+					offer_port : std_logic_vector(2 downto 0)
+				) is
+				variable pending : std_logic_vector(3 downto 0) := node_fanout;
+			begin
+				if taken_port /= NIL and taken = '1' then
+					pending(PortBit(taken_port)) := '0';
+				end if;
+				node_fanout <= pending;
+
+				if pending = "0000" then
+					-- WRITE success on every port!
+					node_io_write <= '0';
+				elsif offer_port /= NIL and pending(PortBit(offer_port)) = '1' then
+					case offer_port is
+						when LEFT => o_left_active <= '1';
+						when RIGHT => o_right_active <= '1';
+						when UP => o_up_active <= '1';
+						when DOWN => o_down_active <= '1';
+						when others =>
+					end case;
+				end if;
+			end procedure;
+		begin
+			if resetn = '0' then
+				node_acc <= 0;
+				node_bak <= 0;
+				node_pc <= (others => '0');
+				node_last <= NIL;
+				node_io_value <= 0;
+				node_src_reg <= NIL;
+				node_io_value <= 0;
+				node_dst_reg <= NIL;
+				node_fanout <= (others => '0');
+			elsif rising_edge(clock) then
+				if node_clear = '1' then
+					-- Start of a swapped in program
+					node_acc <= 0;
+					node_bak <= 0;
+					node_pc <= (others => '0');
+					node_last <= NIL;
+					node_io_value <= 0;
+					node_io_read <= '0';
+					node_io_write <= '0';
+					node_src_reg <= NIL;
+					node_dst_reg <= NIL;
+					node_fanout <= (others => '0');
+				elsif node_load = '1' then
+					-- Context of a switched in program
+					case to_integer(unsigned(program_address)) is
+						when 1 =>
+							node_acc <= TisValue(writedata(15 downto 0));
+							node_bak <= TisValue(writedata(31 downto 16));
+						when 2 =>
+							node_pc <= resize(unsigned(writedata(6 downto 0)), node_pc'length);
+							node_io_read <= writedata(11);
+							node_io_write <= writedata(12);
+							node_last <= writedata(15 downto 13);
+							node_io_value <= TisValue(writedata(31 downto 16));
+						when 3 =>
+							node_src_reg <= writedata(2 downto 0);
+							node_dst_reg <= writedata(5 downto 3);
+							node_fanout <= writedata(11 downto 8);
+						when others => null;
+					end case;
+				elsif tis_active = '1' and node_halt = '1' then
+					-- Withdraw the offers of the last cycle, neighbours block on the ports
+					o_left_active <= '0';
+					o_right_active <= '0';
+					o_up_active <= '0';
+					o_down_active <= '0';
+				elsif tis_active = '1' then
+					-- Capture ACC from previous ALU operation
+					case node_state is
+						when TIS_RUN =>
+							-- DEBUG
+							-- report "PC: " & to_string(to_integer(node_pc)) & " ACC: " & to_string(node_acc) severity note;
+							-- Only proceed without ongoing I/O operation
+							if (node_io_read = '0') and (node_io_write = '0') then
+								-- Decode Instruction
+								case current_instruction(15 downto 14) is
+									when "00" => -- ADD/SUB
+										node_io_read <= '0';
+										node_io_write <= '0';
+
+										-- Avoids previous register from skipping a read on a port 
+										node_src_reg <= "111"; 
+
+										if current_instruction(11) = '1' then
+											-- ADD or SUB with register
+											if current_instruction(2 downto 0) = NIL then
+												-- Do nothing for NIL
+												node_io_value <= 0;
+											elsif current_instruction(2 downto 0) = ACC then
+												node_io_value <= node_acc;
+											elsif current_instruction(2 downto 0) = LAST then
+												-- If LAST is NIL, node will read 0
+												if node_last = NIL then
+													node_io_value <= 0;
+												else
+													node_io_read <= '1';
+												end if;
+												node_src_reg <= node_last;
+											else
+												node_io_read <= '1';
+												node_src_reg <= current_instruction(2 downto 0);
+											end if;
+										else
+											-- ADD or SUB with immediate operand
+											if current_instruction(10) = '1' then
+												-- report "OPC: SUB " & to_string(unsigned(current_instruction(9 downto 0))) severity note;
+												node_io_value <= to_integer(unsigned(current_instruction(9 downto 0)));
+											else
+												-- report "OPC: ADD " & to_string(unsigned(current_instruction(9 downto 0))) severity note;
+												node_io_value <= to_integer(unsigned(current_instruction(9 downto 0)));
+											end if;
+										end if;
+									when "10" => -- MOV #<imm10>, <DST>
+										node_io_read <= '1';
+										node_io_write <= '1';
 
-									if current_instruction(11) = '1' then
-										-- ADD or SUB with register
+										node_src_reg <= NIL; -- Immediate operand in SRC
+										node_dst_reg <= current_instruction(13 downto 11);
+										node_io_value <= to_integer(signed(current_instruction(10 downto 0)));
+
+										-- <DST>
+										if current_instruction(13 downto 11) = LAST then
+											node_dst_reg <= node_last;
+										end if;
+									when "11" => -- MOV <SRC>, <DST>
+										node_io_read <= '1';
+										node_io_write <= '1';
+
+										node_src_reg <= current_instruction(2 downto 0);
+										node_dst_reg <= current_instruction(13 downto 11);
+
+										-- <DST> mask of a broadcast
+										if BROADCAST and current_instruction(10) = '1' then
+											node_fanout <= current_instruction(6 downto 3);
+										end if;
+
+										-- <SRC>
 										if current_instruction(2 downto 0) = NIL then
-											-- Do nothing for NIL
 											node_io_value <= 0;
 										elsif current_instruction(2 downto 0) = ACC then
 											node_io_value <= node_acc;
@@ -212,252 +834,312 @@ begin
 											-- If LAST is NIL, node will read 0
 											if node_last = NIL then
 												node_io_value <= 0;
-											else
-												node_io_read <= '1';
 											end if;
 											node_src_reg <= node_last;
-										else
-											node_io_read <= '1';
-											node_src_reg <= current_instruction(2 downto 0);
-										end if;
-									else
-										-- ADD or SUB with immediate operand
-										if current_instruction(10) = '1' then
-											-- report "OPC: SUB " & to_string(unsigned(current_instruction(9 downto 0))) severity note;
-											node_io_value <= to_integer(unsigned(current_instruction(9 downto 0)));
-										else
-											-- report "OPC: ADD " & to_string(unsigned(current_instruction(9 downto 0))) severity note;
-											node_io_value <= to_integer(unsigned(current_instruction(9 downto 0)));
 										end if;
-									end if;
-								when "10" => -- MOV #<imm10>, <DST>
-									node_io_read <= '1';
-									node_io_write <= '1';
-
-									node_src_reg <= NIL; -- Immediate operand in SRC
-									node_dst_reg <= current_instruction(13 downto 11);
-									node_io_value <= to_integer(signed(current_instruction(10 downto 0)));
 
-									-- <DST>
-									if current_instruction(13 downto 11) = LAST then
-										node_dst_reg <= node_last;
-									end if;
-								when "11" => -- MOV <SRC>, <DST>
-									node_io_read <= '1';
-									node_io_write <= '1';
-
-									node_src_reg <= current_instruction(2 downto 0);
-									node_dst_reg <= current_instruction(13 downto 11);
-
-									-- <SRC>
-									if current_instruction(2 downto 0) = NIL then
-										node_io_value <= 0;
-									elsif current_instruction(2 downto 0) = ACC then
-										node_io_value <= node_acc;
-									elsif current_instruction(2 downto 0) = LAST then
-										-- If LAST is NIL, node will read 0
-										if node_last = NIL then
-											node_io_value <= 0;
+										-- <DST>
+										if current_instruction(13 downto 11) = LAST then
+											node_dst_reg <= node_last;
 										end if;
-										node_src_reg <= node_last;
-									end if;
+									when others =>
+								end case;
+							end if; -- IO_NONE check
+						when TIS_LEFT => -- Read LEFT, Write RIGHT
+							-- Default
+							o_left_active <= '0';
+							o_right_active <= '0';
+							o_up_active <= '0';
+							o_down_active <= '0';
 
-									-- <DST>
-									if current_instruction(13 downto 11) = LAST then
-										node_dst_reg <= node_last;
-									end if;
-								when others =>
-							end case;
-						end if; -- IO_NONE check
-						node_state <= TIS_LEFT;
-					when TIS_LEFT => -- Read LEFT, Write RIGHT
-						-- Default
-						o_left_active <= '0';
-						o_right_active <= '0';
-						o_up_active <= '0';
-						o_down_active <= '0';
-
-						-- Signal willingness to write/read
-						if node_io_read = '1' then
-							if (node_src_reg = LEFT) or (node_src_reg = ANY) then
-								-- Try read on LEFT port
-								o_left_active <= '1';
-							end if;
-						elsif node_io_write = '1' then
-							if (node_dst_reg = RIGHT) or (node_dst_reg = ANY) then
-								-- Try write on RIGHT port
-								o_right_active <= '1';
+							-- Signal willingness to write/read
+							if node_io_read = '1' then
+								if (node_src_reg = LEFT) or (node_src_reg = ANY) then
+									-- Try read on LEFT port
+									o_left_active <= '1';
+								end if;
+							elsif node_io_write = '1' and node_fanout /= "0000" then
+								Broadcast(NIL, '0', RIGHT);
+							elsif node_io_write = '1' then
+								if (node_dst_reg = RIGHT) or (node_dst_reg = ANY) then
+									-- Try write on RIGHT port
+									o_right_active <= '1';
+								end if;
 							end if;
-						end if;
+						when TIS_RIGHT => -- Read RIGHT, Write LEFT
+							-- Default
+							o_left_active <= '0';
+							o_right_active <= '0';
+							o_up_active <= '0';
+							o_down_active <= '0';
 
-						node_state <= TIS_RIGHT;
-					when TIS_RIGHT => -- Read RIGHT, Write LEFT
-						-- Default
-						o_left_active <= '0';
-						o_right_active <= '0';
-						o_up_active <= '0';
-						o_down_active <= '0';
-
-						-- Signal willingness to write/read
-						if node_io_read = '1' then
-							-- Check whether previous read was successful
-							if (i_left_active = '1') and ((node_src_reg = LEFT) or (node_src_reg = ANY)) then
-								-- READ success!
-								node_io_value <= to_integer(signed(i_left));
-								node_io_read <= '0';
-								if node_src_reg = ANY then
-									node_last <= LEFT;
+							-- Signal willingness to write/read
+							if node_io_read = '1' then
+								-- Check whether previous read was successful
+								if (i_left_active = '1') and ((node_src_reg = LEFT) or (node_src_reg = ANY)) then
+									-- READ success!
+									node_io_value <= to_integer(signed(i_left));
+									node_io_read <= '0';
+									if node_src_reg = ANY then
+										node_last <= LEFT;
+									end if;
+								elsif (node_src_reg = RIGHT) or (node_src_reg = ANY) then
+									-- Try read on RIGHT port instead
+									o_right_active <= '1';
 								end if;
-							elsif (node_src_reg = RIGHT) or (node_src_reg = ANY) then
-								-- Try read on RIGHT port instead
-								o_right_active <= '1';
-							end if;
-						elsif node_io_write = '1' then
-							-- Check whether previous write was successful
-							if (i_right_active = '1') and ((node_dst_reg = RIGHT) or (node_dst_reg = ANY)) then
-								-- WRITE success!
-								node_io_write <= '0';
-								if node_dst_reg = ANY then
-									node_last <= RIGHT;
+							elsif node_io_write = '1' and node_fanout /= "0000" then
+								Broadcast(RIGHT, o_right_active and i_right_active, LEFT);
+							elsif node_io_write = '1' then
+								-- Check whether previous write was successful
+								if (i_right_active = '1') and ((node_dst_reg = RIGHT) or (node_dst_reg = ANY)) then
+									-- WRITE success!
+									node_io_write <= '0';
+									if node_dst_reg = ANY then
+										node_last <= RIGHT;
+									end if;
+								elsif (node_dst_reg = LEFT) or (node_dst_reg = ANY) then
+									-- Try write on LEFT port instead
+									o_left_active <= '1';
 								end if;
-							elsif (node_dst_reg = LEFT) or (node_dst_reg = ANY) then
-								-- Try write on LEFT port instead
-								o_left_active <= '1';
 							end if;
-						end if;
+						when TIS_UP => -- Read UP, Write DOWN
+							-- Default
+							o_left_active <= '0';
+							o_right_active <= '0';
+							o_up_active <= '0';
+							o_down_active <= '0';
 
-						node_state <= TIS_UP;
-					when TIS_UP => -- Read UP, Write DOWN
-						-- Default
-						o_left_active <= '0';
-						o_right_active <= '0';
-						o_up_active <= '0';
-						o_down_active <= '0';
-
-						-- Signal willingness to write/read
-						if node_io_read = '1' then
-							-- Check whether previous read was successful
-							if (i_right_active = '1') and ((node_src_reg = RIGHT) or (node_src_reg = ANY)) then
-								-- READ success!
-								node_io_value <= to_integer(signed(i_right));
-								node_io_read <= '0';
-								if node_src_reg = ANY then
-									node_last <= RIGHT;
+							-- Signal willingness to write/read
+							if node_io_read = '1' then
+								-- Check whether previous read was successful
+								if (i_right_active = '1') and ((node_src_reg = RIGHT) or (node_src_reg = ANY)) then
+									-- READ success!
+									node_io_value <= to_integer(signed(i_right));
+									node_io_read <= '0';
+									if node_src_reg = ANY then
+										node_last <= RIGHT;
+									end if;
+								elsif (node_src_reg = UP) or (node_src_reg = ANY) then
+									-- Try read on UP port instead
+									o_up_active <= '1';
 								end if;
-							elsif (node_src_reg = UP) or (node_src_reg = ANY) then
-								-- Try read on UP port instead
-								o_up_active <= '1';
-							end if;
-						elsif node_io_write = '1' then
-							-- Check whether previous write was successful
-							if (i_left_active = '1') and ((node_dst_reg = LEFT) or (node_dst_reg = ANY)) then
-								-- WRITE success!
-								node_io_write <= '0';
-								if node_dst_reg = ANY then
-									node_last <= LEFT;
+							elsif node_io_write = '1' and node_fanout /= "0000" then
+								Broadcast(LEFT, o_left_active and i_left_active, DOWN);
+							elsif node_io_write = '1' then
+								-- Check whether previous write was successful
+								if (i_left_active = '1') and ((node_dst_reg = LEFT) or (node_dst_reg = ANY)) then
+									-- WRITE success!
+									node_io_write <= '0';
+									if node_dst_reg = ANY then
+										node_last <= LEFT;
+									end if;
+								elsif (node_dst_reg = DOWN) or (node_dst_reg = ANY) then
+									-- Try write on DOWN port instead
+									o_down_active <= '1';
 								end if;
-							elsif (node_dst_reg = DOWN) or (node_dst_reg = ANY) then
-								-- Try write on DOWN port instead
-								o_down_active <= '1';
 							end if;
-						end if;
+						when TIS_DOWN => -- Read DOWN, Write UP
+							-- Default
+							o_left_active <= '0';
+							o_right_active <= '0';
+							o_up_active <= '0';
+							o_down_active <= '0';
 
-						node_state <= TIS_DOWN;
-					when TIS_DOWN => -- Read DOWN, Write UP
-						-- Default
-						o_left_active <= '0';
-						o_right_active <= '0';
-						o_up_active <= '0';
-						o_down_active <= '0';
-
-						-- Signal willingness to write/read
-						if node_io_read = '1' then
-							-- Check whether previous read was successful
-							if (i_up_active = '1') and ((node_src_reg = UP) or (node_src_reg = ANY)) then
-								-- READ success!
-								node_io_value <= to_integer(signed(i_up));
-								node_io_read <= '0';
-								if node_src_reg = ANY then
-									node_last <= UP;
+							-- Signal willingness to write/read
+							if node_io_read = '1' then
+								-- Check whether previous read was successful
+								if (i_up_active = '1') and ((node_src_reg = UP) or (node_src_reg = ANY)) then
+									-- READ success!
+									node_io_value <= to_integer(signed(i_up));
+									node_io_read <= '0';
+									if node_src_reg = ANY then
+										node_last <= UP;
+									end if;
+								elsif (node_src_reg = DOWN) or (node_src_reg = ANY) then
+									-- Try read on DOWN port instead
+									o_down_active <= '1';
 								end if;
-							elsif (node_src_reg = DOWN) or (node_src_reg = ANY) then
-								-- Try read on DOWN port instead
-								o_down_active <= '1';
-							end if;
-						elsif node_io_write = '1' then
-							-- Check whether previous write was successful
-							if (i_down_active = '1') and ((node_dst_reg = DOWN) or (node_dst_reg = ANY)) then
-								-- WRITE success!
-								node_io_write <= '0';
-								if node_dst_reg = ANY then
-									node_last <= DOWN;
+							elsif node_io_write = '1' and node_fanout /= "0000" then
+								Broadcast(DOWN, o_down_active and i_down_active, UP);
+							elsif node_io_write = '1' then
+								-- Check whether previous write was successful
+								if (i_down_active = '1') and ((node_dst_reg = DOWN) or (node_dst_reg = ANY)) then
+									-- WRITE success!
+									node_io_write <= '0';
+									if node_dst_reg = ANY then
+										node_last <= DOWN;
+									end if;
+								elsif (node_dst_reg = UP) or (node_dst_reg = ANY) then
+									-- Try write on UP port instead
+									o_up_active <= '1';
 								end if;
-							elsif (node_dst_reg = UP) or (node_dst_reg = ANY) then
-								-- Try write on UP port instead
-								o_up_active <= '1';
 							end if;
-						end if;
+						when TIS_FINISH =>
+
+							if node_io_read = '1' then
+								-- Mark read as done if <SRC> was ACC or NIL
+								-- This lets writes to those registers take 1 cycle
+								if node_src_reg = ACC or node_src_reg = NIL then
+									node_io_read <= '0';
+
+									-- Write to ACC or NIL
+									if node_dst_reg = ACC and node_io_write <= '1' then
+										node_io_write <= '0';
+										node_acc <= node_io_value;
+										IncrementPC(node_pc, last_instruction_address);
+									elsif node_dst_reg = NIL and node_io_write <= '1' then
+										node_io_write <= '0';
+										IncrementPC(node_pc, last_instruction_address);
+									end if;
+								end if;
 
-						node_state <= TIS_FINISH;
-					when TIS_FINISH =>
+								-- Check whether previous read/write was successful
+								if (i_down_active = '1') and ((node_src_reg = DOWN) or (node_src_reg = ANY)) then
+									-- READ success!
+									node_io_read <= '0';
+									if node_src_reg = ANY then
+										node_last <= DOWN;
+									end if;
 
-						if node_io_read = '1' then
-							-- Mark read as done if <SRC> was ACC or NIL
-							-- This lets writes to those registers take 1 cycle
-							if node_src_reg = ACC or node_src_reg = NIL then
-								node_io_read <= '0';
+									-- Write to ACC or NIL
+									if node_dst_reg = ACC and node_io_write = '1' then
+										node_io_write <= '0';
+										node_acc <= to_integer(signed(i_down));
+										IncrementPC(node_pc, last_instruction_address);
+									elsif node_dst_reg = NIL and node_io_write = '1' then
+										node_io_write <= '0';
+										IncrementPC(node_pc, last_instruction_address);
+									end if;
 
-								-- Write to ACC or NIL
-								if node_dst_reg = ACC and node_io_write <= '1' then
+									if current_instruction(15 downto 3) = "0110000000000" then -- JRO
+										if (to_integer(node_pc) + to_integer(signed(i_down))) > to_integer(last_instruction_address) then
+											-- Clamp to maximum address
+											node_pc <= last_instruction_address;
+										elsif (to_integer(node_pc) + to_integer(signed(i_down))) < 0 then
+											-- Clamp to minimum address
+											node_pc <= (others => '0');
+										else
+											-- Update address
+											node_pc <= to_unsigned(to_integer(node_pc) + to_integer(signed(i_down)), node_pc'length);
+										end if;
+									elsif IsJump(current_instruction) then -- JMP
+										-- Check JMP conditions
+										case current_instruction(8 downto 6) is
+											when JMP =>
+												-- Bounds check
+												SetPC(node_pc, last_instruction_address, jump_target);
+											when JEZ =>
+												-- Condition
+												if node_acc = 0 then
+													-- Bounds check
+													SetPC(node_pc, last_instruction_address, jump_target);
+												else
+													IncrementPC(node_pc, last_instruction_address);
+												end if;
+											when JNZ =>
+												-- Condition
+												if not (node_acc = 0) then
+													-- Bounds check
+													SetPC(node_pc, last_instruction_address, jump_target);
+												else
+													IncrementPC(node_pc, last_instruction_address);
+												end if;
+											when JGZ =>
+												-- Condition
+												if node_acc > 0 then
+													-- Bounds check
+													SetPC(node_pc, last_instruction_address, jump_target);
+												else
+													IncrementPC(node_pc, last_instruction_address);
+												end if;
+											when JLZ =>
+												-- Condition
+												if node_acc < 0 then
+													SetPC(node_pc, last_instruction_address, jump_target);
+												else
+													IncrementPC(node_pc, last_instruction_address);
+												end if;
+											when others =>
+											-- Do nothing
+										end case;
+									elsif current_instruction(15 downto 12) = "0000" then
+										if current_instruction(10) = '1' then
+											-- SUB
+											node_acc <= node_acc - to_integer(signed(i_down));
+											IncrementPC(node_pc, last_instruction_address);
+										else
+											-- ADD
+											node_acc <= node_acc + to_integer(signed(i_down));
+											IncrementPC(node_pc, last_instruction_address);
+										end if;
+									elsif current_instruction = x"4800" then
+										-- NEG
+										node_acc <= - node_acc;
+										IncrementPC(node_pc, last_instruction_address);
+									elsif current_instruction = x"4000" then
+										-- SAV
+										node_bak <= node_acc;
+										IncrementPC(node_pc, last_instruction_address);
+									elsif current_instruction = x"5000" then
+										-- SWP
+										node_bak <= node_acc;
+										node_acc <= node_bak;
+										IncrementPC(node_pc, last_instruction_address);
+									else
+										-- Increment PC for all other instructions
+										IncrementPC(node_pc, last_instruction_address);
+									end if;
+								end if;
+							elsif node_io_write = '1' and node_fanout /= "0000" then
+								Broadcast(UP, o_up_active and i_up_active, NIL);
+								-- UP was the last port
+								if o_up_active = '1' and i_up_active = '1' and node_fanout = "0001" then
+									IncrementPC(node_pc, last_instruction_address);
+								end if;
+							elsif node_io_write = '1' then
+								-- Write to ACC and NIL
+								if node_dst_reg = ACC then
 									node_io_write <= '0';
 									node_acc <= node_io_value;
 									IncrementPC(node_pc, last_instruction_address);
-								elsif node_dst_reg = NIL and node_io_write <= '1' then
+								elsif node_dst_reg = NIL then
 									node_io_write <= '0';
 									IncrementPC(node_pc, last_instruction_address);
 								end if;
-							end if;
-
-							-- Check whether previous read/write was successful
-							if (i_down_active = '1') and ((node_src_reg = DOWN) or (node_src_reg = ANY)) then
-								-- READ success!
-								node_io_read <= '0';
-								if node_src_reg = ANY then
-									node_last <= DOWN;
-								end if;
 
-								-- Write to ACC or NIL
-								if node_dst_reg = ACC and node_io_write = '1' then
-									node_io_write <= '0';
-									node_acc <= to_integer(signed(i_down));
-									IncrementPC(node_pc, last_instruction_address);
-								elsif node_dst_reg = NIL and node_io_write = '1' then
+								if (i_up_active = '1') and ((node_dst_reg = UP) or (node_dst_reg = ANY)) then
+									-- WRITE success!
 									node_io_write <= '0';
+									if node_src_reg = ANY then
+										node_last <= UP;
+									end if;
+									-- Increment PC for all other instructions
 									IncrementPC(node_pc, last_instruction_address);
 								end if;
-
+							else
+								-- Update program counter
 								if current_instruction(15 downto 3) = "0110000000000" then -- JRO
-									if (to_integer(node_pc) + to_integer(signed(i_down))) > to_integer(last_instruction_address) then
+									if (to_integer(node_pc) + node_io_value) > to_integer(last_instruction_address) then
 										-- Clamp to maximum address
 										node_pc <= last_instruction_address;
-									elsif (to_integer(node_pc) + to_integer(signed(i_down))) < 0 then
+									elsif (to_integer(node_pc) + node_io_value) < 0 then
 										-- Clamp to minimum address
 										node_pc <= (others => '0');
 									else
 										-- Update address
-										node_pc <= to_unsigned(to_integer(node_pc) + to_integer(signed(i_down)), node_pc'length);
+										node_pc <= to_unsigned(to_integer(node_pc) + node_io_value, node_pc'length);
 									end if;
-								elsif current_instruction(15 downto 9) = "0111000" then -- JMP
+								elsif IsJump(current_instruction) then -- JMP
 									-- Check JMP conditions
 									case current_instruction(8 downto 6) is
 										when JMP =>
 											-- Bounds check
-											SetPC(node_pc, last_instruction_address, current_instruction(3 downto 0));
+											SetPC(node_pc, last_instruction_address, jump_target);
 										when JEZ =>
 											-- Condition
 											if node_acc = 0 then
 												-- Bounds check
-												SetPC(node_pc, last_instruction_address, current_instruction(3 downto 0));
+												SetPC(node_pc, last_instruction_address, jump_target);
 											else
 												IncrementPC(node_pc, last_instruction_address);
 											end if;
@@ -465,7 +1147,7 @@ begin
 											-- Condition
 											if not (node_acc = 0) then
 												-- Bounds check
-												SetPC(node_pc, last_instruction_address, current_instruction(3 downto 0));
+												SetPC(node_pc, last_instruction_address, jump_target);
 											else
 												IncrementPC(node_pc, last_instruction_address);
 											end if;
@@ -473,14 +1155,14 @@ begin
 											-- Condition
 											if node_acc > 0 then
 												-- Bounds check
-												SetPC(node_pc, last_instruction_address, current_instruction(3 downto 0));
+												SetPC(node_pc, last_instruction_address, jump_target);
 											else
 												IncrementPC(node_pc, last_instruction_address);
 											end if;
 										when JLZ =>
 											-- Condition
 											if node_acc < 0 then
-												SetPC(node_pc, last_instruction_address, current_instruction(3 downto 0));
+												SetPC(node_pc, last_instruction_address, jump_target);
 											else
 												IncrementPC(node_pc, last_instruction_address);
 											end if;
@@ -490,11 +1172,11 @@ begin
 								elsif current_instruction(15 downto 12) = "0000" then
 									if current_instruction(10) = '1' then
 										-- SUB
-										node_acc <= node_acc - to_integer(signed(i_down));
+										node_acc <= node_acc - node_io_value;
 										IncrementPC(node_pc, last_instruction_address);
 									else
 										-- ADD
-										node_acc <= node_acc + to_integer(signed(i_down));
+										node_acc <= node_acc + node_io_value;
 										IncrementPC(node_pc, last_instruction_address);
 									end if;
 								elsif current_instruction = x"4800" then
@@ -515,114 +1197,461 @@ begin
 									IncrementPC(node_pc, last_instruction_address);
 								end if;
 							end if;
-						elsif node_io_write = '1' then
-							-- Write to ACC and NIL
-							if node_dst_reg = ACC then
-								node_io_write <= '0';
-								node_acc <= node_io_value;
-								IncrementPC(node_pc, last_instruction_address);
-							elsif node_dst_reg = NIL then
-								node_io_write <= '0';
-								IncrementPC(node_pc, last_instruction_address);
+
+						-- TODO: Set node_src
+					end case;
+				end if; -- active
+			end if; -- clk/reset
+		end process;
+	end generate;
+
+	-- Six clock round robin with instructions that don't touch a port retired
+	-- in any clock of the cycle. Port operations are decoded in TIS_RUN, their
+	-- value is ready before TIS_LEFT and they retire on the clock the transfer
+	-- is seen, so the next instructions can use the rest of the cycle.
+	pipelined: if PIPELINED and not HANDSHAKE generate
+		signal src_port   : std_logic_vector(2 downto 0);
+		signal uses_port  : boolean;
+		-- Port offered during the previous clock
+		signal node_offer : std_logic_vector(2 downto 0) := NIL;
+	begin
+		o_left_ready  <= '0';
+		o_right_ready <= '0';
+		o_up_ready    <= '0';
+		o_down_ready  <= '0';
+
+		src_port <= SourcePort(current_instruction, node_last);
+		uses_port <= src_port /= NIL or DestinationPort(current_instruction, node_last) /= NIL;
+
+		processor: process (clock, resetn)
+			variable reading, writing : std_logic;
+			variable retired          : boolean;
+			variable active           : std_logic;
+			variable value            : integer range - 999 to 999;
+			variable dst              : std_logic_vector(2 downto 0);
+
+			-- Completes the instruction at PC with its source operand
+			procedure Execute(operand : integer) is
+			begin
+				case current_instruction(15 downto 14) is
+					when "00" => -- ADD/SUB
+						if current_instruction(10) = '1' then
+							node_acc <= node_acc - operand;
+						else
+							node_acc <= node_acc + operand;
+						end if;
+						IncrementPC(node_pc, last_instruction_address);
+					when "10" | "11" => -- MOV
+						dst := current_instruction(13 downto 11);
+						if dst = LAST then
+							dst := node_last;
+						end if;
+
+						if dst = ACC then
+							node_acc <= operand;
+							IncrementPC(node_pc, last_instruction_address);
+						elsif dst = NIL then
+							IncrementPC(node_pc, last_instruction_address);
+						else
+							-- Write during the following phases
+							node_io_value <= operand;
+							node_dst_reg <= dst;
+							writing := '1';
+						end if;
+					when others =>
+						if current_instruction(15 downto 3) = "0110000000000" then -- JRO
+							if (to_integer(node_pc) + operand) > to_integer(last_instruction_address) then
+								-- Clamp to maximum address
+								node_pc <= last_instruction_address;
+							elsif (to_integer(node_pc) + operand) < 0 then
+								-- Clamp to minimum address
+								node_pc <= (others => '0');
+							else
+								-- Update address
+								node_pc <= to_unsigned(to_integer(node_pc) + operand, node_pc'length);
 							end if;
+						elsif IsJump(current_instruction) then -- JMP
+							-- Check JMP conditions
+							case current_instruction(8 downto 6) is
+								when JMP =>
+									SetPC(node_pc, last_instruction_address, jump_target);
+								when JEZ =>
+									if node_acc = 0 then
+										SetPC(node_pc, last_instruction_address, jump_target);
+									else
+										IncrementPC(node_pc, last_instruction_address);
+									end if;
+								when JNZ =>
+									if not (node_acc = 0) then
+										SetPC(node_pc, last_instruction_address, jump_target);
+									else
+										IncrementPC(node_pc, last_instruction_address);
+									end if;
+								when JGZ =>
+									if node_acc > 0 then
+										SetPC(node_pc, last_instruction_address, jump_target);
+									else
+										IncrementPC(node_pc, last_instruction_address);
+									end if;
+								when JLZ =>
+									if node_acc < 0 then
+										SetPC(node_pc, last_instruction_address, jump_target);
+									else
+										IncrementPC(node_pc, last_instruction_address);
+									end if;
+								when others =>
+								-- Do nothing
+							end case;
+						elsif current_instruction = x"4800" then
+							-- NEG
+							node_acc <= - node_acc;
+							IncrementPC(node_pc, last_instruction_address);
+						elsif current_instruction = x"4000" then
+							-- SAV
+							node_bak <= node_acc;
+							IncrementPC(node_pc, last_instruction_address);
+						elsif current_instruction = x"5000" then
+							-- SWP
+							node_bak <= node_acc;
+							node_acc <= node_bak;
+							IncrementPC(node_pc, last_instruction_address);
+						else
+							IncrementPC(node_pc, last_instruction_address);
+						end if;
+				end case;
+			end procedure;
 
-							if (i_up_active = '1') and ((node_dst_reg = UP) or (node_dst_reg = ANY)) then
-								-- WRITE success!
-								node_io_write <= '0';
-								if node_src_reg = ANY then
-									node_last <= UP;
-								end if;
-								-- Increment PC for all other instructions
-								IncrementPC(node_pc, last_instruction_address);
+			-- Offers a port for this phase
+			procedure Offer(port_reg : std_logic_vector(2 downto 0)) is
+			begin
+				case port_reg is
+					when LEFT => o_left_active <= '1';
+					when RIGHT => o_right_active <= '1';
+					when UP => o_up_active <= '1';
+					when DOWN => o_down_active <= '1';
+					when others =>
+				end case;
+				node_offer <= port_reg;
+			end procedure;
+		begin
+			if resetn = '0' then
+				node_acc <= 0;
+				node_bak <= 0;
+				node_pc <= (others => '0');
+				node_last <= NIL;
+				node_io_value <= 0;
+				node_io_read <= '0';
+				node_io_write <= '0';
+				node_src_reg <= NIL;
+				node_dst_reg <= NIL;
+				node_offer <= NIL;
+			elsif rising_edge(clock) then
+				if tis_active = '1' then
+					reading := node_io_read;
+					writing := node_io_write;
+					retired := false;
+
+					-- Default
+					o_left_active <= '0';
+					o_right_active <= '0';
+					o_up_active <= '0';
+					o_down_active <= '0';
+					node_offer <= NIL;
+
+					-- Check whether the previous offer was taken
+					case node_offer is
+						when LEFT =>
+							active := i_left_active;
+							value := to_integer(signed(i_left));
+						when RIGHT =>
+							active := i_right_active;
+							value := to_integer(signed(i_right));
+						when UP =>
+							active := i_up_active;
+							value := to_integer(signed(i_up));
+						when DOWN =>
+							active := i_down_active;
+							value := to_integer(signed(i_down));
+						when others =>
+							active := '0';
+							value := 0;
+					end case;
+
+					if active = '1' then
+						if reading = '1' then
+							-- READ success!
+							reading := '0';
+							if node_src_reg = ANY then
+								node_last <= node_offer;
 							end if;
+							Execute(value);
+							retired := writing = '0';
 						else
-							-- Update program counter
-							if current_instruction(15 downto 3) = "0110000000000" then -- JRO
-								if (to_integer(node_pc) + node_io_value) > to_integer(last_instruction_address) then
-									-- Clamp to maximum address
-									node_pc <= last_instruction_address;
-								elsif (to_integer(node_pc) + node_io_value) < 0 then
-									-- Clamp to minimum address
-									node_pc <= (others => '0');
-								else
-									-- Update address
-									node_pc <= to_unsigned(to_integer(node_pc) + node_io_value, node_pc'length);
+							-- WRITE success!
+							writing := '0';
+							if node_dst_reg = ANY then
+								node_last <= node_offer;
+							end if;
+							IncrementPC(node_pc, last_instruction_address);
+							retired := true;
+						end if;
+					end if;
+
+					case node_state is
+						when TIS_RUN =>
+						-- Port operations start below
+						when TIS_LEFT => -- Read LEFT, Write RIGHT
+							if reading = '1' and (node_src_reg = LEFT or node_src_reg = ANY) then
+								Offer(LEFT);
+							elsif writing = '1' and (node_dst_reg = RIGHT or node_dst_reg = ANY) then
+								Offer(RIGHT);
+							end if;
+						when TIS_RIGHT => -- Read RIGHT, Write LEFT
+							if reading = '1' and (node_src_reg = RIGHT or node_src_reg = ANY) then
+								Offer(RIGHT);
+							elsif writing = '1' and (node_dst_reg = LEFT or node_dst_reg = ANY) then
+								Offer(LEFT);
+							end if;
+						when TIS_UP => -- Read UP, Write DOWN
+							if reading = '1' and (node_src_reg = UP or node_src_reg = ANY) then
+								Offer(UP);
+							elsif writing = '1' and (node_dst_reg = DOWN or node_dst_reg = ANY) then
+								Offer(DOWN);
+							end if;
+						when TIS_DOWN => -- Read DOWN, Write UP
+							if reading = '1' and (node_src_reg = DOWN or node_src_reg = ANY) then
+								Offer(DOWN);
+							elsif writing = '1' and (node_dst_reg = UP or node_dst_reg = ANY) then
+								Offer(UP);
+							end if;
+						when TIS_FINISH =>
+						-- Do nothing
+					end case;
+
+					-- Start the instruction at PC once the previous one retired
+					if reading = '0' and writing = '0' and not retired then
+						if not uses_port then
+							-- Operand of an instruction without port
+							if current_instruction(15 downto 14) = "10" then
+								value := to_integer(signed(current_instruction(10 downto 0)));
+							elsif current_instruction(15 downto 14) = "00" and current_instruction(11) = '0' then
+								value := to_integer(unsigned(current_instruction(9 downto 0)));
+							elsif current_instruction(2 downto 0) = ACC then
+								value := node_acc;
+							else
+								value := 0;
+							end if;
+							Execute(value);
+						elsif node_state = TIS_RUN then
+							-- Port operations wait for TIS_RUN to keep the ANY order
+							if src_port /= NIL then
+								reading := '1';
+								node_src_reg <= src_port;
+								if current_instruction(15 downto 14) = "11" then
+									writing := '1';
 								end if;
-							elsif current_instruction(15 downto 9) = "0111000" then -- JMP
-								-- Check JMP conditions
-								case current_instruction(8 downto 6) is
-									when JMP =>
-										-- Bounds check
-										SetPC(node_pc, last_instruction_address, current_instruction(3 downto 0));
-									when JEZ =>
-										-- Condition
-										if node_acc = 0 then
-											-- Bounds check
-											SetPC(node_pc, last_instruction_address, current_instruction(3 downto 0));
-										else
-											IncrementPC(node_pc, last_instruction_address);
-										end if;
-									when JNZ =>
-										-- Condition
-										if not (node_acc = 0) then
-											-- Bounds check
-											SetPC(node_pc, last_instruction_address, current_instruction(3 downto 0));
-										else
-											IncrementPC(node_pc, last_instruction_address);
-										end if;
-									when JGZ =>
-										-- Condition
-										if node_acc > 0 then
-											-- Bounds check
-											SetPC(node_pc, last_instruction_address, current_instruction(3 downto 0));
-										else
-											IncrementPC(node_pc, last_instruction_address);
-										end if;
-									when JLZ =>
-										-- Condition
-										if node_acc < 0 then
-											SetPC(node_pc, last_instruction_address, current_instruction(3 downto 0));
-										else
-											IncrementPC(node_pc, last_instruction_address);
-										end if;
-									when others =>
-									-- Do nothing
-								end case;
-							elsif current_instruction(15 downto 12) = "0000" then
-								if current_instruction(10) = '1' then
-									-- SUB
-									node_acc <= node_acc - node_io_value;
-									IncrementPC(node_pc, last_instruction_address);
+								node_dst_reg <= DestinationPort(current_instruction, node_last);
+							else
+								-- MOV <ACC/NIL/imm>, <port>, value is ready for TIS_LEFT
+								if current_instruction(15 downto 14) = "10" then
+									node_io_value <= to_integer(signed(current_instruction(10 downto 0)));
+								elsif current_instruction(2 downto 0) = ACC then
+									node_io_value <= node_acc;
 								else
-									-- ADD
-									node_acc <= node_acc + node_io_value;
-									IncrementPC(node_pc, last_instruction_address);
+									node_io_value <= 0;
 								end if;
-							elsif current_instruction = x"4800" then
-								-- NEG
-								node_acc <= - node_acc;
-								IncrementPC(node_pc, last_instruction_address);
-							elsif current_instruction = x"4000" then
-								-- SAV
-								node_bak <= node_acc;
-								IncrementPC(node_pc, last_instruction_address);
-							elsif current_instruction = x"5000" then
-								-- SWP
-								node_bak <= node_acc;
-								node_acc <= node_bak;
-								IncrementPC(node_pc, last_instruction_address);
-							else
-								-- Increment PC for all other instructions
-								IncrementPC(node_pc, last_instruction_address);
+								node_dst_reg <= DestinationPort(current_instruction, node_last);
+								writing := '1';
 							end if;
 						end if;
+					end if;
 
-						node_state <= TIS_RUN;
+					node_io_read <= reading;
+					node_io_write <= writing;
+				end if; -- active
+			end if; -- clk/reset
+		end process;
+	end generate;
 
-					-- TODO: Set node_src
-				end case;
-			end if; -- active
-		end if; -- clk/reset
-	end process;
+	-- Valid/ready handshake on all ports at once. Offers only depend on
+	-- registers, so both sides of a link see the same valid and ready and
+	-- agree on the clock edge of each transfer. ANY offers a single port per
+	-- clock from a slot counter that every node resets at the same time,
+	-- which keeps the port priority and makes two ANY nodes meet.
+	handshake: if HANDSHAKE generate
+		signal node_slot   : unsigned(1 downto 0)         := (others => '0');
+		signal src_port    : std_logic_vector(2 downto 0);
+		signal read_port   : std_logic_vector(2 downto 0);
+		signal write_port  : std_logic_vector(2 downto 0);
+		signal read_valid  : std_logic;
+		signal read_value  : std_logic_vector(10 downto 0);
+		signal write_ready : std_logic;
+	begin
+		src_port <= SourcePort(current_instruction, node_last);
+
+		read_port <= ScanPort(src_port, node_slot, false) when tis_active = '1' and node_io_write = '0' else NIL;
+		write_port <= ScanPort(node_dst_reg, node_slot, true) when tis_active = '1' and node_io_write = '1' else NIL;
+
+		o_left_ready  <= '1' when read_port = LEFT else '0';
+		o_right_ready <= '1' when read_port = RIGHT else '0';
+		o_up_ready    <= '1' when read_port = UP else '0';
+		o_down_ready  <= '1' when read_port = DOWN else '0';
+
+		o_left_active  <= '1' when write_port = LEFT else '0';
+		o_right_active <= '1' when write_port = RIGHT else '0';
+		o_up_active    <= '1' when write_port = UP else '0';
+		o_down_active  <= '1' when write_port = DOWN else '0';
+
+		read_valid <= i_left_active when read_port = LEFT else
+		              i_right_active when read_port = RIGHT else
+		              i_up_active when read_port = UP else
+		              i_down_active when read_port = DOWN else
+		              '0';
+
+		read_value <= i_left when read_port = LEFT else
+		              i_right when read_port = RIGHT else
+		              i_up when read_port = UP else
+		              i_down;
+
+		write_ready <= i_left_ready when write_port = LEFT else
+		               i_right_ready when write_port = RIGHT else
+		               i_up_ready when write_port = UP else
+		               i_down_ready when write_port = DOWN else
+		               '0';
+
+		processor: process (clock, resetn)
+			variable value : integer range - 999 to 999;
+			variable dst   : std_logic_vector(2 downto 0);
+		begin
+			if resetn = '0' then
+				node_slot <= (others => '0');
+				node_acc <= 0;
+				node_bak <= 0;
+				node_pc <= (others => '0');
+				node_last <= NIL;
+				node_io_value <= 0;
+				node_io_write <= '0';
+				node_dst_reg <= NIL;
+			elsif rising_edge(clock) then
+				if tis_active = '1' then
+					node_slot <= node_slot + 1;
+
+					if node_io_write = '1' then
+						-- Value of a MOV waits for the neighbour to be ready
+						if write_ready = '1' then
+							node_io_write <= '0';
+							if node_dst_reg = ANY then
+								node_last <= write_port;
+							end if;
+							IncrementPC(node_pc, last_instruction_address);
+						end if;
+					elsif read_port = NIL or read_valid = '1' then
+						-- Source operand
+						if read_port /= NIL then
+							value := to_integer(signed(read_value));
+							if src_port = ANY then
+								node_last <= read_port;
+							end if;
+						elsif current_instruction(15 downto 14) = "10" then
+							value := to_integer(signed(current_instruction(10 downto 0)));
+						elsif current_instruction(15 downto 14) = "00" and current_instruction(11) = '0' then
+							value := to_integer(unsigned(current_instruction(9 downto 0)));
+						elsif current_instruction(2 downto 0) = ACC then
+							value := node_acc;
+						else
+							value := 0;
+						end if;
+
+						case current_instruction(15 downto 14) is
+							when "00" => -- ADD/SUB
+								if current_instruction(10) = '1' then
+									node_acc <= node_acc - value;
+								else
+									node_acc <= node_acc + value;
+								end if;
+								IncrementPC(node_pc, last_instruction_address);
+							when "10" | "11" => -- MOV
+								dst := current_instruction(13 downto 11);
+								if dst = LAST then
+									dst := node_last;
+								end if;
+
+								if dst = ACC then
+									node_acc <= value;
+									IncrementPC(node_pc, last_instruction_address);
+								elsif dst = NIL then
+									IncrementPC(node_pc, last_instruction_address);
+								else
+									-- Offer the value from the next clock on
+									node_io_value <= value;
+									node_dst_reg <= dst;
+									node_io_write <= '1';
+								end if;
+							when others =>
+								if current_instruction(15 downto 3) = "0110000000000" then -- JRO
+									if (to_integer(node_pc) + value) > to_integer(last_instruction_address) then
+										-- Clamp to maximum address
+										node_pc <= last_instruction_address;
+									elsif (to_integer(node_pc) + value) < 0 then
+										-- Clamp to minimum address
+										node_pc <= (others => '0');
+									else
+										-- Update address
+										node_pc <= to_unsigned(to_integer(node_pc) + value, node_pc'length);
+									end if;
+								elsif IsJump(current_instruction) then -- JMP
+									-- Check JMP conditions
+									case current_instruction(8 downto 6) is
+										when JMP =>
+											SetPC(node_pc, last_instruction_address, jump_target);
+										when JEZ =>
+											if node_acc = 0 then
+												SetPC(node_pc, last_instruction_address, jump_target);
+											else
+												IncrementPC(node_pc, last_instruction_address);
+											end if;
+										when JNZ =>
+											if not (node_acc = 0) then
+												SetPC(node_pc, last_instruction_address, jump_target);
+											else
+												IncrementPC(node_pc, last_instruction_address);
+											end if;
+										when JGZ =>
+											if node_acc > 0 then
+												SetPC(node_pc, last_instruction_address, jump_target);
+											else
+												IncrementPC(node_pc, last_instruction_address);
+											end if;
+										when JLZ =>
+											if node_acc < 0 then
+												SetPC(node_pc, last_instruction_address, jump_target);
+											else
+												IncrementPC(node_pc, last_instruction_address);
+											end if;
+										when others =>
+										-- Do nothing
+									end case;
+								elsif current_instruction = x"4800" then
+									-- NEG
+									node_acc <= - node_acc;
+									IncrementPC(node_pc, last_instruction_address);
+								elsif current_instruction = x"4000" then
+									-- SAV
+									node_bak <= node_acc;
+									IncrementPC(node_pc, last_instruction_address);
+								elsif current_instruction = x"5000" then
+									-- SWP
+									node_bak <= node_acc;
+									node_acc <= node_bak;
+									IncrementPC(node_pc, last_instruction_address);
+								else
+									IncrementPC(node_pc, last_instruction_address);
+								end if;
+						end case;
+					end if;
+				end if; -- active
+			end if; -- clk/reset
+		end process;
+	end generate;
 
 end architecture;
@@ -0,0 +1,180 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_execution_node_broadcast_tb is
+end entity;
+
+architecture rtl of tis_execution_node_broadcast_tb is
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Full TIS I/O Cycle
+	procedure TisPulse(signal clk : inout std_logic) is
+	begin
+		-- Each cycle needs 6 rising edges
+		for i in 1 to 6 loop
+			wait for 1 ns;
+			clk <= '0';
+			wait for 1 ns;
+			clk <= '1';
+		end loop;
+
+		wait for 1 ns;
+	end procedure;
+
+	-- Avalon slave signals
+	signal clock_tb                         : std_logic;
+	signal resetn_tb                        : std_logic;
+	signal read_tb, write_tb, chipselect_tb : std_logic;
+	signal address_tb                       : std_logic_vector(2 downto 0);
+	signal readdata_tb                      : std_logic_vector(31 downto 0);
+	signal writedata_tb                     : std_logic_vector(31 downto 0);
+	signal byteenable_tb                    : std_logic_vector(3 downto 0);
+	signal Q_export_tb                      : std_logic_vector(31 downto 0);
+
+	-- TIS signals
+	signal tis_active_tb : std_logic;
+	-- Left conduit
+	signal i_left_tb        : std_logic_vector(10 downto 0);
+	signal i_left_active_tb : std_logic := '0';
+	signal o_left_tb        : std_logic_vector(10 downto 0);
+	signal o_left_active_tb : std_logic;
+	-- Right conduit
+	signal i_right_tb        : std_logic_vector(10 downto 0);
+	signal i_right_active_tb : std_logic := '0';
+	signal o_right_tb        : std_logic_vector(10 downto 0);
+	signal o_right_active_tb : std_logic;
+	-- Up conduit
+	signal i_up_tb        : std_logic_vector(10 downto 0);
+	signal i_up_active_tb : std_logic := '0';
+	signal o_up_tb        : std_logic_vector(10 downto 0);
+	signal o_up_active_tb : std_logic;
+	-- Down conduit
+	signal i_down_tb        : std_logic_vector(10 downto 0);
+	signal i_down_active_tb : std_logic := '0';
+	signal o_down_tb        : std_logic_vector(10 downto 0);
+	signal o_down_active_tb : std_logic;
+	signal acc_tb           : std_logic_vector(10 downto 0);
+	signal bak_tb           : std_logic_vector(10 downto 0);
+	signal pc_tb            : unsigned(3 downto 0);
+begin
+	-- Port map
+	node: entity work.tis_execution_node
+		generic map (
+			BROADCAST => true
+		)
+		port map (
+			clock          => clock_tb,
+			resetn         => resetn_tb,
+			read           => read_tb,
+			write          => write_tb,
+			address        => address_tb,
+			readdata       => readdata_tb,
+			writedata      => writedata_tb,
+			byteenable     => byteenable_tb,
+			Q_export       => Q_export_tb,
+			-- TIS signals
+			tis_active     => tis_active_tb,
+			i_left         => i_left_tb,
+			i_left_active  => i_left_active_tb,
+			o_left         => o_left_tb,
+			o_left_active  => o_left_active_tb,
+			i_right        => i_right_tb,
+			i_right_active => i_right_active_tb,
+			o_right        => o_right_tb,
+			o_right_active => o_right_active_tb,
+			i_up           => i_up_tb,
+			i_up_active    => i_up_active_tb,
+			o_up           => o_up_tb,
+			o_up_active    => o_up_active_tb,
+			i_down         => i_down_tb,
+			i_down_active  => i_down_active_tb,
+			o_down         => o_down_tb,
+			o_down_active  => o_down_active_tb,
+			debug_acc      => acc_tb,
+			debug_bak      => bak_tb,
+			debug_pc       => pc_tb
+		);
+
+	process
+	begin
+		-- Initialize signals
+		clock_tb <= '0';
+		resetn_tb <= '0';
+		byteenable_tb <= (others => '1');
+		read_tb <= '0';
+		write_tb <= '0';
+		writedata_tb <= (others => '0');
+		tis_active_tb <= '0';
+		ClockPulse(clock_tb);
+		resetn_tb <= '1';
+		ClockPulse(clock_tb);
+
+		-- Node Header (15 downto 0), last instruction is 2
+		-- 0 MOV 7, ACC (31 downto 16)
+		write_tb <= '1';
+		address_tb <= std_logic_vector(to_unsigned(0, address_tb'length));
+		writedata_tb <= x"8807" & x"0002";
+		ClockPulse(clock_tb);
+
+		-- 1 MOV ACC, RIGHT+DOWN+UP (15 downto 0)
+		-- 2 ADD 1 (31 downto 16)
+		address_tb <= std_logic_vector(to_unsigned(1, address_tb'length));
+		writedata_tb <= x"0001" & x"F459";
+		ClockPulse(clock_tb);
+		write_tb <= '0';
+
+		-- Every neighbour is reading from this node
+		i_right_active_tb <= '1';
+		i_down_active_tb <= '1';
+		i_up_active_tb <= '1';
+
+		tis_active_tb <= '1';
+		TisPulse(clock_tb); -- MOV 7, ACC
+		assert acc_tb = std_logic_vector(to_signed(7, acc_tb'length)) report "MOV 7, ACC: Expecting ACC = 7, got " & to_string(acc_tb);
+		assert pc_tb = 1 report "MOV 7, ACC: Expecting PC = 1, got " & to_string(to_integer(pc_tb));
+
+		-- Source fetch takes a cycle, same as MOV ACC, <port>
+		TisPulse(clock_tb);
+		assert pc_tb = 1 report "MOV ACC, RIGHT+DOWN+UP: Expecting PC = 1 after fetch, got " & to_string(to_integer(pc_tb));
+
+		-- All three ports take the value in the same cycle
+		TisPulse(clock_tb);
+		assert pc_tb = 2 report "MOV ACC, RIGHT+DOWN+UP: Expecting PC = 2, got " & to_string(to_integer(pc_tb));
+		assert o_up_tb = std_logic_vector(to_signed(7, o_up_tb'length)) report "MOV ACC, RIGHT+DOWN+UP: Expecting 7 on UP, got " & to_string(o_up_tb);
+
+		TisPulse(clock_tb); -- ADD 1
+		assert acc_tb = std_logic_vector(to_signed(8, acc_tb'length)) report "ADD 1: Expecting ACC = 8, got " & to_string(acc_tb);
+		assert pc_tb = 0 report "ADD 1: Expecting PC = 0, got " & to_string(to_integer(pc_tb));
+
+		-- UP neighbour stops reading, RIGHT and DOWN still take the value
+		i_up_active_tb <= '0';
+		TisPulse(clock_tb); -- MOV 7, ACC
+		TisPulse(clock_tb);
+		TisPulse(clock_tb);
+		assert pc_tb = 1 report "Blocked broadcast: Expecting PC = 1, got " & to_string(to_integer(pc_tb));
+
+		-- Only UP is offered while the broadcast waits
+		for i in 1 to 6 loop
+			ClockPulse(clock_tb);
+			assert o_right_active_tb = '0' report "Blocked broadcast: RIGHT offered again" severity error;
+			assert o_down_active_tb = '0' report "Blocked broadcast: DOWN offered again" severity error;
+		end loop;
+		assert pc_tb = 1 report "Blocked broadcast: Expecting PC = 1, got " & to_string(to_integer(pc_tb));
+
+		i_up_active_tb <= '1';
+		TisPulse(clock_tb);
+		assert pc_tb = 2 report "Unblocked broadcast: Expecting PC = 2, got " & to_string(to_integer(pc_tb));
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
@@ -0,0 +1,194 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_execution_node_handshake_tb is
+end entity;
+
+architecture rtl of tis_execution_node_handshake_tb is
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Avalon slave signals
+	signal clock_tb                         : std_logic;
+	signal resetn_tb                        : std_logic;
+	signal read_tb, write_tb, chipselect_tb : std_logic;
+	signal address_tb                       : std_logic_vector(2 downto 0);
+	signal readdata_tb                      : std_logic_vector(31 downto 0);
+	signal writedata_tb                     : std_logic_vector(31 downto 0);
+	signal byteenable_tb                    : std_logic_vector(3 downto 0);
+	signal Q_export_tb                      : std_logic_vector(31 downto 0);
+
+	-- TIS signals
+	signal tis_active_tb : std_logic;
+	-- Left conduit
+	signal i_left_tb        : std_logic_vector(10 downto 0);
+	signal i_left_active_tb : std_logic := '0';
+	signal o_left_tb        : std_logic_vector(10 downto 0);
+	signal o_left_active_tb : std_logic;
+	signal i_left_ready_tb  : std_logic := '0';
+	signal o_left_ready_tb  : std_logic;
+	-- Right conduit
+	signal i_right_tb        : std_logic_vector(10 downto 0);
+	signal i_right_active_tb : std_logic := '0';
+	signal o_right_tb        : std_logic_vector(10 downto 0);
+	signal o_right_active_tb : std_logic;
+	signal i_right_ready_tb  : std_logic := '0';
+	signal o_right_ready_tb  : std_logic;
+	-- Up conduit
+	signal i_up_tb        : std_logic_vector(10 downto 0);
+	signal i_up_active_tb : std_logic := '0';
+	signal o_up_tb        : std_logic_vector(10 downto 0);
+	signal o_up_active_tb : std_logic;
+	signal i_up_ready_tb  : std_logic := '0';
+	signal o_up_ready_tb  : std_logic;
+	-- Down conduit
+	signal i_down_tb        : std_logic_vector(10 downto 0);
+	signal i_down_active_tb : std_logic := '0';
+	signal o_down_tb        : std_logic_vector(10 downto 0);
+	signal o_down_active_tb : std_logic;
+	signal i_down_ready_tb  : std_logic := '0';
+	signal o_down_ready_tb  : std_logic;
+	signal acc_tb           : std_logic_vector(10 downto 0);
+	signal bak_tb           : std_logic_vector(10 downto 0);
+	signal pc_tb            : unsigned(3 downto 0);
+begin
+	-- Port map
+	node: entity work.tis_execution_node
+		generic map (
+			HANDSHAKE => true
+		)
+		port map (
+			clock          => clock_tb,
+			resetn         => resetn_tb,
+			read           => read_tb,
+			write          => write_tb,
+			address        => address_tb,
+			readdata       => readdata_tb,
+			writedata      => writedata_tb,
+			byteenable     => byteenable_tb,
+			Q_export       => Q_export_tb,
+			-- TIS signals
+			tis_active     => tis_active_tb,
+			i_left         => i_left_tb,
+			i_left_active  => i_left_active_tb,
+			o_left         => o_left_tb,
+			o_left_active  => o_left_active_tb,
+			i_left_ready   => i_left_ready_tb,
+			o_left_ready   => o_left_ready_tb,
+			i_right        => i_right_tb,
+			i_right_active => i_right_active_tb,
+			o_right        => o_right_tb,
+			o_right_active => o_right_active_tb,
+			i_right_ready  => i_right_ready_tb,
+			o_right_ready  => o_right_ready_tb,
+			i_up           => i_up_tb,
+			i_up_active    => i_up_active_tb,
+			o_up           => o_up_tb,
+			o_up_active    => o_up_active_tb,
+			i_up_ready     => i_up_ready_tb,
+			o_up_ready     => o_up_ready_tb,
+			i_down         => i_down_tb,
+			i_down_active  => i_down_active_tb,
+			o_down         => o_down_tb,
+			o_down_active  => o_down_active_tb,
+			i_down_ready   => i_down_ready_tb,
+			o_down_ready   => o_down_ready_tb,
+			debug_acc      => acc_tb,
+			debug_bak      => bak_tb,
+			debug_pc       => pc_tb
+		);
+
+	process
+	begin
+		-- Initialize signals
+		clock_tb <= '0';
+		resetn_tb <= '1'; -- High by default
+		byteenable_tb <= (others => '1');
+		read_tb <= '0';
+		write_tb <= '0';
+		writedata_tb <= (others => '0');
+		tis_active_tb <= '0';
+		ClockPulse(clock_tb);
+
+		-- Node Header (15 downto 0)
+		-- 0 MOV LEFT, ACC (31 downto 16), (Prefix number is PC)
+		write_tb <= '1';
+		address_tb <= std_logic_vector(to_unsigned(0, address_tb'length));
+		writedata_tb <= x"C804" & x"0004";
+		ClockPulse(clock_tb);
+
+		-- 1 ADD 1 (15 downto 0)
+		-- 2 MOV ACC, RIGHT (31 downto 16)
+		address_tb <= std_logic_vector(to_unsigned(1, address_tb'length));
+		writedata_tb <= x"E801" & x"0001";
+		ClockPulse(clock_tb);
+
+		-- 3 ADD ANY (15 downto 0)
+		-- 4 SWP (31 downto 16)
+		address_tb <= std_logic_vector(to_unsigned(2, address_tb'length));
+		writedata_tb <= x"5000" & x"0806";
+		ClockPulse(clock_tb);
+
+		write_tb <= '0';
+
+		-- Value waiting on the left, no reader on the right yet
+		i_left_active_tb <= '1';
+		i_left_tb <= std_logic_vector(to_signed(5, i_left_tb'length));
+		tis_active_tb <= '1';
+		wait for 1 ns;
+
+		-- Every instruction takes a single clock without blocking
+		assert o_left_ready_tb = '1' report "MOV LEFT, ACC: Expecting read on LEFT";
+		ClockPulse(clock_tb); -- MOV LEFT, ACC
+		assert acc_tb = std_logic_vector(to_signed(5, acc_tb'length)) report "MOV LEFT, ACC: Expecting ACC = 5, got " & to_string(acc_tb);
+		assert pc_tb = "0001" report "MOV LEFT, ACC: Expecting PC = 1, got " & to_string(to_integer(pc_tb));
+		assert o_left_ready_tb = '0' report "ADD 1: Expecting no read";
+
+		ClockPulse(clock_tb); -- ADD 1
+		assert acc_tb = std_logic_vector(to_signed(6, acc_tb'length)) report "ADD 1: Expecting ACC = 6, got " & to_string(acc_tb);
+		assert pc_tb = "0010" report "ADD 1: Expecting PC = 2, got " & to_string(to_integer(pc_tb));
+
+		ClockPulse(clock_tb); -- MOV ACC, RIGHT takes the value
+		assert o_right_active_tb = '1' report "MOV ACC, RIGHT: Expecting write on RIGHT";
+		assert o_right_tb = std_logic_vector(to_signed(6, o_right_tb'length)) report "MOV ACC, RIGHT: Expecting 6, got " & to_string(o_right_tb);
+
+		-- Simulate lack of reader
+		ClockPulse(clock_tb);
+		ClockPulse(clock_tb);
+		assert pc_tb = "0010" report "MOV ACC, RIGHT: Expecting PC = 2 while blocked, got " & to_string(to_integer(pc_tb));
+		assert o_right_active_tb = '1' report "MOV ACC, RIGHT: Expecting write on RIGHT while blocked";
+
+		i_right_ready_tb <= '1';
+		ClockPulse(clock_tb); -- MOV ACC, RIGHT hands over the value
+		assert pc_tb = "0011" report "MOV ACC, RIGHT: Expecting PC = 3, got " & to_string(to_integer(pc_tb));
+		assert o_right_active_tb = '0' report "ADD ANY: Expecting no write";
+
+		-- ANY reads one port per clock, after 6 clocks the slot points at UP
+		i_right_ready_tb <= '0';
+		i_left_active_tb <= '0';
+		i_up_active_tb <= '1';
+		i_up_tb <= std_logic_vector(to_signed(7, i_up_tb'length));
+		wait for 1 ns;
+		assert o_up_ready_tb = '1' and o_left_ready_tb = '0' report "ADD ANY: Expecting read on UP only";
+
+		ClockPulse(clock_tb); -- ADD ANY
+		assert acc_tb = std_logic_vector(to_signed(13, acc_tb'length)) report "ADD ANY: Expecting ACC = 13, got " & to_string(acc_tb);
+		assert pc_tb = "0100" report "ADD ANY: Expecting PC = 4, got " & to_string(to_integer(pc_tb));
+
+		ClockPulse(clock_tb); -- SWP
+		assert acc_tb = std_logic_vector(to_signed(0, acc_tb'length)) report "SWP: Expecting ACC = 0, got " & to_string(acc_tb);
+		assert bak_tb = std_logic_vector(to_signed(13, bak_tb'length)) report "SWP: Expecting BAK = 13, got " & to_string(bak_tb);
+		assert pc_tb = "0000" report "SWP: Expecting PC = 0, got " & to_string(to_integer(pc_tb));
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
@@ -0,0 +1,188 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_execution_node_pipelined_tb is
+end entity;
+
+architecture rtl of tis_execution_node_pipelined_tb is
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Full TIS I/O Cycle
+	procedure TisPulse(signal clk : inout std_logic) is
+	begin
+		-- Each cycle needs 6 rising edges
+		for i in 1 to 6 loop
+			wait for 1 ns;
+			clk <= '0';
+			wait for 1 ns;
+			clk <= '1';
+		end loop;
+
+		wait for 1 ns;
+	end procedure;
+
+	-- Avalon slave signals
+	signal clock_tb                         : std_logic;
+	signal resetn_tb                        : std_logic;
+	signal read_tb, write_tb, chipselect_tb : std_logic;
+	signal address_tb                       : std_logic_vector(2 downto 0);
+	signal readdata_tb                      : std_logic_vector(31 downto 0);
+	signal writedata_tb                     : std_logic_vector(31 downto 0);
+	signal byteenable_tb                    : std_logic_vector(3 downto 0);
+	signal Q_export_tb                      : std_logic_vector(31 downto 0);
+
+	-- TIS signals
+	signal tis_active_tb : std_logic;
+	-- Left conduit
+	signal i_left_tb        : std_logic_vector(10 downto 0);
+	signal i_left_active_tb : std_logic := '0';
+	signal o_left_tb        : std_logic_vector(10 downto 0);
+	signal o_left_active_tb : std_logic;
+	-- Right conduit
+	signal i_right_tb        : std_logic_vector(10 downto 0);
+	signal i_right_active_tb : std_logic := '0';
+	signal o_right_tb        : std_logic_vector(10 downto 0);
+	signal o_right_active_tb : std_logic;
+	-- Up conduit
+	signal i_up_tb        : std_logic_vector(10 downto 0);
+	signal i_up_active_tb : std_logic := '0';
+	signal o_up_tb        : std_logic_vector(10 downto 0);
+	signal o_up_active_tb : std_logic;
+	-- Down conduit
+	signal i_down_tb        : std_logic_vector(10 downto 0);
+	signal i_down_active_tb : std_logic := '0';
+	signal o_down_tb        : std_logic_vector(10 downto 0);
+	signal o_down_active_tb : std_logic;
+	signal acc_tb           : std_logic_vector(10 downto 0);
+	signal bak_tb           : std_logic_vector(10 downto 0);
+	signal pc_tb            : unsigned(3 downto 0);
+begin
+	-- Port map
+	node: entity work.tis_execution_node
+		generic map (
+			PIPELINED => true
+		)
+		port map (
+			clock          => clock_tb,
+			resetn         => resetn_tb,
+			read           => read_tb,
+			write          => write_tb,
+			address        => address_tb,
+			readdata       => readdata_tb,
+			writedata      => writedata_tb,
+			byteenable     => byteenable_tb,
+			Q_export       => Q_export_tb,
+			-- TIS signals
+			tis_active     => tis_active_tb,
+			i_left         => i_left_tb,
+			i_left_active  => i_left_active_tb,
+			o_left         => o_left_tb,
+			o_left_active  => o_left_active_tb,
+			i_right        => i_right_tb,
+			i_right_active => i_right_active_tb,
+			o_right        => o_right_tb,
+			o_right_active => o_right_active_tb,
+			i_up           => i_up_tb,
+			i_up_active    => i_up_active_tb,
+			o_up           => o_up_tb,
+			o_up_active    => o_up_active_tb,
+			i_down         => i_down_tb,
+			i_down_active  => i_down_active_tb,
+			o_down         => o_down_tb,
+			o_down_active  => o_down_active_tb,
+			debug_acc      => acc_tb,
+			debug_bak      => bak_tb,
+			debug_pc       => pc_tb
+		);
+
+	process
+	begin
+		-- Initialize signals
+		clock_tb <= '0';
+		resetn_tb <= '1'; -- High by default
+		byteenable_tb <= (others => '1');
+		read_tb <= '0';
+		write_tb <= '0';
+		writedata_tb <= (others => '0');
+		tis_active_tb <= '0';
+		ClockPulse(clock_tb);
+
+		-- Node Header (15 downto 0)
+		-- 0 ADD 1 (31 downto 16), (Prefix number is PC)
+		write_tb <= '1';
+		address_tb <= std_logic_vector(to_unsigned(0, address_tb'length));
+		writedata_tb <= x"0001" & x"0006";
+		ClockPulse(clock_tb);
+
+		-- 1 ADD 2 (15 downto 0)
+		-- 2 SAV (31 downto 16)
+		address_tb <= std_logic_vector(to_unsigned(1, address_tb'length));
+		writedata_tb <= x"4000" & x"0002";
+		ClockPulse(clock_tb);
+
+		-- 3 NEG (15 downto 0)
+		-- 4 ADD LEFT (31 downto 16)
+		address_tb <= std_logic_vector(to_unsigned(2, address_tb'length));
+		writedata_tb <= x"0804" & x"4800";
+		ClockPulse(clock_tb);
+
+		-- 5 MOV ACC, RIGHT (15 downto 0)
+		-- 6 JMP 0 (31 downto 16)
+		address_tb <= std_logic_vector(to_unsigned(3, address_tb'length));
+		writedata_tb <= x"7000" & x"E801";
+		ClockPulse(clock_tb);
+
+		write_tb <= '0';
+		tis_active_tb <= '1';
+
+		-- ADD 1, ADD 2, SAV and NEG retire in a single cycle,
+		-- ADD LEFT waits for the next TIS_RUN
+		TisPulse(clock_tb);
+		assert acc_tb = std_logic_vector(to_signed(-3, acc_tb'length)) report "NEG: Expecting ACC = -3, got " & to_string(acc_tb);
+		assert bak_tb = std_logic_vector(to_signed(3, bak_tb'length)) report "SAV: Expecting BAK = 3, got " & to_string(bak_tb);
+		assert pc_tb = "0100" report "ADD LEFT: Expecting PC = 4, got " & to_string(to_integer(pc_tb));
+
+		-- Simulate lack of input
+		TisPulse(clock_tb); -- ADD LEFT
+		assert pc_tb = "0100" report "ADD LEFT: Expecting PC = 4 without input, got " & to_string(to_integer(pc_tb));
+
+		-- Set input on left
+		i_left_active_tb <= '1';
+		i_left_tb <= std_logic_vector(to_signed(10, i_left_tb'length));
+
+		-- ADD LEFT retires in TIS_RIGHT, MOV ACC, RIGHT has to wait for TIS_RUN
+		TisPulse(clock_tb);
+		i_left_active_tb <= '0';
+		assert acc_tb = std_logic_vector(to_signed(7, acc_tb'length)) report "ADD LEFT: Expecting ACC = 7, got " & to_string(acc_tb);
+		assert pc_tb = "0101" report "MOV ACC, RIGHT: Expecting PC = 5, got " & to_string(to_integer(pc_tb));
+
+		-- Value is offered on RIGHT during the first phase
+		i_right_active_tb <= '1';
+		ClockPulse(clock_tb); -- TIS_RUN
+		ClockPulse(clock_tb); -- TIS_LEFT
+		assert o_right_active_tb = '1' report "MOV ACC, RIGHT: Expecting write on RIGHT";
+		assert o_right_tb = std_logic_vector(to_signed(7, o_right_tb'length)) report "MOV ACC, RIGHT: Expecting 7, got " & to_string(o_right_tb);
+
+		-- Write retires in TIS_RIGHT, then JMP 0, ADD 1 and ADD 2 follow
+		ClockPulse(clock_tb); -- TIS_RIGHT
+		i_right_active_tb <= '0';
+		assert pc_tb = "0110" report "MOV ACC, RIGHT: Expecting PC = 6, got " & to_string(to_integer(pc_tb));
+		ClockPulse(clock_tb); -- TIS_UP
+		ClockPulse(clock_tb); -- TIS_DOWN
+		ClockPulse(clock_tb); -- TIS_FINISH
+		assert acc_tb = std_logic_vector(to_signed(10, acc_tb'length)) report "ADD 2: Expecting ACC = 10, got " & to_string(acc_tb);
+		assert pc_tb = "0010" report "SAV: Expecting PC = 2, got " & to_string(to_integer(pc_tb));
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
@@ -0,0 +1,205 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_execution_node_status_tb is
+end entity;
+
+architecture rtl of tis_execution_node_status_tb is
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Full TIS I/O Cycle
+	procedure TisPulse(signal clk : inout std_logic) is
+	begin
+		-- Each cycle needs 6 rising edges
+		for i in 1 to 6 loop
+			wait for 1 ns;
+			clk <= '0';
+			wait for 1 ns;
+			clk <= '1';
+		end loop;
+
+		wait for 1 ns;
+	end procedure;
+
+	-- Avalon slave signals
+	signal clock_tb                         : std_logic;
+	signal resetn_tb                        : std_logic;
+	signal read_tb, write_tb, chipselect_tb : std_logic;
+	signal address_tb                       : std_logic_vector(3 downto 0);
+	signal readdata_tb                      : std_logic_vector(31 downto 0);
+	signal writedata_tb                     : std_logic_vector(31 downto 0);
+	signal byteenable_tb                    : std_logic_vector(3 downto 0);
+	signal Q_export_tb                      : std_logic_vector(31 downto 0);
+
+	-- TIS signals
+	signal tis_active_tb     : std_logic;
+	signal status_capture_tb : std_logic := '0';
+	-- Left conduit
+	signal i_left_tb        : std_logic_vector(10 downto 0);
+	signal i_left_active_tb : std_logic := '0';
+	signal o_left_tb        : std_logic_vector(10 downto 0);
+	signal o_left_active_tb : std_logic;
+	-- Right conduit
+	signal i_right_tb        : std_logic_vector(10 downto 0);
+	signal i_right_active_tb : std_logic := '0';
+	signal o_right_tb        : std_logic_vector(10 downto 0);
+	signal o_right_active_tb : std_logic;
+	-- Up conduit
+	signal i_up_tb        : std_logic_vector(10 downto 0);
+	signal i_up_active_tb : std_logic := '0';
+	signal o_up_tb        : std_logic_vector(10 downto 0);
+	signal o_up_active_tb : std_logic;
+	-- Down conduit
+	signal i_down_tb        : std_logic_vector(10 downto 0);
+	signal i_down_active_tb : std_logic := '0';
+	signal o_down_tb        : std_logic_vector(10 downto 0);
+	signal o_down_active_tb : std_logic;
+	signal acc_tb           : std_logic_vector(10 downto 0);
+	signal bak_tb           : std_logic_vector(10 downto 0);
+	signal pc_tb            : unsigned(3 downto 0);
+begin
+	-- Port map
+	node: entity work.tis_execution_node
+		generic map (
+			STATUS => true
+		)
+		port map (
+			clock          => clock_tb,
+			resetn         => resetn_tb,
+			read           => read_tb,
+			write          => write_tb,
+			address        => address_tb,
+			readdata       => readdata_tb,
+			writedata      => writedata_tb,
+			byteenable     => byteenable_tb,
+			Q_export       => Q_export_tb,
+			-- TIS signals
+			tis_active     => tis_active_tb,
+			status_capture => status_capture_tb,
+			i_left         => i_left_tb,
+			i_left_active  => i_left_active_tb,
+			o_left         => o_left_tb,
+			o_left_active  => o_left_active_tb,
+			i_right        => i_right_tb,
+			i_right_active => i_right_active_tb,
+			o_right        => o_right_tb,
+			o_right_active => o_right_active_tb,
+			i_up           => i_up_tb,
+			i_up_active    => i_up_active_tb,
+			o_up           => o_up_tb,
+			o_up_active    => o_up_active_tb,
+			i_down         => i_down_tb,
+			i_down_active  => i_down_active_tb,
+			o_down         => o_down_tb,
+			o_down_active  => o_down_active_tb,
+			debug_acc      => acc_tb,
+			debug_bak      => bak_tb,
+			debug_pc       => pc_tb
+		);
+
+	process
+		-- Reads a word of the status window after the program
+		procedure ReadStatus(word : natural) is
+		begin
+			read_tb <= '1';
+			address_tb <= std_logic_vector(to_unsigned(8 + word, address_tb'length));
+			ClockPulse(clock_tb);
+			read_tb <= '0';
+		end procedure;
+	begin
+		-- Initialize signals
+		clock_tb <= '0';
+		resetn_tb <= '0';
+		byteenable_tb <= (others => '1');
+		read_tb <= '0';
+		write_tb <= '0';
+		writedata_tb <= (others => '0');
+		tis_active_tb <= '0';
+		i_left_tb <= std_logic_vector(to_signed(9, i_left_tb'length));
+		ClockPulse(clock_tb);
+		resetn_tb <= '1';
+		ClockPulse(clock_tb);
+
+		-- Node Header (15 downto 0), last instruction is 1
+		-- 0 MOV LEFT, ACC (31 downto 16)
+		write_tb <= '1';
+		address_tb <= std_logic_vector(to_unsigned(0, address_tb'length));
+		writedata_tb <= x"C804" & x"0001";
+		ClockPulse(clock_tb);
+
+		-- 1 MOV ACC, RIGHT (15 downto 0)
+		address_tb <= std_logic_vector(to_unsigned(1, address_tb'length));
+		writedata_tb <= x"0000" & x"E801";
+		ClockPulse(clock_tb);
+		write_tb <= '0';
+
+		-- Nothing on LEFT for three cycles, then 9
+		tis_active_tb <= '1';
+		for i in 1 to 3 loop
+			TisPulse(clock_tb);
+		end loop;
+
+		i_left_active_tb <= '1';
+		TisPulse(clock_tb); -- MOV LEFT, ACC
+		i_left_active_tb <= '0';
+
+		-- Source fetch, then RIGHT doesn't read
+		TisPulse(clock_tb);
+		TisPulse(clock_tb);
+		tis_active_tb <= '0';
+
+		-- Snapshot through the status window
+		write_tb <= '1';
+		address_tb <= std_logic_vector(to_unsigned(8, address_tb'length));
+		ClockPulse(clock_tb);
+		write_tb <= '0';
+
+		ReadStatus(0);
+		assert readdata_tb = x"0000" & x"0009" report "Expected BAK 0 and ACC 9, got " & to_hstring(readdata_tb) severity error;
+
+		-- Value 9 waits for RIGHT at PC 1 in TIS_RUN
+		ReadStatus(1);
+		assert readdata_tb = x"0009" & x"1001" report "Expected pending write of 9 at PC 1, got " & to_hstring(readdata_tb) severity error;
+
+		ReadStatus(2);
+		assert readdata_tb = x"00000000" report "Expected 0 past the status registers, got " & to_hstring(readdata_tb) severity error;
+
+		-- Program reads are unaffected
+		read_tb <= '1';
+		address_tb <= std_logic_vector(to_unsigned(1, address_tb'length));
+		ClockPulse(clock_tb);
+		read_tb <= '0';
+		assert readdata_tb = x"0000" & x"E801" report "(1) Failed to validate memory, got " & to_hstring(readdata_tb) severity error;
+
+		-- RIGHT takes the value, the snapshot stays until the next capture
+		tis_active_tb <= '1';
+		i_right_active_tb <= '1';
+		TisPulse(clock_tb); -- MOV ACC, RIGHT
+		i_right_active_tb <= '0';
+		tis_active_tb <= '0';
+		assert pc_tb = 0 report "MOV ACC, RIGHT: Expecting PC = 0, got " & to_string(to_integer(pc_tb));
+
+		ReadStatus(1);
+		assert readdata_tb(15 downto 0) = x"1001" report "Snapshot changed without capture, got " & to_hstring(readdata_tb) severity error;
+
+		-- Capture like a neighbouring node in the grid would
+		status_capture_tb <= '1';
+		ClockPulse(clock_tb);
+		status_capture_tb <= '0';
+
+		ReadStatus(1);
+		assert readdata_tb(15 downto 0) = x"0000" report "Expected no pending I/O at PC 0, got " & to_hstring(readdata_tb) severity error;
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
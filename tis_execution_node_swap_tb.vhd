@@ -0,0 +1,246 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_execution_node_swap_tb is
+end entity;
+
+architecture rtl of tis_execution_node_swap_tb is
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Full TIS I/O Cycle
+	procedure TisPulse(signal clk : inout std_logic) is
+	begin
+		-- Each cycle needs 6 rising edges
+		for i in 1 to 6 loop
+			wait for 1 ns;
+			clk <= '0';
+			wait for 1 ns;
+			clk <= '1';
+		end loop;
+
+		wait for 1 ns;
+	end procedure;
+
+	-- Avalon slave signals
+	signal clock_tb                         : std_logic;
+	signal resetn_tb                        : std_logic;
+	signal read_tb, write_tb, chipselect_tb : std_logic;
+	signal address_tb                       : std_logic_vector(3 downto 0);
+	signal readdata_tb                      : std_logic_vector(31 downto 0);
+	signal writedata_tb                     : std_logic_vector(31 downto 0);
+	signal byteenable_tb                    : std_logic_vector(3 downto 0);
+	signal Q_export_tb                      : std_logic_vector(31 downto 0);
+
+	-- TIS signals
+	signal tis_active_tb : std_logic;
+	-- Left conduit
+	signal i_left_tb        : std_logic_vector(10 downto 0);
+	signal i_left_active_tb : std_logic := '0';
+	signal o_left_tb        : std_logic_vector(10 downto 0);
+	signal o_left_active_tb : std_logic;
+	-- Right conduit
+	signal i_right_tb        : std_logic_vector(10 downto 0);
+	signal i_right_active_tb : std_logic := '0';
+	signal o_right_tb        : std_logic_vector(10 downto 0);
+	signal o_right_active_tb : std_logic;
+	-- Up conduit
+	signal i_up_tb        : std_logic_vector(10 downto 0);
+	signal i_up_active_tb : std_logic := '0';
+	signal o_up_tb        : std_logic_vector(10 downto 0);
+	signal o_up_active_tb : std_logic;
+	-- Down conduit
+	signal i_down_tb        : std_logic_vector(10 downto 0);
+	signal i_down_active_tb : std_logic := '0';
+	signal o_down_tb        : std_logic_vector(10 downto 0);
+	signal o_down_active_tb : std_logic;
+	signal acc_tb           : std_logic_vector(10 downto 0);
+	signal bak_tb           : std_logic_vector(10 downto 0);
+	signal pc_tb            : unsigned(3 downto 0);
+begin
+	-- Port map
+	node: entity work.tis_execution_node
+		generic map (
+			HOT_SWAP => true
+		)
+		port map (
+			clock          => clock_tb,
+			resetn         => resetn_tb,
+			read           => read_tb,
+			write          => write_tb,
+			address        => address_tb,
+			readdata       => readdata_tb,
+			writedata      => writedata_tb,
+			byteenable     => byteenable_tb,
+			Q_export       => Q_export_tb,
+			-- TIS signals
+			tis_active     => tis_active_tb,
+			i_left         => i_left_tb,
+			i_left_active  => i_left_active_tb,
+			o_left         => o_left_tb,
+			o_left_active  => o_left_active_tb,
+			i_right        => i_right_tb,
+			i_right_active => i_right_active_tb,
+			o_right        => o_right_tb,
+			o_right_active => o_right_active_tb,
+			i_up           => i_up_tb,
+			i_up_active    => i_up_active_tb,
+			o_up           => o_up_tb,
+			o_up_active    => o_up_active_tb,
+			i_down         => i_down_tb,
+			i_down_active  => i_down_active_tb,
+			o_down         => o_down_tb,
+			o_down_active  => o_down_active_tb,
+			debug_acc      => acc_tb,
+			debug_bak      => bak_tb,
+			debug_pc       => pc_tb
+		);
+
+	process
+		-- Control word in the window after the program
+		procedure WriteControl(value : std_logic_vector(31 downto 0)) is
+		begin
+			write_tb <= '1';
+			address_tb <= std_logic_vector(to_unsigned(8, address_tb'length));
+			writedata_tb <= value;
+			ClockPulse(clock_tb);
+			write_tb <= '0';
+		end procedure;
+
+		procedure ReadControl is
+		begin
+			read_tb <= '1';
+			address_tb <= std_logic_vector(to_unsigned(8, address_tb'length));
+			ClockPulse(clock_tb);
+			read_tb <= '0';
+		end procedure;
+	begin
+		-- Initialize signals
+		clock_tb <= '0';
+		resetn_tb <= '0';
+		byteenable_tb <= (others => '1');
+		read_tb <= '0';
+		write_tb <= '0';
+		writedata_tb <= (others => '0');
+		tis_active_tb <= '0';
+		i_left_tb <= std_logic_vector(to_signed(9, i_left_tb'length));
+		ClockPulse(clock_tb);
+		resetn_tb <= '1';
+		ClockPulse(clock_tb);
+
+		-- Node Header (15 downto 0), last instruction is 1
+		-- 0 MOV LEFT, ACC (31 downto 16)
+		write_tb <= '1';
+		address_tb <= std_logic_vector(to_unsigned(0, address_tb'length));
+		writedata_tb <= x"C804" & x"0001";
+		ClockPulse(clock_tb);
+
+		-- 1 MOV ACC, RIGHT (15 downto 0)
+		address_tb <= std_logic_vector(to_unsigned(1, address_tb'length));
+		writedata_tb <= x"0000" & x"E801";
+		ClockPulse(clock_tb);
+		write_tb <= '0';
+
+		ReadControl;
+		assert readdata_tb = x"00000001" report "Expected node enabled after reset, got " & to_hstring(readdata_tb) severity error;
+
+		-- Registers are only accessed between cycles
+		tis_active_tb <= '1';
+		i_left_active_tb <= '1';
+		TisPulse(clock_tb); -- MOV LEFT, ACC
+		i_left_active_tb <= '0';
+		TisPulse(clock_tb); -- MOV ACC, RIGHT waits for RIGHT
+		tis_active_tb <= '0';
+
+		-- Disabling drains the pending write first
+		WriteControl(x"00000000");
+		ReadControl;
+		assert readdata_tb = x"00000008" report "Expected disabled node with pending write, got " & to_hstring(readdata_tb) severity error;
+
+		tis_active_tb <= '1';
+		TisPulse(clock_tb);
+		i_right_active_tb <= '1';
+		TisPulse(clock_tb); -- MOV ACC, RIGHT
+		i_right_active_tb <= '0';
+		tis_active_tb <= '0';
+		assert pc_tb = 0 report "MOV ACC, RIGHT: Expecting PC = 0, got " & to_string(to_integer(pc_tb));
+
+		-- Halts in TIS_RUN before the next instruction
+		ClockPulse(clock_tb);
+		ReadControl;
+		assert readdata_tb = x"00000002" report "Expected halted node, got " & to_hstring(readdata_tb) severity error;
+
+		-- LEFT keeps offering, the halted node doesn't take it
+		tis_active_tb <= '1';
+		i_left_tb <= std_logic_vector(to_signed(4, i_left_tb'length));
+		i_left_active_tb <= '1';
+		ClockPulse(clock_tb);
+		ClockPulse(clock_tb);
+		assert o_left_active_tb = '0' report "Expected no read on LEFT while halted" severity error;
+		for i in 1 to 4 loop
+			ClockPulse(clock_tb);
+		end loop;
+		TisPulse(clock_tb);
+		i_left_active_tb <= '0';
+		tis_active_tb <= '0';
+		assert acc_tb = std_logic_vector(to_signed(9, acc_tb'length)) report "Expected ACC 9 while halted, got " & to_string(to_integer(signed(acc_tb))) severity error;
+		assert pc_tb = 0 report "Expected PC 0 while halted, got " & to_string(to_integer(pc_tb)) severity error;
+
+		-- Swap in ADD 5 as the only instruction
+		write_tb <= '1';
+		address_tb <= std_logic_vector(to_unsigned(0, address_tb'length));
+		writedata_tb <= x"0005" & x"0000";
+		ClockPulse(clock_tb);
+		write_tb <= '0';
+
+		-- Reset and enable in one write
+		WriteControl(x"00000003");
+		assert acc_tb = std_logic_vector(to_signed(0, acc_tb'length)) report "Expected ACC 0 after reset, got " & to_string(to_integer(signed(acc_tb))) severity error;
+		assert pc_tb = 0 report "Expected PC 0 after reset, got " & to_string(to_integer(pc_tb)) severity error;
+
+		ClockPulse(clock_tb);
+		ReadControl;
+		assert readdata_tb = x"00000001" report "Expected running node after enabling, got " & to_hstring(readdata_tb) severity error;
+
+		tis_active_tb <= '1';
+		TisPulse(clock_tb); -- ADD 5
+		TisPulse(clock_tb); -- ADD 5
+		tis_active_tb <= '0';
+		assert acc_tb = std_logic_vector(to_signed(10, acc_tb'length)) report "Expected ACC 10 from the new program, got " & to_string(to_integer(signed(acc_tb))) severity error;
+
+		-- Context switch between cycles, forced halts take one clock
+		WriteControl(x"00000004");
+		ClockPulse(clock_tb);
+
+		read_tb <= '1';
+		address_tb <= std_logic_vector(to_unsigned(9, address_tb'length));
+		ClockPulse(clock_tb);
+		read_tb <= '0';
+		assert readdata_tb = x"0000" & x"000A" report "Expected saved BAK 0 and ACC 10, got " & to_hstring(readdata_tb) severity error;
+
+		-- Restore BAK 3 and ACC -7
+		write_tb <= '1';
+		address_tb <= std_logic_vector(to_unsigned(9, address_tb'length));
+		writedata_tb <= x"0003" & x"FFF9";
+		ClockPulse(clock_tb);
+		write_tb <= '0';
+		assert bak_tb = std_logic_vector(to_signed(3, bak_tb'length)) report "Expected restored BAK 3, got " & to_string(to_integer(signed(bak_tb))) severity error;
+
+		WriteControl(x"00000001");
+		tis_active_tb <= '1';
+		TisPulse(clock_tb); -- ADD 5
+		tis_active_tb <= '0';
+		assert acc_tb = std_logic_vector(to_signed(-2, acc_tb'length)) report "Expected ACC -2 after restoring, got " & to_string(to_integer(signed(acc_tb))) severity error;
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
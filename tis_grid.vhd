@@ -0,0 +1,351 @@
+-- altera vhdl_input_version vhdl_2008
+library IEEE;
+	use IEEE.std_logic_1164.all;
+	use IEEE.numeric_std.all;
+	use IEEE.math_real.all;
+
+	-- Grid of execution and stack nodes behind a single Avalon slave.
+	-- Every node gets 2 ** (pc_width - 1) words of address space in row major
+	-- order, so with the default 8 words node (row, col) starts at word
+	-- (row * cols + col) * 8. With counters the span doubles and the
+	-- performance counters of an execution node follow its program, status
+	-- doubles it again for the runtime state after that. Writing the status
+	-- window of an execution node takes a snapshot of all of them at once.
+	-- Hot swap doubles the span once more for the control word of every
+	-- execution node, which halts it for reprogramming while the rest runs.
+	-- Stack nodes keep the layout of their own slave:
+	-- every halfword is a register of tis_stack_node, so config and data share
+	-- the first word and words 4 to 7 are the data window.
+	-- With handshake every node and link uses the ready/valid protocol of
+	-- tis_execution_node instead of the TIS phases. Hot swap and stack nodes
+	-- in block RAM need the phases and are rejected in that case.
+
+entity tis_grid is
+	generic (
+		rows         : positive       := 3;
+		cols         : positive       := 1;
+		-- Bit per node in row major order, '1' places a stack node.
+		-- Nodes past the end of the vector are execution nodes.
+		stack_nodes  : std_logic_vector := "101";
+		-- Depth of each link, see tis_link. Horizontal links are numbered row
+		-- major with cols - 1 per row, vertical links with cols per row.
+		-- Links past the end of a vector use its last entry.
+		h_link_depth : integer_vector := (0 => 0);
+		v_link_depth : integer_vector := (0 => 0);
+		-- Values per stack node, deep stacks should use block RAM
+		stack_length : natural        := 15;
+		stack_bram   : boolean        := false;
+		-- Nodes follow tis_phase and keep their programs in LUT RAM
+		compact      : boolean        := false;
+		-- Program counter width of the execution nodes
+		pc_width     : positive range 4 to 7 := 4;
+		-- Execution nodes decode broadcast MOVs, see tis_execution_node
+		broadcast    : boolean        := false;
+		-- Execution nodes count cycles, instructions and stalls
+		counters     : boolean        := false;
+		-- Execution nodes expose a snapshot of their registers and state
+		status       : boolean        := false;
+		-- Execution nodes can be halted and reprogrammed one at a time
+		hot_swap     : boolean        := false;
+		-- Nodes and links hand values over with valid/ready, see tis_execution_node
+		handshake    : boolean        := false
+	);
+	port (
+		clock, resetn : in  std_logic;
+		read, write   : in  std_logic;
+		address       : in  std_logic_vector(integer(ceil(log2(real(rows * cols)))) + pc_width - 2 + boolean'pos(counters) + boolean'pos(status) + boolean'pos(hot_swap) downto 0);
+		readdata      : out std_logic_vector(31 downto 0);
+		writedata     : in  std_logic_vector(31 downto 0);
+		byteenable    : in  std_logic_vector(3 downto 0);
+		-- Interrupt when any stack node has data available for reading
+		irq           : out std_logic;
+		-- Used to avoid early start without initialized program
+		tis_active    : in  std_logic;
+		-- One-hot phase from tis_controller, only used when compact
+		tis_phase     : in  std_logic_vector(5 downto 0) := (others => '0');
+
+		-- Node state for tis_trace, node n in the n-th field of each vector.
+		-- Stack nodes read as 0. Transfers are ports with both sides active,
+		-- bit 0 for UP up to bit 3 for RIGHT.
+		debug_pc        : out std_logic_vector(7 * rows * cols - 1 downto 0);
+		debug_acc       : out std_logic_vector(11 * rows * cols - 1 downto 0);
+		debug_bak       : out std_logic_vector(11 * rows * cols - 1 downto 0);
+		debug_transfers : out std_logic_vector(4 * rows * cols - 1 downto 0)
+	);
+end entity;
+
+architecture rtl of tis_grid is
+	constant node_count  : positive := rows * cols;
+	-- Address bits of the register windows after the program
+	constant window_bits : natural  := boolean'pos(counters) + boolean'pos(status) + boolean'pos(hot_swap);
+
+	pure function IsStack(index : natural) return boolean is
+	begin
+		return index < stack_nodes'length and stack_nodes(stack_nodes'left + index) = '1';
+	end function;
+
+	pure function LinkDepth(depths : integer_vector; index : natural) return natural is
+	begin
+		if index < depths'length then
+			return depths(depths'left + index);
+		else
+			return depths(depths'right);
+		end if;
+	end function;
+
+	type node_words is array (0 to node_count - 1) of std_logic_vector(31 downto 0);
+	type node_values is array (0 to node_count - 1) of std_logic_vector(10 downto 0);
+
+	signal node_index    : natural;
+	signal read_index    : natural := 0; -- Node read on the previous clock
+	signal node_read     : std_logic_vector(0 to node_count - 1);
+	signal node_write    : std_logic_vector(0 to node_count - 1);
+	signal node_readdata : node_words;
+	signal node_irq      : std_logic_vector(0 to node_count - 1);
+
+	signal status_capture : std_logic;
+
+	-- Conduits driven by each node
+	signal left_value, right_value, up_value, down_value     : node_values;
+	signal left_active, right_active, up_active, down_active : std_logic_vector(0 to node_count - 1);
+	signal left_ready, right_ready, up_ready, down_ready     : std_logic_vector(0 to node_count - 1);
+
+	-- Conduits seen by each node
+	signal i_left_value, i_right_value, i_up_value, i_down_value     : node_values;
+	signal i_left_active, i_right_active, i_up_active, i_down_active : std_logic_vector(0 to node_count - 1);
+	signal i_left_ready, i_right_ready, i_up_ready, i_down_ready     : std_logic_vector(0 to node_count - 1);
+begin
+	assert not (handshake and (hot_swap or stack_bram)) report "handshake grids don't support hot_swap or stack_bram" severity failure;
+
+	-- Address decoder
+	node_index <= to_integer(unsigned(address(address'high downto pc_width - 1 + window_bits)));
+
+	-- Status window follows the counters
+	status_capture <= write when status and to_integer(unsigned(address(pc_width - 2 + window_bits downto pc_width - 1))) = 1 + boolean'pos(counters) else '0';
+
+	decoder: for n in 0 to node_count - 1 generate
+		node_read(n) <= read when node_index = n else '0';
+		node_write(n) <= write when node_index = n else '0';
+	end generate;
+
+	-- Nodes answer a clock after the read, when the address may have moved on
+	read_select: process (clock, resetn)
+	begin
+		if resetn = '0' then
+			read_index <= 0;
+		elsif rising_edge(clock) then
+			if read = '1' then
+				read_index <= node_index;
+			end if;
+		end if;
+	end process;
+
+	readdata <= node_readdata(read_index) when read_index < node_count else (others => '0');
+
+	irq <= '0' when node_irq = (node_irq'range => '0') else '1';
+
+	nodes: for n in 0 to node_count - 1 generate
+		debug_transfers(4 * n + 0) <= (up_active(n) and i_up_ready(n)) or (up_ready(n) and i_up_active(n)) when handshake else
+		                              up_active(n) and i_up_active(n);
+		debug_transfers(4 * n + 1) <= (down_active(n) and i_down_ready(n)) or (down_ready(n) and i_down_active(n)) when handshake else
+		                              down_active(n) and i_down_active(n);
+		debug_transfers(4 * n + 2) <= (left_active(n) and i_left_ready(n)) or (left_ready(n) and i_left_active(n)) when handshake else
+		                              left_active(n) and i_left_active(n);
+		debug_transfers(4 * n + 3) <= (right_active(n) and i_right_ready(n)) or (right_ready(n) and i_right_active(n)) when handshake else
+		                              right_active(n) and i_right_active(n);
+
+		execution: if not IsStack(n) generate
+			signal node_pc : unsigned(pc_width - 1 downto 0);
+		begin
+			node_irq(n) <= '0';
+			debug_pc(7 * n + 6 downto 7 * n) <= std_logic_vector(resize(node_pc, 7));
+
+			node: entity work.tis_execution_node
+				generic map (
+					HANDSHAKE => handshake,
+					COMPACT   => compact,
+					PC_WIDTH  => pc_width,
+					BROADCAST => broadcast,
+					COUNTERS  => counters,
+					STATUS    => status,
+					HOT_SWAP  => hot_swap
+				)
+				port map (
+					clock          => clock,
+					resetn         => resetn,
+					read           => node_read(n),
+					write          => node_write(n),
+					address        => address(pc_width - 2 + window_bits downto 0),
+					readdata       => node_readdata(n),
+					writedata      => writedata,
+					byteenable     => byteenable,
+					tis_active     => tis_active,
+					tis_phase      => tis_phase,
+					status_capture => status_capture,
+					i_left         => i_left_value(n),
+					i_left_active  => i_left_active(n),
+					o_left         => left_value(n),
+					o_left_active  => left_active(n),
+					i_left_ready   => i_left_ready(n),
+					o_left_ready   => left_ready(n),
+					i_right        => i_right_value(n),
+					i_right_active => i_right_active(n),
+					o_right        => right_value(n),
+					o_right_active => right_active(n),
+					i_right_ready  => i_right_ready(n),
+					o_right_ready  => right_ready(n),
+					i_up           => i_up_value(n),
+					i_up_active    => i_up_active(n),
+					o_up           => up_value(n),
+					o_up_active    => up_active(n),
+					i_up_ready     => i_up_ready(n),
+					o_up_ready     => up_ready(n),
+					i_down         => i_down_value(n),
+					i_down_active  => i_down_active(n),
+					o_down         => down_value(n),
+					o_down_active  => down_active(n),
+					i_down_ready   => i_down_ready(n),
+					o_down_ready   => down_ready(n),
+					debug_acc      => debug_acc(11 * n + 10 downto 11 * n),
+					debug_bak      => debug_bak(11 * n + 10 downto 11 * n),
+					debug_pc       => node_pc
+				);
+		end generate;
+
+		stack: if IsStack(n) generate
+			signal stack_address   : std_logic_vector(3 downto 0);
+			signal stack_writedata : std_logic_vector(15 downto 0);
+			signal stack_readdata  : std_logic_vector(15 downto 0);
+		begin
+			-- Upper halfword is the data register, same as the 16 bit slave
+			stack_address(0) <= byteenable(2) or byteenable(3);
+			stack_address(3 downto 1) <= address(2 downto 0);
+			debug_pc(7 * n + 6 downto 7 * n) <= (others => '0');
+			debug_acc(11 * n + 10 downto 11 * n) <= (others => '0');
+			debug_bak(11 * n + 10 downto 11 * n) <= (others => '0');
+			stack_writedata <= writedata(31 downto 16) when stack_address(0) = '1' else writedata(15 downto 0);
+			node_readdata(n) <= stack_readdata & stack_readdata;
+
+			node: entity work.tis_stack_node
+				generic map (
+					buffer_length => stack_length,
+					COMPACT       => compact,
+					BLOCK_RAM     => stack_bram,
+					HANDSHAKE     => handshake
+				)
+				port map (
+					clock          => clock,
+					resetn         => resetn,
+					read           => node_read(n),
+					write          => node_write(n),
+					address        => stack_address,
+					readdata       => stack_readdata,
+					writedata      => stack_writedata,
+					irq            => node_irq(n),
+					tis_active     => tis_active,
+					tis_phase      => tis_phase,
+					i_left         => i_left_value(n),
+					i_left_active  => i_left_active(n),
+					o_left         => left_value(n),
+					o_left_active  => left_active(n),
+					i_left_ready   => i_left_ready(n),
+					o_left_ready   => left_ready(n),
+					i_right        => i_right_value(n),
+					i_right_active => i_right_active(n),
+					o_right        => right_value(n),
+					o_right_active => right_active(n),
+					i_right_ready  => i_right_ready(n),
+					o_right_ready  => right_ready(n),
+					i_up           => i_up_value(n),
+					i_up_active    => i_up_active(n),
+					o_up           => up_value(n),
+					o_up_active    => up_active(n),
+					i_up_ready     => i_up_ready(n),
+					o_up_ready     => up_ready(n),
+					i_down         => i_down_value(n),
+					i_down_active  => i_down_active(n),
+					o_down         => down_value(n),
+					o_down_active  => down_active(n),
+					i_down_ready   => i_down_ready(n),
+					o_down_ready   => down_ready(n)
+				);
+		end generate;
+	end generate;
+
+	-- Outer conduits stay idle
+	row_edges: for r in 0 to rows - 1 generate
+		i_left_value(r * cols) <= (others => '0');
+		i_left_active(r * cols) <= '0';
+		i_left_ready(r * cols) <= '0';
+		i_right_value(r * cols + cols - 1) <= (others => '0');
+		i_right_active(r * cols + cols - 1) <= '0';
+		i_right_ready(r * cols + cols - 1) <= '0';
+	end generate;
+
+	col_edges: for c in 0 to cols - 1 generate
+		i_up_value(c) <= (others => '0');
+		i_up_active(c) <= '0';
+		i_up_ready(c) <= '0';
+		i_down_value((rows - 1) * cols + c) <= (others => '0');
+		i_down_active((rows - 1) * cols + c) <= '0';
+		i_down_ready((rows - 1) * cols + c) <= '0';
+	end generate;
+
+	-- Node (r, c) is side A and node (r, c + 1) side B
+	horizontal: for r in 0 to rows - 1 generate
+		links: for c in 0 to cols - 2 generate
+			link: entity work.tis_link
+				generic map (
+					depth      => LinkDepth(h_link_depth, r * (cols - 1) + c),
+					horizontal => true,
+					HANDSHAKE  => handshake
+				)
+				port map (
+					clock      => clock,
+					resetn     => resetn,
+					tis_active => tis_active,
+					i_a        => right_value(r * cols + c),
+					i_a_active => right_active(r * cols + c),
+					o_a        => i_right_value(r * cols + c),
+					o_a_active => i_right_active(r * cols + c),
+					i_a_ready  => right_ready(r * cols + c),
+					o_a_ready  => i_right_ready(r * cols + c),
+					i_b        => left_value(r * cols + c + 1),
+					i_b_active => left_active(r * cols + c + 1),
+					o_b        => i_left_value(r * cols + c + 1),
+					o_b_active => i_left_active(r * cols + c + 1),
+					i_b_ready  => left_ready(r * cols + c + 1),
+					o_b_ready  => i_left_ready(r * cols + c + 1)
+				);
+		end generate;
+	end generate;
+
+	-- Node (r, c) is side A and node (r + 1, c) side B
+	vertical: for r in 0 to rows - 2 generate
+		links: for c in 0 to cols - 1 generate
+			link: entity work.tis_link
+				generic map (
+					depth      => LinkDepth(v_link_depth, r * cols + c),
+					horizontal => false,
+					HANDSHAKE  => handshake
+				)
+				port map (
+					clock      => clock,
+					resetn     => resetn,
+					tis_active => tis_active,
+					i_a        => down_value(r * cols + c),
+					i_a_active => down_active(r * cols + c),
+					o_a        => i_down_value(r * cols + c),
+					o_a_active => i_down_active(r * cols + c),
+					i_a_ready  => down_ready(r * cols + c),
+					o_a_ready  => i_down_ready(r * cols + c),
+					i_b        => up_value((r + 1) * cols + c),
+					i_b_active => up_active((r + 1) * cols + c),
+					o_b        => i_up_value((r + 1) * cols + c),
+					o_b_active => i_up_active((r + 1) * cols + c),
+					i_b_ready  => up_ready((r + 1) * cols + c),
+					o_b_ready  => i_up_ready((r + 1) * cols + c)
+				);
+		end generate;
+	end generate;
+end architecture;
@@ -0,0 +1,286 @@
+-- altera vhdl_input_version vhdl_2008
+library IEEE;
+	use IEEE.std_logic_1164.all;
+	use IEEE.numeric_std.all;
+	use IEEE.math_real.all;
+
+	-- tis_grid and tis_controller on their own clock, behind an Avalon slave
+	-- on the clock of the Nios and the interconnect. Slave accesses cross as
+	-- commands through a dual-clock FIFO and read results come back through
+	-- a second one, so writes are posted and reads hold waitrequest until
+	-- the grid answered. Commands keep their order, a read after a write
+	-- always sees the written value. tis_enable and tis_step_once go through
+	-- synchronizers into the TIS clock, irq and tis_active come back the same
+	-- way. The TIS clock can be faster or slower than the slave clock.
+	-- The grid takes the lower half of the address space, the upper half
+	-- holds the registers of tis_controller in the lower halfword of each
+	-- word. They go through the same FIFOs, so they follow the grid accesses
+	-- in order.
+
+entity tis_grid_cdc is
+	generic (
+		-- Grid, see tis_grid
+		rows         : positive               := 3;
+		cols         : positive               := 1;
+		stack_nodes  : std_logic_vector       := "101";
+		h_link_depth : integer_vector         := (0 => 0);
+		v_link_depth : integer_vector         := (0 => 0);
+		stack_length : natural                := 15;
+		stack_bram   : boolean                := false;
+		compact      : boolean                := false;
+		pc_width     : positive range 4 to 7  := 4;
+		broadcast    : boolean                := false;
+		counters     : boolean                := false;
+		status       : boolean                := false;
+		hot_swap     : boolean                := false;
+		handshake    : boolean                := false;
+		-- Nodes with breakpoints in tis_controller, from node 0
+		breakpoints  : natural range 0 to 48  := 0;
+		-- Commands in flight, 2 ** fifo_bits
+		fifo_bits    : positive range 1 to 8  := 2
+	);
+	port (
+		-- Avalon slave, on clock
+		clock, resetn : in  std_logic;
+		read, write   : in  std_logic;
+		address       : in  std_logic_vector(maximum(integer(ceil(log2(real(rows * cols)))) + pc_width - 1 + boolean'pos(counters) + boolean'pos(status) + boolean'pos(hot_swap), 6) downto 0);
+		readdata      : out std_logic_vector(31 downto 0);
+		writedata     : in  std_logic_vector(31 downto 0);
+		byteenable    : in  std_logic_vector(3 downto 0);
+		waitrequest   : out std_logic;
+		-- Interrupt when any stack node has data available for reading
+		irq           : out std_logic;
+
+		-- Clock of the grid and the controller, reset follows resetn
+		tis_clock     : in  std_logic;
+
+		-- Controller conduits, may be asynchronous to both clocks
+		tis_enable    : in  std_logic; -- Signal to enable TIS
+		tis_step_once : in  std_logic; -- Signal to step once despite disable
+		tis_active    : out std_logic  -- Whether TIS is currently enabled
+	);
+end entity;
+
+architecture rtl of tis_grid_cdc is
+	constant address_bits : positive := address'length;
+	-- Address bits of tis_grid, the controller takes 6
+	constant grid_bits    : positive := integer(ceil(log2(real(rows * cols)))) + pc_width - 1 + boolean'pos(counters) + boolean'pos(status) + boolean'pos(hot_swap);
+	-- Write flag, byteenable, writedata and address
+	constant command_bits : positive := 1 + 4 + 32 + address_bits;
+
+	-- Slave side
+	signal read_pending     : std_logic := '0'; -- Read command sent, waiting for the result
+	signal command_write    : std_logic;
+	signal command_full     : std_logic;
+	signal command_in       : std_logic_vector(command_bits - 1 downto 0);
+	signal response_read    : std_logic;
+	signal response_empty   : std_logic;
+	signal irq_meta         : std_logic := '0';
+	signal irq_sync         : std_logic := '0';
+	signal active_meta      : std_logic := '0';
+	signal active_sync      : std_logic := '0';
+
+	-- TIS side
+	signal tis_reset_meta   : std_logic := '0';
+	signal tis_resetn       : std_logic := '0';
+	signal enable_meta      : std_logic := '0';
+	signal enable_sync      : std_logic := '0';
+	signal step_meta        : std_logic := '0';
+	signal step_sync        : std_logic := '0';
+	signal command_read     : std_logic;
+	signal command_empty    : std_logic;
+	signal command_out      : std_logic_vector(command_bits - 1 downto 0);
+	signal capture          : std_logic := '0'; -- Grid readdata is valid, send it back
+
+	signal grid_read        : std_logic := '0';
+	signal grid_write       : std_logic := '0';
+	signal grid_address     : std_logic_vector(address_bits - 1 downto 0) := (others => '0');
+	signal grid_readdata    : std_logic_vector(31 downto 0);
+	signal grid_writedata   : std_logic_vector(31 downto 0) := (others => '0');
+	signal grid_byteenable  : std_logic_vector(3 downto 0) := (others => '0');
+	signal grid_irq         : std_logic;
+	signal grid_active      : std_logic;
+	signal grid_phase       : std_logic_vector(5 downto 0);
+	signal grid_debug_pc    : std_logic_vector(7 * rows * cols - 1 downto 0);
+	signal grid_selected    : std_logic; -- Replayed command is for the grid
+	signal control_read     : std_logic;
+	signal control_write    : std_logic;
+	signal control_readdata : std_logic_vector(15 downto 0);
+	signal response_data    : std_logic_vector(31 downto 0);
+begin
+
+	-- Slave side: writes are sent as soon as there is room, reads are sent
+	-- once and waited on until the result arrives
+	command_write <= (write or (read and not read_pending)) and not command_full;
+	command_in <= write & byteenable & writedata & address;
+	response_read <= read and read_pending and not response_empty;
+
+	waitrequest <= '0' when (write = '1' and command_full = '0') or response_read = '1' else
+	               '1' when read = '1' or write = '1' else
+	               '0';
+
+	irq <= irq_sync;
+	tis_active <= active_sync;
+
+	slave: process (clock, resetn)
+	begin
+		if resetn = '0' then
+			read_pending <= '0';
+			irq_meta <= '0';
+			irq_sync <= '0';
+			active_meta <= '0';
+			active_sync <= '0';
+		elsif rising_edge(clock) then
+			irq_meta <= grid_irq;
+			irq_sync <= irq_meta;
+			active_meta <= grid_active;
+			active_sync <= active_meta;
+
+			if read = '1' and read_pending = '0' and command_full = '0' then
+				read_pending <= '1';
+			elsif response_read = '1' then
+				read_pending <= '0';
+			end if;
+		end if;
+	end process;
+
+	commands: entity work.tis_dcfifo
+		generic map (
+			width      => command_bits,
+			depth_bits => fifo_bits
+		)
+		port map (
+			write_clock  => clock,
+			write_resetn => resetn,
+			write        => command_write,
+			write_data   => command_in,
+			full         => command_full,
+			read_clock   => tis_clock,
+			read_resetn  => tis_resetn,
+			read         => command_read,
+			read_data    => command_out,
+			empty        => command_empty
+		);
+
+	-- Only one read is outstanding, so the response FIFO never fills up
+	responses: entity work.tis_dcfifo
+		generic map (
+			width      => 32,
+			depth_bits => 1
+		)
+		port map (
+			write_clock  => tis_clock,
+			write_resetn => tis_resetn,
+			write        => capture,
+			write_data   => response_data,
+			full         => open,
+			read_clock   => clock,
+			read_resetn  => resetn,
+			read         => response_read,
+			read_data    => readdata,
+			empty        => response_empty
+		);
+
+	-- TIS side: reset is asserted right away and released on tis_clock
+	tis_reset: process (tis_clock, resetn)
+	begin
+		if resetn = '0' then
+			tis_reset_meta <= '0';
+			tis_resetn <= '0';
+		elsif rising_edge(tis_clock) then
+			tis_reset_meta <= '1';
+			tis_resetn <= tis_reset_meta;
+		end if;
+	end process;
+
+	-- Commands are replayed one per clock, a read keeps the address until
+	-- the registered readdata of the node was captured
+	command_read <= '1' when command_empty = '0' and grid_read = '0' and capture = '0' else '0';
+
+	tis_side: process (tis_clock, tis_resetn)
+	begin
+		if tis_resetn = '0' then
+			enable_meta <= '0';
+			enable_sync <= '0';
+			step_meta <= '0';
+			step_sync <= '0';
+			grid_read <= '0';
+			grid_write <= '0';
+			capture <= '0';
+		elsif rising_edge(tis_clock) then
+			enable_meta <= tis_enable;
+			enable_sync <= enable_meta;
+			step_meta <= tis_step_once;
+			step_sync <= step_meta;
+
+			capture <= grid_read;
+			grid_read <= '0';
+			grid_write <= '0';
+
+			if command_read = '1' then
+				grid_write <= command_out(command_bits - 1);
+				grid_read <= not command_out(command_bits - 1);
+				grid_byteenable <= command_out(command_bits - 2 downto command_bits - 5);
+				grid_writedata <= command_out(address_bits + 31 downto address_bits);
+				grid_address <= command_out(address_bits - 1 downto 0);
+			end if;
+		end if;
+	end process;
+
+	-- The address is kept while capturing, so it still selects the result
+	grid_selected <= not grid_address(address_bits - 1);
+	control_read <= grid_read and not grid_selected;
+	control_write <= grid_write and not grid_selected;
+	response_data <= grid_readdata when grid_selected = '1' else x"0000" & control_readdata;
+
+	controller: entity work.tis_controller
+		generic map (
+			nodes         => breakpoints
+		)
+		port map (
+			clock         => tis_clock,
+			resetn        => tis_resetn,
+			read          => control_read,
+			write         => control_write,
+			address       => grid_address(5 downto 0),
+			readdata      => control_readdata,
+			writedata     => grid_writedata(15 downto 0),
+			tis_enable    => enable_sync,
+			tis_step_once => step_sync,
+			tis_active    => grid_active,
+			tis_phase     => grid_phase,
+			debug_pc      => grid_debug_pc(7 * breakpoints - 1 downto 0)
+		);
+
+	grid: entity work.tis_grid
+		generic map (
+			rows         => rows,
+			cols         => cols,
+			stack_nodes  => stack_nodes,
+			h_link_depth => h_link_depth,
+			v_link_depth => v_link_depth,
+			stack_length => stack_length,
+			stack_bram   => stack_bram,
+			compact      => compact,
+			pc_width     => pc_width,
+			broadcast    => broadcast,
+			counters     => counters,
+			status       => status,
+			hot_swap     => hot_swap,
+			handshake    => handshake
+		)
+		port map (
+			clock      => tis_clock,
+			resetn     => tis_resetn,
+			read       => grid_read and grid_selected,
+			write      => grid_write and grid_selected,
+			address    => grid_address(grid_bits - 1 downto 0),
+			readdata   => grid_readdata,
+			writedata  => grid_writedata,
+			byteenable => grid_byteenable,
+			irq        => grid_irq,
+			tis_active => grid_active,
+			tis_phase  => grid_phase,
+			debug_pc   => grid_debug_pc
+		);
+end architecture;
@@ -0,0 +1,191 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_grid_cdc_tb is
+	generic (
+		-- Slave clock is 50 MHz, rerun with a slower TIS clock such as 53 ns
+		tis_period : time := 7 ns
+	);
+end entity;
+
+architecture rtl of tis_grid_cdc_tb is
+	constant clock_period : time    := 20 ns;
+	constant value_count  : natural := 12;
+
+	-- Word address of a register in the node at index (row * cols + col)
+	function NodeAddress(node : natural; word : natural) return natural is
+	begin
+		return node * 8 + word;
+	end function;
+
+	-- Word address of a tis_controller register, in the upper half
+	function ControlAddress(reg : natural) return natural is
+	begin
+		return 64 + reg;
+	end function;
+
+	-- Value pushed into the stack input at index i
+	function InputValue(i : natural) return integer is
+	begin
+		return i * 3 - 20;
+	end function;
+
+	-- Avalon slave signals
+	signal clock_tb       : std_logic := '0';
+	signal resetn_tb      : std_logic := '0';
+	signal read_tb        : std_logic := '0';
+	signal write_tb       : std_logic := '0';
+	signal address_tb     : std_logic_vector(6 downto 0) := (others => '0');
+	signal readdata_tb    : std_logic_vector(31 downto 0);
+	signal writedata_tb   : std_logic_vector(31 downto 0) := (others => '0');
+	signal byteenable_tb  : std_logic_vector(3 downto 0) := (others => '1');
+	signal waitrequest_tb : std_logic;
+	signal irq_tb         : std_logic;
+
+	-- TIS signals
+	signal tis_clock_tb      : std_logic := '0';
+	signal tis_enable_tb     : std_logic := '0';
+	signal tis_step_once_tb  : std_logic := '0';
+	signal tis_active_tb     : std_logic;
+begin
+	-- Same layout as tis_system: stack input, execution node, stack output
+	dut: entity work.tis_grid_cdc
+		generic map (
+			rows        => 3,
+			cols        => 1,
+			stack_nodes => "101"
+		)
+		port map (
+			clock         => clock_tb,
+			resetn        => resetn_tb,
+			read          => read_tb,
+			write         => write_tb,
+			address       => address_tb,
+			readdata      => readdata_tb,
+			writedata     => writedata_tb,
+			byteenable    => byteenable_tb,
+			waitrequest   => waitrequest_tb,
+			irq           => irq_tb,
+			tis_clock     => tis_clock_tb,
+			tis_enable    => tis_enable_tb,
+			tis_step_once => tis_step_once_tb,
+			tis_active    => tis_active_tb
+		);
+
+	-- Free running clocks without a common edge
+	clock_tb <= not clock_tb after clock_period / 2;
+	tis_clock_tb <= not tis_clock_tb after tis_period / 2;
+
+	-- Mock Avalon master, holds each access until waitrequest drops
+	process
+		variable data     : std_logic_vector(31 downto 0);
+		variable received : natural := 0;
+		variable polls    : natural := 0;
+		variable cycles   : natural := 0;
+
+		procedure AvalonWrite(
+				addr : natural;
+				value : std_logic_vector(31 downto 0);
+				be : std_logic_vector(3 downto 0)
+			) is
+		begin
+			address_tb <= std_logic_vector(to_unsigned(addr, address_tb'length));
+			writedata_tb <= value;
+			byteenable_tb <= be;
+			write_tb <= '1';
+			loop
+				wait until rising_edge(clock_tb);
+				exit when waitrequest_tb = '0';
+			end loop;
+			write_tb <= '0';
+		end procedure;
+
+		procedure AvalonRead(
+				addr : natural;
+				be : std_logic_vector(3 downto 0);
+				variable value : out std_logic_vector(31 downto 0)
+			) is
+		begin
+			address_tb <= std_logic_vector(to_unsigned(addr, address_tb'length));
+			byteenable_tb <= be;
+			read_tb <= '1';
+			loop
+				wait until rising_edge(clock_tb);
+				exit when waitrequest_tb = '0';
+			end loop;
+			value := readdata_tb;
+			read_tb <= '0';
+		end procedure;
+	begin
+		-- Reset
+		resetn_tb <= '0';
+		wait for 5 * clock_period;
+		wait until rising_edge(clock_tb);
+		resetn_tb <= '1';
+		wait for 5 * clock_period;
+		wait until rising_edge(clock_tb);
+
+		-- MOV UP, ACC / ADD ACC / MOV ACC, DOWN
+		AvalonWrite(NodeAddress(1, 0), x"C802" & x"0002", "1111");
+		AvalonWrite(NodeAddress(1, 1), x"D801" & x"0801", "1111");
+
+		-- Stack input writes to the grid, stack output reads from it
+		AvalonWrite(NodeAddress(0, 0), x"0000" & x"0001", "0011");
+		AvalonWrite(NodeAddress(2, 0), x"0000" & x"0002", "0011");
+
+		-- Reads wait behind the posted writes
+		AvalonRead(NodeAddress(1, 0), "1111", data);
+		assert data = x"C802" & x"0002" report "(1, 0) Failed to validate memory, got " & to_hstring(data) severity error;
+		AvalonRead(NodeAddress(1, 1), "1111", data);
+		assert data = x"D801" & x"0801" report "(1, 1) Failed to validate memory, got " & to_hstring(data) severity error;
+
+		-- Back to back pushes through the upper halfword
+		for i in 0 to value_count - 1 loop
+			AvalonWrite(NodeAddress(0, 0), std_logic_vector(to_signed(InputValue(i), 16)) & x"0000", "1100");
+		end loop;
+
+		tis_enable_tb <= '1';
+
+		-- Results arrive in order whatever the clock ratio
+		while received < value_count and polls < 1000 loop
+			AvalonRead(NodeAddress(2, 0), "1100", data);
+			polls := polls + 1;
+			if data(31 downto 16) /= x"FFFF" then
+				assert data(31 downto 16) = std_logic_vector(to_signed(2 * InputValue(received), 16)) report "Expected readdata " & to_string(2 * InputValue(received)) & ", got " & to_string(to_integer(signed(data(31 downto 16)))) severity error;
+				received := received + 1;
+			end if;
+		end loop;
+		assert received = value_count report "Expected " & to_string(value_count) & " results, got " & to_string(received) severity error;
+		assert tis_active_tb = '1' report "Expected tis_active high while enabled" severity error;
+
+		-- Disable, the last cycle completes before tis_active drops
+		tis_enable_tb <= '0';
+		wait for 20 * (clock_period + tis_period);
+		wait until rising_edge(clock_tb);
+		assert tis_active_tb = '0' report "Expected tis_active low afer disabling" severity error;
+		assert irq_tb = '0' report "Got interrupt after draining both stacks" severity error;
+
+		-- Controller registers go through the same FIFOs, run for 5 cycles
+		AvalonRead(ControlAddress(4), "1111", data);
+		cycles := to_integer(unsigned(data(15 downto 0)));
+		assert cycles > 0 report "Expected completed cycles after running" severity error;
+		AvalonWrite(ControlAddress(8), x"00000005", "1111");
+		AvalonWrite(ControlAddress(0), x"00000008", "1111");
+
+		polls := 0;
+		AvalonRead(ControlAddress(0), "1111", data);
+		while data(3) = '1' and polls < 100 loop
+			AvalonRead(ControlAddress(0), "1111", data);
+			polls := polls + 1;
+		end loop;
+		assert data(3) = '0' report "Controller kept running past the run cycles" severity error;
+
+		AvalonRead(ControlAddress(4), "1111", data);
+		assert to_integer(unsigned(data(15 downto 0))) = cycles + 5 report "Expected " & to_string(cycles + 5) & " completed cycles, got " & to_string(to_integer(unsigned(data(15 downto 0)))) severity error;
+		assert data(31 downto 16) = x"0000" report "Controller readdata has upper bits set" severity error;
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
@@ -0,0 +1,236 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_grid_tb is
+end entity;
+
+architecture rtl of tis_grid_tb is
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Full TIS I/O Cycle
+	procedure TisPulse(signal clk : inout std_logic) is
+	begin
+		-- Each cycle needs 6 rising edges
+		for i in 1 to 6 loop
+			wait for 1 ns;
+			clk <= '0';
+			wait for 1 ns;
+			clk <= '1';
+		end loop;
+
+		wait for 1 ns;
+	end procedure;
+
+	-- Word address of a register in the node at index (row * cols + col)
+	function NodeAddress(node : natural; word : natural) return std_logic_vector is
+	begin
+		return std_logic_vector(to_unsigned(node * 8 + word, 5));
+	end function;
+
+	-- Avalon slave signals
+	signal clock_tb      : std_logic;
+	signal resetn_tb     : std_logic;
+	signal read_tb       : std_logic;
+	signal write_tb      : std_logic;
+	signal address_tb    : std_logic_vector(4 downto 0);
+	signal readdata_tb   : std_logic_vector(31 downto 0);
+	signal writedata_tb  : std_logic_vector(31 downto 0);
+	signal byteenable_tb : std_logic_vector(3 downto 0);
+	signal irq_tb        : std_logic;
+
+	-- Same grid built from compact nodes
+	signal compact_readdata_tb : std_logic_vector(31 downto 0);
+	signal compact_irq_tb      : std_logic;
+
+	-- Same grid with valid/ready handshakes
+	signal handshake_readdata_tb : std_logic_vector(31 downto 0);
+	signal handshake_irq_tb      : std_logic;
+
+	-- TIS signals
+	signal tis_active_tb : std_logic;
+	signal tis_phase_tb  : std_logic_vector(5 downto 0) := "000001";
+begin
+	-- Same layout as tis_system: stack input, execution node, stack output
+	grid: entity work.tis_grid
+		generic map (
+			rows        => 3,
+			cols        => 1,
+			stack_nodes => "101"
+		)
+		port map (
+			clock      => clock_tb,
+			resetn     => resetn_tb,
+			read       => read_tb,
+			write      => write_tb,
+			address    => address_tb,
+			readdata   => readdata_tb,
+			writedata  => writedata_tb,
+			byteenable => byteenable_tb,
+			irq        => irq_tb,
+			tis_active => tis_active_tb
+		);
+
+	compact_grid: entity work.tis_grid
+		generic map (
+			rows        => 3,
+			cols        => 1,
+			stack_nodes => "101",
+			compact     => true
+		)
+		port map (
+			clock      => clock_tb,
+			resetn     => resetn_tb,
+			read       => read_tb,
+			write      => write_tb,
+			address    => address_tb,
+			readdata   => compact_readdata_tb,
+			writedata  => writedata_tb,
+			byteenable => byteenable_tb,
+			irq        => compact_irq_tb,
+			tis_active => tis_active_tb,
+			tis_phase  => tis_phase_tb
+		);
+
+	handshake_grid: entity work.tis_grid
+		generic map (
+			rows        => 3,
+			cols        => 1,
+			stack_nodes => "101",
+			handshake   => true
+		)
+		port map (
+			clock      => clock_tb,
+			resetn     => resetn_tb,
+			read       => read_tb,
+			write      => write_tb,
+			address    => address_tb,
+			readdata   => handshake_readdata_tb,
+			writedata  => writedata_tb,
+			byteenable => byteenable_tb,
+			irq        => handshake_irq_tb,
+			tis_active => tis_active_tb
+		);
+
+	-- Phase bus as driven by tis_controller
+	phase: process (clock_tb)
+	begin
+		if rising_edge(clock_tb) and tis_active_tb = '1' then
+			tis_phase_tb <= tis_phase_tb(4 downto 0) & tis_phase_tb(5);
+		end if;
+	end process;
+
+	process
+	begin
+		-- Reset
+		clock_tb <= '0';
+		resetn_tb <= '0';
+		read_tb <= '0';
+		write_tb <= '0';
+		tis_active_tb <= '0';
+		byteenable_tb <= (others => '1');
+		writedata_tb <= (others => '0');
+		address_tb <= (others => '0');
+		ClockPulse(clock_tb);
+		resetn_tb <= '1';
+		ClockPulse(clock_tb);
+
+		-- Node Header (15 downto 0)
+		-- 0 MOV UP, ACC (31 downto 16)
+		write_tb <= '1';
+		address_tb <= NodeAddress(1, 0);
+		writedata_tb <= x"C802" & x"0002";
+		ClockPulse(clock_tb);
+
+		-- 1 ADD ACC (15 downto 0)
+		-- 2 MOV ACC, DOWN (31 downto 16)
+		address_tb <= NodeAddress(1, 1);
+		writedata_tb <= x"D801" & x"0801";
+		ClockPulse(clock_tb);
+
+		-- Stack input writes to the grid, stack output reads from it
+		byteenable_tb <= "0011";
+		address_tb <= NodeAddress(0, 0);
+		writedata_tb <= x"0000" & x"0001";
+		ClockPulse(clock_tb);
+
+		address_tb <= NodeAddress(2, 0);
+		writedata_tb <= x"0000" & x"0002";
+		ClockPulse(clock_tb);
+
+		-- Push 21 through the upper halfword
+		byteenable_tb <= "1100";
+		address_tb <= NodeAddress(0, 0);
+		writedata_tb <= std_logic_vector(to_signed(21, 16)) & x"0000";
+		ClockPulse(clock_tb);
+		write_tb <= '0';
+
+		-- Validate decoding of the execution node
+		read_tb <= '1';
+		byteenable_tb <= (others => '1');
+		address_tb <= NodeAddress(1, 0);
+		ClockPulse(clock_tb);
+		assert readdata_tb = x"C802" & x"0002" report "(1, 0) Failed to validate memory" severity error;
+		assert compact_readdata_tb = x"C802" & x"0002" report "(1, 0) Failed to validate compact memory" severity error;
+
+		address_tb <= NodeAddress(1, 1);
+		ClockPulse(clock_tb);
+		assert readdata_tb = x"D801" & x"0801" report "(1, 1) Failed to validate memory" severity error;
+		assert compact_readdata_tb = x"D801" & x"0801" report "(1, 1) Failed to validate compact memory" severity error;
+
+		-- Back-to-back reads of two nodes, data follows the earlier address
+		address_tb <= NodeAddress(1, 0);
+		ClockPulse(clock_tb);
+		byteenable_tb <= "0011";
+		address_tb <= NodeAddress(0, 0);
+		wait for 1 ns;
+		assert readdata_tb = x"C802" & x"0002" report "(1, 0) Got data of the next read, " & to_string(readdata_tb) severity error;
+		assert compact_readdata_tb = x"C802" & x"0002" report "(1, 0) Got compact data of the next read, " & to_string(compact_readdata_tb) severity error;
+		ClockPulse(clock_tb);
+		assert readdata_tb = x"0001" & x"0001" report "(0, 0) Expected stack config 1, got " & to_string(readdata_tb) severity error;
+		assert compact_readdata_tb = x"0001" & x"0001" report "(0, 0) Expected compact stack config 1, got " & to_string(compact_readdata_tb) severity error;
+		byteenable_tb <= (others => '1');
+		read_tb <= '0';
+
+		assert irq_tb = '1' report "Didn't get interrupt from value in stack input" severity error;
+
+		-- MOV UP, ACC / ADD ACC / MOV ACC, DOWN
+		tis_active_tb <= '1';
+
+		-- Handshakes take a clock per instruction and wait at most 3 clocks
+		-- for the slot of a stack port, the phases need a cycle per instruction
+		for i in 1 to 2 loop
+			TisPulse(clock_tb);
+		end loop;
+		assert handshake_irq_tb = '1' report "Didn't get interrupt from value in handshake stack output" severity error;
+
+		for i in 3 to 8 loop
+			TisPulse(clock_tb);
+		end loop;
+		tis_active_tb <= '0';
+
+		assert irq_tb = '1' report "Didn't get interrupt from value in stack output" severity error;
+		assert compact_irq_tb = '1' report "Didn't get interrupt from value in compact stack output" severity error;
+
+		-- Pop the result through the upper halfword
+		read_tb <= '1';
+		byteenable_tb <= "1100";
+		address_tb <= NodeAddress(2, 0);
+		ClockPulse(clock_tb);
+		read_tb <= '0';
+		assert readdata_tb(31 downto 16) = std_logic_vector(to_signed(42, 16)) report "Expected readdata 42, got " & to_string(readdata_tb(31 downto 16)) severity error;
+		assert compact_readdata_tb(31 downto 16) = std_logic_vector(to_signed(42, 16)) report "Expected compact readdata 42, got " & to_string(compact_readdata_tb(31 downto 16)) severity error;
+		assert handshake_readdata_tb(31 downto 16) = std_logic_vector(to_signed(42, 16)) report "Expected handshake readdata 42, got " & to_string(handshake_readdata_tb(31 downto 16)) severity error;
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
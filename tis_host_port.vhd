@@ -0,0 +1,205 @@
+-- altera vhdl_input_version vhdl_2008
+library IEEE;
+	use IEEE.std_logic_1164.all;
+	use IEEE.numeric_std.all;
+
+	-- Lets the CPU take the place of a neighbour on a free side of an edge
+	-- node. Towards the node it holds one value per direction and takes part
+	-- in the rendezvous in the same phases as a node would, so a value needs
+	-- no stack node in between. Registers of the slave:
+	--   word 0: data. Reads wait for a value from the node and writes wait
+	--           until the node took the previous value, using waitrequest.
+	--   word 1: status, bit 0 value from the node available, bit 1 space for
+	--           a value to the node (read)
+	--   word 2: interrupt enable, same bits as the status (read/write)
+	--   word 3: clocks between the last write to data and the next value
+	--           from the node, the round trip through the grid (read)
+	-- Reads have no latency. Only the phased protocol is supported, not the
+	-- HANDSHAKE mode of tis_execution_node.
+
+entity tis_host_port is
+	generic (
+		-- Side of the node the port sits on, like tis_link
+		horizontal : boolean := false;
+		-- Port is side A, left of or above the node, instead of side B
+		side_a     : boolean := false
+	);
+	port (
+		clock, resetn : in  std_logic;
+		read, write   : in  std_logic;
+		address       : in  std_logic_vector(1 downto 0);
+		readdata      : out std_logic_vector(31 downto 0);
+		writedata     : in  std_logic_vector(31 downto 0);
+		waitrequest   : out std_logic;
+		-- Interrupt on the enabled status bits
+		irq           : out std_logic;
+		-- Used to stay in sync with the nodes
+		tis_active    : in  std_logic;
+		-- Conduit of the node facing the port
+		i_node        : in  std_logic_vector(10 downto 0);
+		i_node_active : in  std_logic := '0';
+		o_node        : out std_logic_vector(10 downto 0);
+		o_node_active : out std_logic
+	);
+end entity;
+
+architecture rtl of tis_host_port is
+	type tis_state is (TIS_RUN, TIS_LEFT, TIS_RIGHT, TIS_UP, TIS_DOWN, TIS_FINISH);
+
+	signal node_state : tis_state := TIS_RUN;
+
+	subtype tis_integer is integer range - 999 to 999;
+
+	pure function to_tis_integer(a : signed) return tis_integer is
+	begin
+		if to_integer(a) > 999 then
+			return 999;
+		elsif to_integer(a) < - 999 then
+			return - 999;
+		else
+			return to_integer(a);
+		end if;
+	end function;
+
+	-- Phases in which side A writes to side B and the other way around,
+	-- see tis_link
+	pure function WritePhase(is_horizontal : boolean; from_a : boolean) return tis_state is
+	begin
+		if is_horizontal then
+			if from_a then
+				return TIS_LEFT;
+			else
+				return TIS_RIGHT;
+			end if;
+		elsif from_a then
+			return TIS_UP;
+		else
+			return TIS_DOWN;
+		end if;
+	end function;
+
+	constant to_node_phase   : tis_state := WritePhase(horizontal, side_a);
+	constant from_node_phase : tis_state := WritePhase(horizontal, not side_a);
+
+	signal tx_value : std_logic_vector(10 downto 0) := (others => '0');
+	signal tx_full  : std_logic := '0';
+	signal rx_value : std_logic_vector(10 downto 0) := (others => '0');
+	signal rx_full  : std_logic := '0';
+	signal offer    : std_logic := '0'; -- Writing to the node
+	signal accept   : std_logic := '0'; -- Reading from the node
+
+	signal status     : std_logic_vector(1 downto 0);
+	signal irq_enable : std_logic_vector(1 downto 0) := (others => '0');
+	signal data_read  : boolean;
+	signal data_write : boolean;
+
+	-- Round trip measurement
+	signal timing     : std_logic := '0';
+	signal clocks     : unsigned(31 downto 0) := (others => '0');
+	signal round_trip : unsigned(31 downto 0) := (others => '0');
+begin
+
+	o_node <= tx_value;
+	o_node_active <= offer or accept;
+
+	status <= (not tx_full) & rx_full;
+	irq <= '0' when (status and irq_enable) = "00" else '1';
+
+	-- Data accesses that go through on this clock
+	data_read <= read = '1' and unsigned(address) = 0 and rx_full = '1';
+	data_write <= write = '1' and unsigned(address) = 0 and tx_full = '0';
+
+	waitrequest <= '1' when unsigned(address) = 0 and ((read = '1' and rx_full = '0') or (write = '1' and tx_full = '1')) else '0';
+
+	with to_integer(unsigned(address)) select readdata <=
+		std_logic_vector(resize(signed(rx_value), readdata'length)) when 0,
+		std_logic_vector(resize(unsigned(status), readdata'length)) when 1,
+		std_logic_vector(resize(unsigned(irq_enable), readdata'length)) when 2,
+		std_logic_vector(round_trip) when others;
+
+	sequencer: process (clock, resetn)
+	begin
+		if resetn = '0' then
+			node_state <= TIS_RUN;
+		elsif rising_edge(clock) then
+			if tis_active = '1' then
+				case node_state is
+					when TIS_RUN =>
+						node_state <= TIS_LEFT;
+					when TIS_LEFT =>
+						node_state <= TIS_RIGHT;
+					when TIS_RIGHT =>
+						node_state <= TIS_UP;
+					when TIS_UP =>
+						node_state <= TIS_DOWN;
+					when TIS_DOWN =>
+						node_state <= TIS_FINISH;
+					when TIS_FINISH =>
+						node_state <= TIS_RUN;
+				end case;
+			end if;
+		end if;
+	end process;
+
+	process (clock, resetn)
+	begin
+		if resetn = '0' then
+			tx_value <= (others => '0');
+			tx_full <= '0';
+			rx_value <= (others => '0');
+			rx_full <= '0';
+			offer <= '0';
+			accept <= '0';
+			irq_enable <= (others => '0');
+			timing <= '0';
+			clocks <= (others => '0');
+			round_trip <= (others => '0');
+		elsif rising_edge(clock) then
+			if write = '1' and unsigned(address) = 2 then
+				irq_enable <= writedata(1 downto 0);
+			end if;
+
+			if data_read then
+				rx_full <= '0';
+			end if;
+
+			if timing = '1' then
+				clocks <= clocks + 1;
+			end if;
+
+			if tis_active = '1' then
+				-- Results of the offers made during the previous clock
+				if offer = '1' and i_node_active = '1' then
+					tx_full <= '0';
+				end if;
+
+				if accept = '1' and i_node_active = '1' then
+					rx_value <= i_node;
+					rx_full <= '1';
+					if timing = '1' then
+						timing <= '0';
+						round_trip <= clocks + 1;
+					end if;
+				end if;
+
+				-- Offer during the phase of each direction, like a node would
+				offer <= '0';
+				accept <= '0';
+				if node_state = to_node_phase and tx_full = '1' then
+					offer <= '1';
+				end if;
+				if node_state = from_node_phase and rx_full = '0' then
+					accept <= '1';
+				end if;
+			end if;
+
+			-- A new value restarts the round trip
+			if data_write then
+				tx_value <= std_logic_vector(to_signed(to_tis_integer(signed(writedata)), tx_value'length));
+				tx_full <= '1';
+				timing <= '1';
+				clocks <= (others => '0');
+			end if;
+		end if;
+	end process;
+end architecture;
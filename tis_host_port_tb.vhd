@@ -0,0 +1,197 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_host_port_tb is
+end entity;
+
+architecture rtl of tis_host_port_tb is
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	signal clock_tb  : std_logic := '0';
+	signal resetn_tb : std_logic := '1';
+
+	-- Execution node slave
+	signal node_write_tb     : std_logic := '0';
+	signal node_address_tb   : std_logic_vector(2 downto 0) := (others => '0');
+	signal node_writedata_tb : std_logic_vector(31 downto 0) := (others => '0');
+
+	-- Host port slave
+	signal read_tb        : std_logic := '0';
+	signal write_tb       : std_logic := '0';
+	signal address_tb     : std_logic_vector(1 downto 0) := (others => '0');
+	signal readdata_tb    : std_logic_vector(31 downto 0);
+	signal writedata_tb   : std_logic_vector(31 downto 0) := (others => '0');
+	signal waitrequest_tb : std_logic;
+	signal irq_tb         : std_logic;
+
+	signal tis_active_tb : std_logic := '0';
+
+	-- DOWN conduit of the node, the port sits below it
+	signal o_down_tb        : std_logic_vector(10 downto 0);
+	signal o_down_active_tb : std_logic;
+	signal i_down_tb        : std_logic_vector(10 downto 0);
+	signal i_down_active_tb : std_logic;
+begin
+
+	node: entity work.tis_execution_node
+		port map (
+			clock          => clock_tb,
+			resetn         => resetn_tb,
+			read           => '0',
+			write          => node_write_tb,
+			address        => node_address_tb,
+			readdata       => open,
+			writedata      => node_writedata_tb,
+			byteenable     => (others => '1'),
+			Q_export       => open,
+			tis_active     => tis_active_tb,
+			i_left         => (others => '0'),
+			o_left         => open,
+			o_left_active  => open,
+			o_left_ready   => open,
+			i_right        => (others => '0'),
+			o_right        => open,
+			o_right_active => open,
+			o_right_ready  => open,
+			i_up           => (others => '0'),
+			o_up           => open,
+			o_up_active    => open,
+			o_up_ready     => open,
+			i_down         => i_down_tb,
+			i_down_active  => i_down_active_tb,
+			o_down         => o_down_tb,
+			o_down_active  => o_down_active_tb,
+			o_down_ready   => open,
+			debug_acc      => open,
+			debug_bak      => open,
+			debug_pc       => open
+		);
+
+	port_below: entity work.tis_host_port
+		port map (
+			clock         => clock_tb,
+			resetn        => resetn_tb,
+			read          => read_tb,
+			write         => write_tb,
+			address       => address_tb,
+			readdata      => readdata_tb,
+			writedata     => writedata_tb,
+			waitrequest   => waitrequest_tb,
+			irq           => irq_tb,
+			tis_active    => tis_active_tb,
+			i_node        => o_down_tb,
+			i_node_active => o_down_active_tb,
+			o_node        => i_down_tb,
+			o_node_active => i_down_active_tb
+		);
+
+	process
+		variable data    : std_logic_vector(31 downto 0);
+		variable start   : time;
+		variable latency : natural;
+
+		-- Avalon transfers that hold the request until waitrequest drops
+		procedure WritePort(reg : natural; value : integer) is
+			variable done : boolean := false;
+		begin
+			address_tb <= std_logic_vector(to_unsigned(reg, address_tb'length));
+			writedata_tb <= std_logic_vector(to_signed(value, writedata_tb'length));
+			write_tb <= '1';
+			for i in 1 to 100 loop
+				wait for 1 ns;
+				done := waitrequest_tb = '0';
+				ClockPulse(clock_tb);
+				exit when done;
+			end loop;
+			write_tb <= '0';
+			assert done report "Write to the host port never completed" severity failure;
+		end procedure;
+
+		procedure ReadPort(reg : natural; value : out std_logic_vector(31 downto 0)) is
+			variable done : boolean := false;
+		begin
+			address_tb <= std_logic_vector(to_unsigned(reg, address_tb'length));
+			read_tb <= '1';
+			for i in 1 to 100 loop
+				wait for 1 ns;
+				done := waitrequest_tb = '0';
+				value := readdata_tb;
+				ClockPulse(clock_tb);
+				exit when done;
+			end loop;
+			read_tb <= '0';
+			assert done report "Read from the host port never completed" severity failure;
+		end procedure;
+	begin
+		-- Reset
+		resetn_tb <= '0';
+		ClockPulse(clock_tb);
+		resetn_tb <= '1';
+		ClockPulse(clock_tb);
+
+		-- Node Header (15 downto 0)
+		-- 0 MOV DOWN, ACC (31 downto 16), (Prefix number is PC)
+		node_write_tb <= '1';
+		node_address_tb <= std_logic_vector(to_unsigned(0, node_address_tb'length));
+		node_writedata_tb <= x"C803" & x"0002";
+		ClockPulse(clock_tb);
+
+		-- 1 ADD 1 (15 downto 0)
+		-- 2 MOV ACC, DOWN (31 downto 16)
+		node_address_tb <= std_logic_vector(to_unsigned(1, node_address_tb'length));
+		node_writedata_tb <= x"D801" & x"0001";
+		ClockPulse(clock_tb);
+		node_write_tb <= '0';
+
+		-- Room for a value, nothing to read
+		ReadPort(1, data);
+		assert data = x"00000002" report "Expected status 2, got " & to_string(data) severity error;
+
+		-- Interrupt once the answer is there
+		WritePort(2, 1);
+		assert irq_tb = '0' report "Got interrupt without a value" severity error;
+
+		tis_active_tb <= '1';
+		start := now;
+		WritePort(0, 5);
+
+		-- Blocks until the node answers
+		ReadPort(1, data);
+		while data(0) = '0' and now - start < 300 ns loop
+			ReadPort(1, data);
+		end loop;
+		assert irq_tb = '1' report "Didn't get interrupt for the answer" severity error;
+		ReadPort(0, data);
+		latency := (now - start) / 3 ns;
+		assert signed(data) = 6 report "Expected 6 from the node, got " & to_string(to_integer(signed(data))) severity error;
+		assert irq_tb = '0' report "Interrupt stayed after reading the answer" severity error;
+
+		ReadPort(3, data);
+		report "Round trip of " & to_string(to_integer(unsigned(data))) & " clocks, " & to_string(latency) & " clocks from write to read" severity note;
+		assert to_integer(unsigned(data)) > 0 and to_integer(unsigned(data)) <= latency report "Round trip out of range: " & to_string(to_integer(unsigned(data))) severity error;
+
+		-- Second request with the node already waiting, the value is clamped.
+		-- The blocking read takes the answer as soon as it arrives.
+		start := now;
+		WritePort(0, - 2000);
+		ReadPort(0, data);
+		latency := (now - start) / 3 ns;
+		assert signed(data) = - 998 report "Expected -998 from the node, got " & to_string(to_integer(signed(data))) severity error;
+		report "Blocking round trip of " & to_string(latency) & " clocks" severity note;
+
+		ReadPort(3, data);
+		assert to_integer(unsigned(data)) < latency report "Round trip out of range: " & to_string(to_integer(unsigned(data))) severity error;
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
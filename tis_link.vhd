@@ -0,0 +1,203 @@
+-- altera vhdl_input_version vhdl_2008
+library IEEE;
+	use IEEE.std_logic_1164.all;
+	use IEEE.numeric_std.all;
+
+	-- Connection between the facing conduits of two adjacent nodes.
+	-- Side A is the left (or upper) node and side B the right (or lower) node.
+	-- With a depth of 0 the conduits are wired straight through, otherwise each
+	-- direction gets a FIFO that reads from the writer and writes to the reader
+	-- in the same phases a node would.
+	-- With HANDSHAKE the links follow the ready/valid protocol of
+	-- tis_execution_node instead: unbuffered links also pass the ready flags
+	-- through and each FIFO takes a value whenever it has room and hands one
+	-- on whenever the reader is ready, independent of the TIS phases.
+
+entity tis_link is
+	generic (
+		-- Values buffered per direction, 0 keeps the unbuffered TIS-100 rendezvous
+		depth      : natural := 0;
+		-- LEFT/RIGHT phases for a horizontal link, UP/DOWN phases otherwise
+		horizontal : boolean := true;
+		-- Ready/valid protocol of the HANDSHAKE execution nodes
+		HANDSHAKE  : boolean := false
+	);
+	port (
+		clock, resetn : in  std_logic;
+		-- Used to stay in sync with the nodes
+		tis_active    : in  std_logic;
+		-- Side A conduit, o_right or o_down of the node on side A
+		i_a           : in  std_logic_vector(10 downto 0);
+		i_a_active    : in  std_logic := '0';
+		o_a           : out std_logic_vector(10 downto 0);
+		o_a_active    : out std_logic;
+		i_a_ready     : in  std_logic := '0';
+		o_a_ready     : out std_logic;
+		-- Side B conduit, o_left or o_up of the node on side B
+		i_b           : in  std_logic_vector(10 downto 0);
+		i_b_active    : in  std_logic := '0';
+		o_b           : out std_logic_vector(10 downto 0);
+		o_b_active    : out std_logic;
+		i_b_ready     : in  std_logic := '0';
+		o_b_ready     : out std_logic
+	);
+end entity;
+
+architecture rtl of tis_link is
+	type tis_state is (TIS_RUN, TIS_LEFT, TIS_RIGHT, TIS_UP, TIS_DOWN, TIS_FINISH);
+
+	signal node_state : tis_state := TIS_RUN; -- Write/Read direction of nodes
+
+	-- Per direction, 0 is A to B and 1 is B to A
+	type direction_phases is array (0 to 1) of tis_state;
+	type direction_values is array (0 to 1) of std_logic_vector(10 downto 0);
+
+	pure function LinkPhases(is_horizontal : boolean) return direction_phases is
+	begin
+		if is_horizontal then
+			-- Write RIGHT during TIS_LEFT, write LEFT during TIS_RIGHT
+			return (TIS_LEFT, TIS_RIGHT);
+		else
+			-- Write DOWN during TIS_UP, write UP during TIS_DOWN
+			return (TIS_UP, TIS_DOWN);
+		end if;
+	end function;
+
+	constant phases : direction_phases := LinkPhases(horizontal);
+
+	signal src_value  : direction_values;
+	signal src_active : std_logic_vector(0 to 1);
+	signal dst_active : std_logic_vector(0 to 1);
+	signal dst_ready  : std_logic_vector(0 to 1);
+	signal room       : std_logic_vector(0 to 1); -- HANDSHAKE, FIFO can take a value
+	signal waiting    : std_logic_vector(0 to 1); -- HANDSHAKE, FIFO holds a value
+	signal head_value : direction_values                 := (others => (others => '0'));
+	signal accept     : std_logic_vector(0 to 1)         := (others => '0'); -- Reading from the writer
+	signal offer      : std_logic_vector(0 to 1)         := (others => '0'); -- Writing to the reader
+begin
+
+	unbuffered: if depth = 0 generate
+		o_a <= i_b;
+		o_a_active <= i_b_active;
+		o_b <= i_a;
+		o_b_active <= i_a_active;
+		o_a_ready <= i_b_ready;
+		o_b_ready <= i_a_ready;
+	end generate;
+
+	buffered: if depth > 0 generate
+		src_value(0) <= i_a;
+		src_active(0) <= i_a_active;
+		dst_active(0) <= i_b_active;
+		dst_ready(0) <= i_b_ready;
+
+		src_value(1) <= i_b;
+		src_active(1) <= i_b_active;
+		dst_active(1) <= i_a_active;
+		dst_ready(1) <= i_a_ready;
+
+		-- Each direction only drives its side during the clock after its phase
+		o_a_active <= waiting(1) when HANDSHAKE else accept(0) or offer(1);
+		o_b_active <= waiting(0) when HANDSHAKE else accept(1) or offer(0);
+		o_a_ready <= room(0) when HANDSHAKE else '0';
+		o_b_ready <= room(1) when HANDSHAKE else '0';
+		o_a <= head_value(1);
+		o_b <= head_value(0);
+
+		process (clock, resetn)
+		begin
+			if resetn = '0' then
+				node_state <= TIS_RUN;
+			elsif rising_edge(clock) then
+				if tis_active = '1' then
+					case node_state is
+						when TIS_RUN =>
+							node_state <= TIS_LEFT;
+						when TIS_LEFT =>
+							node_state <= TIS_RIGHT;
+						when TIS_RIGHT =>
+							node_state <= TIS_UP;
+						when TIS_UP =>
+							node_state <= TIS_DOWN;
+						when TIS_DOWN =>
+							node_state <= TIS_FINISH;
+						when TIS_FINISH =>
+							node_state <= TIS_RUN;
+					end case;
+				end if;
+			end if;
+		end process;
+
+		fifos: for d in 0 to 1 generate
+			type fifo is array (0 to depth - 1) of std_logic_vector(10 downto 0);
+			signal values   : fifo;
+			signal head_ptr : integer range 0 to depth - 1 := 0; -- Next value written to the reader
+			signal tail_ptr : integer range 0 to depth - 1 := 0; -- Next free entry
+			signal count    : integer range 0 to depth     := 0;
+		begin
+			head_value(d) <= values(head_ptr);
+			room(d) <= '1' when count < depth else '0';
+			waiting(d) <= '1' when count > 0 else '0';
+
+			process (clock, resetn)
+				variable push, pop : boolean;
+			begin
+				if resetn = '0' then
+					accept(d) <= '0';
+					offer(d) <= '0';
+					head_ptr <= 0;
+					tail_ptr <= 0;
+					count <= 0;
+				elsif rising_edge(clock) then
+					if tis_active = '1' then
+						if HANDSHAKE then
+							-- Transfers of this clock, the offers only depend on count
+							push := room(d) = '1' and src_active(d) = '1';
+							pop := waiting(d) = '1' and dst_ready(d) = '1';
+						else
+							-- Results of the offers made during the previous clock
+							push := accept(d) = '1' and src_active(d) = '1';
+							pop := offer(d) = '1' and dst_active(d) = '1';
+						end if;
+
+						if push then
+							values(tail_ptr) <= src_value(d);
+							if tail_ptr = depth - 1 then
+								tail_ptr <= 0;
+							else
+								tail_ptr <= tail_ptr + 1;
+							end if;
+						end if;
+
+						if pop then
+							if head_ptr = depth - 1 then
+								head_ptr <= 0;
+							else
+								head_ptr <= head_ptr + 1;
+							end if;
+						end if;
+
+						if push and not pop then
+							count <= count + 1;
+						elsif pop and not push then
+							count <= count - 1;
+						end if;
+
+						-- Offer to both nodes during the phase of this direction.
+						-- A value read in this phase can be written from the next cycle on.
+						accept(d) <= '0';
+						offer(d) <= '0';
+						if node_state = phases(d) and not HANDSHAKE then
+							if count < depth then
+								accept(d) <= '1';
+							end if;
+							if count > 0 then
+								offer(d) <= '1';
+							end if;
+						end if;
+					end if;
+				end if;
+			end process;
+		end generate;
+	end generate;
+end architecture;
@@ -0,0 +1,206 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_link_tb is
+end entity;
+
+architecture rtl of tis_link_tb is
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Full TIS I/O Cycle
+	procedure TisPulse(signal clk : inout std_logic) is
+	begin
+		-- Each cycle needs 6 rising edges
+		for i in 1 to 6 loop
+			wait for 1 ns;
+			clk <= '0';
+			wait for 1 ns;
+			clk <= '1';
+		end loop;
+
+		wait for 1 ns;
+	end procedure;
+
+	-- Pipelines with an unbuffered link and with a 4 deep link
+	type depths is array (0 to 1) of natural;
+	constant link_depth : depths := (0, 4);
+
+	type conduit_values is array (0 to 1) of std_logic_vector(10 downto 0);
+
+	-- Values counted by the consumer
+	constant item_count : natural := 20;
+
+	-- Avalon slave signals
+	signal clock_tb         : std_logic;
+	signal resetn_tb        : std_logic;
+	signal write_producer   : std_logic;
+	signal write_consumer   : std_logic;
+	signal address_tb       : std_logic_vector(2 downto 0);
+	signal writedata_tb     : std_logic_vector(31 downto 0);
+	signal byteenable_tb    : std_logic_vector(3 downto 0);
+	signal idle_tb          : std_logic_vector(10 downto 0) := (others => '0');
+
+	-- TIS signals
+	signal tis_active_tb : std_logic;
+	-- Producer RIGHT conduit to the link
+	signal producer_value  : conduit_values;
+	signal producer_active : std_logic_vector(0 to 1);
+	signal link_a_value    : conduit_values;
+	signal link_a_active   : std_logic_vector(0 to 1);
+	-- Consumer LEFT conduit to the link
+	signal consumer_value  : conduit_values;
+	signal consumer_active : std_logic_vector(0 to 1);
+	signal link_b_value    : conduit_values;
+	signal link_b_active   : std_logic_vector(0 to 1);
+	-- Consumer ACC, counts the received values
+	signal consumer_acc : conduit_values;
+begin
+	pipelines: for i in 0 to 1 generate
+		producer: entity work.tis_execution_node
+			port map (
+				clock          => clock_tb,
+				resetn         => resetn_tb,
+				read           => '0',
+				write          => write_producer,
+				address        => address_tb,
+				writedata      => writedata_tb,
+				byteenable     => byteenable_tb,
+				tis_active     => tis_active_tb,
+				i_left         => idle_tb,
+				i_right        => link_a_value(i),
+				i_right_active => link_a_active(i),
+				o_right        => producer_value(i),
+				o_right_active => producer_active(i),
+				i_up           => idle_tb,
+				i_down         => idle_tb
+			);
+
+		link: entity work.tis_link
+			generic map (
+				depth      => link_depth(i),
+				horizontal => true
+			)
+			port map (
+				clock      => clock_tb,
+				resetn     => resetn_tb,
+				tis_active => tis_active_tb,
+				i_a        => producer_value(i),
+				i_a_active => producer_active(i),
+				o_a        => link_a_value(i),
+				o_a_active => link_a_active(i),
+				i_b        => consumer_value(i),
+				i_b_active => consumer_active(i),
+				o_b        => link_b_value(i),
+				o_b_active => link_b_active(i)
+			);
+
+		consumer: entity work.tis_execution_node
+			port map (
+				clock         => clock_tb,
+				resetn        => resetn_tb,
+				read          => '0',
+				write         => write_consumer,
+				address       => address_tb,
+				writedata     => writedata_tb,
+				byteenable    => byteenable_tb,
+				tis_active    => tis_active_tb,
+				i_left        => link_b_value(i),
+				i_left_active => link_b_active(i),
+				o_left        => consumer_value(i),
+				o_left_active => consumer_active(i),
+				i_right       => idle_tb,
+				i_up          => idle_tb,
+				i_down        => idle_tb,
+				debug_acc     => consumer_acc(i)
+			);
+	end generate;
+
+	process
+		type cycle_counts is array (0 to 1) of natural;
+		variable cycles : cycle_counts := (0, 0);
+	begin
+		-- Initialize signals
+		clock_tb <= '0';
+		resetn_tb <= '1'; -- High by default
+		byteenable_tb <= (others => '1');
+		write_producer <= '0';
+		write_consumer <= '0';
+		writedata_tb <= (others => '0');
+		tis_active_tb <= '0';
+		ClockPulse(clock_tb);
+
+		-- Producer sends bursts of two values
+		-- 0 MOV 1, RIGHT (31 downto 16), Node Header (15 downto 0)
+		write_producer <= '1';
+		address_tb <= std_logic_vector(to_unsigned(0, address_tb'length));
+		writedata_tb <= x"A801" & x"0005";
+		ClockPulse(clock_tb);
+
+		-- 1 MOV 1, RIGHT (15 downto 0)
+		-- 2 NOP (31 downto 16)
+		address_tb <= std_logic_vector(to_unsigned(1, address_tb'length));
+		writedata_tb <= x"0000" & x"A801";
+		ClockPulse(clock_tb);
+
+		-- 3 NOP (15 downto 0)
+		-- 4 NOP (31 downto 16)
+		address_tb <= std_logic_vector(to_unsigned(2, address_tb'length));
+		writedata_tb <= x"0000" & x"0000";
+		ClockPulse(clock_tb);
+
+		-- 5 NOP (15 downto 0)
+		address_tb <= std_logic_vector(to_unsigned(3, address_tb'length));
+		writedata_tb <= x"0000" & x"0000";
+		ClockPulse(clock_tb);
+		write_producer <= '0';
+
+		-- Consumer takes a value every four instructions, same average rate
+		-- 0 ADD LEFT (31 downto 16), Node Header (15 downto 0)
+		write_consumer <= '1';
+		address_tb <= std_logic_vector(to_unsigned(0, address_tb'length));
+		writedata_tb <= x"0804" & x"0003";
+		ClockPulse(clock_tb);
+
+		-- 1 NOP (15 downto 0)
+		-- 2 NOP (31 downto 16)
+		address_tb <= std_logic_vector(to_unsigned(1, address_tb'length));
+		writedata_tb <= x"0000" & x"0000";
+		ClockPulse(clock_tb);
+
+		-- 3 NOP (15 downto 0)
+		address_tb <= std_logic_vector(to_unsigned(2, address_tb'length));
+		writedata_tb <= x"0000" & x"0000";
+		ClockPulse(clock_tb);
+		write_consumer <= '0';
+
+		tis_active_tb <= '1';
+		for cycle in 1 to 20 * item_count loop
+			TisPulse(clock_tb);
+			for i in 0 to 1 loop
+				if cycles(i) = 0 and consumer_acc(i) = std_logic_vector(to_unsigned(item_count, consumer_acc(i)'length)) then
+					cycles(i) := cycle;
+				end if;
+			end loop;
+			exit when cycles(0) /= 0 and cycles(1) /= 0;
+		end loop;
+
+		report "Depth " & to_string(link_depth(0)) & ": " & to_string(item_count) & " values in " & to_string(cycles(0)) & " cycles" severity note;
+		report "Depth " & to_string(link_depth(1)) & ": " & to_string(item_count) & " values in " & to_string(cycles(1)) & " cycles" severity note;
+
+		assert cycles(0) /= 0 report "Depth 0: Expecting " & to_string(item_count) & " values, got " & to_string(to_integer(signed(consumer_acc(0)))) severity error;
+		assert cycles(1) /= 0 report "Depth 4: Expecting " & to_string(item_count) & " values, got " & to_string(to_integer(signed(consumer_acc(1)))) severity error;
+		assert cycles(1) < cycles(0) report "Expecting the buffered link to be faster" severity error;
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
@@ -0,0 +1,142 @@
+-- altera vhdl_input_version vhdl_2008
+library IEEE;
+	use IEEE.std_logic_1164.all;
+	use IEEE.numeric_std.all;
+	use IEEE.math_real.all;
+
+	-- Copies of the same tis_grid behind a single Avalon slave, used to run
+	-- independent jobs side by side. Replica k takes the address window of a
+	-- whole grid starting at k * 2 ** grid_bits words, the window after the
+	-- last replica holds the control registers:
+	--   word 0: enable mask, bit k gates tis_active of replica k (read/write)
+	--   word 1: interrupt status, bit k set when replica k raises irq (read)
+	-- Clearing an enable bit freezes every node of the replica in its current
+	-- phase, setting it again resumes from there.
+
+entity tis_replicas is
+	generic (
+		replicas     : positive range 1 to 32 := 2;
+		-- Grid of every replica, see tis_grid
+		rows         : positive               := 3;
+		cols         : positive               := 1;
+		stack_nodes  : std_logic_vector       := "101";
+		h_link_depth : integer_vector         := (0 => 0);
+		v_link_depth : integer_vector         := (0 => 0);
+		stack_length : natural                := 15;
+		stack_bram   : boolean                := false;
+		pc_width     : positive range 4 to 7  := 4;
+		handshake    : boolean                := false
+	);
+	port (
+		clock, resetn : in  std_logic;
+		read, write   : in  std_logic;
+		address       : in  std_logic_vector(integer(ceil(log2(real(replicas + 1)))) + integer(ceil(log2(real(rows * cols)))) + pc_width - 2 downto 0);
+		readdata      : out std_logic_vector(31 downto 0);
+		writedata     : in  std_logic_vector(31 downto 0);
+		byteenable    : in  std_logic_vector(3 downto 0);
+		-- Interrupt when any replica has data available for reading
+		irq           : out std_logic;
+		-- Used to avoid early start without initialized program
+		tis_active    : in  std_logic
+	);
+end entity;
+
+architecture rtl of tis_replicas is
+	-- Address bits of a single grid
+	constant grid_bits : natural := integer(ceil(log2(real(rows * cols)))) + pc_width - 1;
+
+	type replica_words is array (0 to replicas - 1) of std_logic_vector(31 downto 0);
+
+	signal replica_index    : natural;
+	signal read_index       : natural := 0; -- Replica read on the previous clock
+	signal replica_read     : std_logic_vector(0 to replicas - 1);
+	signal replica_write    : std_logic_vector(0 to replicas - 1);
+	signal replica_readdata : replica_words;
+	signal replica_irq      : std_logic_vector(0 to replicas - 1);
+	signal replica_active   : std_logic_vector(0 to replicas - 1);
+
+	signal enable           : std_logic_vector(0 to replicas - 1) := (others => '0');
+	signal control_readdata : std_logic_vector(31 downto 0);
+begin
+
+	-- Address decoder
+	replica_index <= to_integer(unsigned(address(address'high downto grid_bits)));
+
+	decoder: for k in 0 to replicas - 1 generate
+		replica_read(k) <= read when replica_index = k else '0';
+		replica_write(k) <= write when replica_index = k else '0';
+	end generate;
+
+	-- Readdata of the grids and the control registers is registered, so it
+	-- belongs to the address of the previous read
+	read_select: process (clock, resetn)
+	begin
+		if resetn = '0' then
+			read_index <= 0;
+		elsif rising_edge(clock) then
+			if read = '1' then
+				read_index <= replica_index;
+			end if;
+		end if;
+	end process;
+
+	readdata <= replica_readdata(read_index) when read_index < replicas else control_readdata;
+
+	irq <= '0' when replica_irq = (replica_irq'range => '0') else '1';
+
+	control: process (clock, resetn)
+	begin
+		if resetn = '0' then
+			enable <= (others => '0');
+			control_readdata <= (others => '0');
+		elsif rising_edge(clock) then
+			if replica_index = replicas then
+				if read = '1' then
+					control_readdata <= (others => '0');
+					for k in 0 to replicas - 1 loop
+						if unsigned(address(grid_bits - 1 downto 0)) = 0 then
+							control_readdata(k) <= enable(k);
+						elsif unsigned(address(grid_bits - 1 downto 0)) = 1 then
+							control_readdata(k) <= replica_irq(k);
+						end if;
+					end loop;
+				elsif write = '1' and unsigned(address(grid_bits - 1 downto 0)) = 0 then
+					for k in 0 to replicas - 1 loop
+						if byteenable(k / 8) = '1' then
+							enable(k) <= writedata(k);
+						end if;
+					end loop;
+				end if;
+			end if;
+		end if;
+	end process;
+
+	grids: for k in 0 to replicas - 1 generate
+		replica_active(k) <= tis_active and enable(k);
+
+		grid: entity work.tis_grid
+			generic map (
+				rows         => rows,
+				cols         => cols,
+				stack_nodes  => stack_nodes,
+				h_link_depth => h_link_depth,
+				v_link_depth => v_link_depth,
+				stack_length => stack_length,
+				stack_bram   => stack_bram,
+				pc_width     => pc_width,
+				handshake    => handshake
+			)
+			port map (
+				clock      => clock,
+				resetn     => resetn,
+				read       => replica_read(k),
+				write      => replica_write(k),
+				address    => address(grid_bits - 1 downto 0),
+				readdata   => replica_readdata(k),
+				writedata  => writedata,
+				byteenable => byteenable,
+				irq        => replica_irq(k),
+				tis_active => replica_active(k)
+			);
+	end generate;
+end architecture;
@@ -0,0 +1,171 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_replicas_tb is
+end entity;
+
+architecture rtl of tis_replicas_tb is
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Full TIS I/O Cycle
+	procedure TisPulse(signal clk : inout std_logic) is
+	begin
+		-- Each cycle needs 6 rising edges
+		for i in 1 to 6 loop
+			wait for 1 ns;
+			clk <= '0';
+			wait for 1 ns;
+			clk <= '1';
+		end loop;
+
+		wait for 1 ns;
+	end procedure;
+
+	-- Two 3x1 grids, each grid takes 32 words
+	constant replicas  : positive := 2;
+	constant grid_bits : natural  := 5;
+
+	-- Word address of a register in a node of a replica, the control
+	-- registers follow the last replica
+	function ReplicaAddress(replica : natural; node : natural; word : natural) return natural is
+	begin
+		return replica * 2 ** grid_bits + node * 8 + word;
+	end function;
+
+	-- Avalon slave signals
+	signal clock_tb      : std_logic;
+	signal resetn_tb     : std_logic;
+	signal read_tb       : std_logic;
+	signal write_tb      : std_logic;
+	signal address_tb    : std_logic_vector(6 downto 0);
+	signal readdata_tb   : std_logic_vector(31 downto 0);
+	signal writedata_tb  : std_logic_vector(31 downto 0);
+	signal byteenable_tb : std_logic_vector(3 downto 0);
+	signal irq_tb        : std_logic;
+
+	-- TIS signals
+	signal tis_active_tb : std_logic;
+begin
+	-- Same layout as tis_system in every replica: stack input, execution node, stack output
+	dut: entity work.tis_replicas
+		generic map (
+			replicas    => replicas,
+			rows        => 3,
+			cols        => 1,
+			stack_nodes => "101"
+		)
+		port map (
+			clock      => clock_tb,
+			resetn     => resetn_tb,
+			read       => read_tb,
+			write      => write_tb,
+			address    => address_tb,
+			readdata   => readdata_tb,
+			writedata  => writedata_tb,
+			byteenable => byteenable_tb,
+			irq        => irq_tb,
+			tis_active => tis_active_tb
+		);
+
+	-- Mock Avalon master
+	process
+		variable data : std_logic_vector(31 downto 0);
+
+		procedure AvalonWrite(
+				addr : natural;
+				value : std_logic_vector(31 downto 0);
+				be : std_logic_vector(3 downto 0)
+			) is
+		begin
+			address_tb <= std_logic_vector(to_unsigned(addr, address_tb'length));
+			writedata_tb <= value;
+			byteenable_tb <= be;
+			write_tb <= '1';
+			ClockPulse(clock_tb);
+			write_tb <= '0';
+		end procedure;
+
+		procedure AvalonRead(
+				addr : natural;
+				be : std_logic_vector(3 downto 0);
+				variable value : out std_logic_vector(31 downto 0)
+			) is
+		begin
+			address_tb <= std_logic_vector(to_unsigned(addr, address_tb'length));
+			byteenable_tb <= be;
+			read_tb <= '1';
+			ClockPulse(clock_tb);
+			read_tb <= '0';
+			value := readdata_tb;
+		end procedure;
+	begin
+		-- Reset
+		clock_tb <= '0';
+		resetn_tb <= '0';
+		read_tb <= '0';
+		write_tb <= '0';
+		tis_active_tb <= '0';
+		byteenable_tb <= (others => '1');
+		writedata_tb <= (others => '0');
+		address_tb <= (others => '0');
+		ClockPulse(clock_tb);
+		resetn_tb <= '1';
+		ClockPulse(clock_tb);
+
+		for k in 0 to replicas - 1 loop
+			-- MOV UP, ACC / ADD ACC / MOV ACC, DOWN
+			AvalonWrite(ReplicaAddress(k, 1, 0), x"C802" & x"0002", "1111");
+			AvalonWrite(ReplicaAddress(k, 1, 1), x"D801" & x"0801", "1111");
+
+			-- Stack input writes to the grid, stack output reads from it
+			AvalonWrite(ReplicaAddress(k, 0, 0), x"0000" & x"0001", "0011");
+			AvalonWrite(ReplicaAddress(k, 2, 0), x"0000" & x"0002", "0011");
+
+			-- Job input through the upper halfword
+			AvalonWrite(ReplicaAddress(k, 0, 0), std_logic_vector(to_signed(5 + k, 16)) & x"0000", "1100");
+		end loop;
+
+		-- Only run the first replica
+		AvalonWrite(ReplicaAddress(replicas, 0, 0), x"00000001", "1111");
+		AvalonRead(ReplicaAddress(replicas, 0, 0), "1111", data);
+		assert data = x"00000001" report "Expected enable mask 1, got " & to_string(data) severity error;
+
+		tis_active_tb <= '1';
+		for i in 1 to 8 loop
+			TisPulse(clock_tb);
+		end loop;
+
+		AvalonRead(ReplicaAddress(0, 2, 0), "1100", data);
+		assert data(31 downto 16) = std_logic_vector(to_signed(10, 16)) report "Replica 0: Expected readdata 10, got " & to_string(data(31 downto 16)) severity error;
+		AvalonRead(ReplicaAddress(1, 2, 0), "1100", data);
+		assert data(31 downto 16) = x"FFFF" report "Replica 1: Expected no output while disabled, got " & to_string(data(31 downto 16)) severity error;
+
+		-- Input of the second replica is still waiting
+		AvalonRead(ReplicaAddress(replicas, 0, 1), "1111", data);
+		assert data = x"00000002" report "Expected interrupt status 2, got " & to_string(data) severity error;
+
+		-- Run the second replica on its own
+		AvalonWrite(ReplicaAddress(replicas, 0, 0), x"00000002", "1111");
+		for i in 1 to 8 loop
+			TisPulse(clock_tb);
+		end loop;
+		tis_active_tb <= '0';
+
+		assert irq_tb = '1' report "Didn't get interrupt from replica 1 output" severity error;
+		AvalonRead(ReplicaAddress(1, 2, 0), "1100", data);
+		assert data(31 downto 16) = std_logic_vector(to_signed(12, 16)) report "Replica 1: Expected readdata 12, got " & to_string(data(31 downto 16)) severity error;
+		assert irq_tb = '0' report "Got interrupt after draining every replica" severity error;
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
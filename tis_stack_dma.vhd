@@ -0,0 +1,293 @@
+-- altera vhdl_input_version vhdl_2008
+library IEEE;
+	use IEEE.std_logic_1164.all;
+	use IEEE.numeric_std.all;
+
+	-- Stack node with an Avalon master that streams values between memory and
+	-- the grid without the CPU. Every value is a halfword in memory, the next
+	-- one follows stride bytes further. Registers of the slave:
+	--   word 0: control
+	--           write: bit 0 start, bit 1 stack to memory instead of memory to
+	--                  stack, bit 2 interrupt on completion, bit 3 stop
+	--           read:  bit 0 busy, bit 1 direction, bit 2 interrupt enable,
+	--                  bit 4 done
+	--   word 1: memory address of the next value
+	--   word 2: values left to transfer
+	--   word 3: stride in bytes, two's complement
+	--   words 8 to 15: registers 0 to 7 of tis_stack_node in the lower halfword
+	-- Writing the control register clears done. The master only touches the
+	-- stack while a memory mapped access can't collide with grid I/O, so the
+	-- grid sets the pace of a transfer.
+
+entity tis_stack_dma is
+	generic (
+		buffer_length : natural := 15;
+		-- See tis_stack_node
+		COMPACT       : boolean := false;
+		BLOCK_RAM     : boolean := false
+	);
+	port (
+		clock, resetn   : in  std_logic;
+		-- Register slave
+		read, write     : in  std_logic;
+		address         : in  std_logic_vector(3 downto 0);
+		readdata        : out std_logic_vector(31 downto 0);
+		writedata       : in  std_logic_vector(31 downto 0);
+		-- Interrupt when a transfer completed
+		irq             : out std_logic;
+		-- Memory master
+		avm_address     : out std_logic_vector(31 downto 0);
+		avm_read        : out std_logic;
+		avm_write       : out std_logic;
+		avm_byteenable  : out std_logic_vector(3 downto 0);
+		avm_readdata    : in  std_logic_vector(31 downto 0);
+		avm_writedata   : out std_logic_vector(31 downto 0);
+		avm_waitrequest : in  std_logic;
+		-- Used to avoid early start without initialized program
+		tis_active      : in  std_logic;
+		-- One-hot phase from tis_controller, only used when COMPACT
+		tis_phase       : in  std_logic_vector(5 downto 0) := (others => '0');
+		-- Left conduit
+		i_left          : in  std_logic_vector(10 downto 0);
+		i_left_active   : in  std_logic := '0';
+		o_left          : out std_logic_vector(10 downto 0);
+		o_left_active   : out std_logic;
+		-- Right conduit
+		i_right         : in  std_logic_vector(10 downto 0);
+		i_right_active  : in  std_logic := '0';
+		o_right         : out std_logic_vector(10 downto 0);
+		o_right_active  : out std_logic;
+		-- Up conduit
+		i_up            : in  std_logic_vector(10 downto 0);
+		i_up_active     : in  std_logic := '0';
+		o_up            : out std_logic_vector(10 downto 0);
+		o_up_active     : out std_logic;
+		-- Down conduit
+		i_down          : in  std_logic_vector(10 downto 0);
+		i_down_active   : in  std_logic := '0';
+		o_down          : out std_logic_vector(10 downto 0);
+		o_down_active   : out std_logic
+	);
+end entity;
+
+architecture rtl of tis_stack_dma is
+	-- DMA_READ and DMA_PUSH move a value from memory to the stack, DMA_POP,
+	-- DMA_CAPTURE and DMA_WRITE the other way around
+	type dma_state is (DMA_IDLE, DMA_READ, DMA_PUSH, DMA_POP, DMA_CAPTURE, DMA_WRITE);
+
+	signal state     : dma_state := DMA_IDLE;
+	signal to_memory : std_logic := '0';
+	signal irq_on    : std_logic := '0';
+	signal done      : std_logic := '0';
+	signal stopping  : std_logic := '0';
+	signal next_addr : unsigned(31 downto 0) := (others => '0');
+	signal left      : unsigned(31 downto 0) := (others => '0');
+	signal stride    : signed(31 downto 0) := (others => '0');
+	signal value     : std_logic_vector(15 downto 0) := (others => '0');
+
+	-- Memory mapped side of the stack, shared by the slave and the master
+	signal cpu_access     : std_logic;
+	signal stack_read     : std_logic;
+	signal stack_write    : std_logic;
+	signal stack_address  : std_logic_vector(3 downto 0);
+	signal stack_readdata : std_logic_vector(15 downto 0);
+	signal stack_wdata    : std_logic_vector(15 downto 0);
+	signal stack_irq      : std_logic;
+	signal stack_full     : std_logic;
+	signal stack_idle     : std_logic;
+	signal stack_free     : boolean; -- Master may use the stack on this clock
+
+	signal register_readdata : std_logic_vector(31 downto 0);
+	signal stack_selected    : std_logic := '0'; -- Last slave read went to the stack
+begin
+
+	irq <= done and irq_on;
+
+	-- The slave goes first, the master waits for a clock without it
+	cpu_access <= (read or write) and address(3);
+	stack_free <= cpu_access = '0' and stack_idle = '1';
+
+	stack_read <= read and address(3) when cpu_access = '1' else
+	              '1' when state = DMA_POP and stack_free and stack_irq = '1' else
+	              '0';
+	stack_write <= write and address(3) when cpu_access = '1' else
+	               '1' when state = DMA_PUSH and stack_free and stack_full = '0' else
+	               '0';
+	stack_address <= '0' & address(2 downto 0) when cpu_access = '1' else x"1";
+	stack_wdata <= writedata(15 downto 0) when cpu_access = '1' else value;
+
+	readdata <= x"0000" & stack_readdata when stack_selected = '1' else register_readdata;
+
+	-- Values sit in the halfword picked by bit 1 of the address
+	avm_address <= std_logic_vector(next_addr(31 downto 2)) & "00";
+	avm_byteenable <= "1100" when next_addr(1) = '1' else "0011";
+	avm_writedata <= value & value;
+	avm_read <= '1' when state = DMA_READ else '0';
+	avm_write <= '1' when state = DMA_WRITE else '0';
+
+	registers: process (clock, resetn)
+	begin
+		if not resetn then
+			register_readdata <= (others => '0');
+			stack_selected <= '0';
+		elsif rising_edge(clock) then
+			if read then
+				stack_selected <= address(3);
+				register_readdata <= (others => '0');
+				case to_integer(unsigned(address)) is
+					when 0 =>
+						if state /= DMA_IDLE then
+							register_readdata(0) <= '1';
+						end if;
+						register_readdata(1) <= to_memory;
+						register_readdata(2) <= irq_on;
+						register_readdata(4) <= done;
+					when 1 => register_readdata <= std_logic_vector(next_addr);
+					when 2 => register_readdata <= std_logic_vector(left);
+					when 3 => register_readdata <= std_logic_vector(stride);
+					when others => null;
+				end case;
+			end if;
+		end if;
+	end process;
+
+	master: process (clock, resetn)
+		-- Moves on to the next value after one was transferred
+		procedure Advance is
+		begin
+			next_addr <= unsigned(signed(next_addr) + stride);
+			left <= left - 1;
+			if left = 1 or stopping = '1' then
+				state <= DMA_IDLE;
+				done <= not stopping;
+				stopping <= '0';
+			elsif to_memory then
+				state <= DMA_POP;
+			else
+				state <= DMA_READ;
+			end if;
+		end procedure;
+	begin
+		if not resetn then
+			state <= DMA_IDLE;
+			to_memory <= '0';
+			irq_on <= '0';
+			done <= '0';
+			stopping <= '0';
+			next_addr <= (others => '0');
+			left <= (others => '0');
+			stride <= (others => '0');
+			value <= (others => '0');
+		elsif rising_edge(clock) then
+			if write = '1' and address(3) = '0' then
+				case to_integer(unsigned(address(2 downto 0))) is
+					when 0 =>
+						done <= '0';
+						irq_on <= writedata(2);
+						if state = DMA_IDLE then
+							to_memory <= writedata(1);
+						end if;
+					when 1 =>
+						if state = DMA_IDLE then
+							next_addr <= unsigned(writedata);
+						end if;
+					when 2 =>
+						if state = DMA_IDLE then
+							left <= unsigned(writedata);
+						end if;
+					when 3 =>
+						if state = DMA_IDLE then
+							stride <= signed(writedata);
+						end if;
+					when others => null;
+				end case;
+			end if;
+
+			case state is
+				when DMA_IDLE =>
+					stopping <= '0';
+					if write = '1' and unsigned(address) = 0 and writedata(0) = '1' and writedata(3) = '0' then
+						if left = 0 then
+							done <= '1';
+						elsif writedata(1) = '1' then
+							state <= DMA_POP;
+						else
+							state <= DMA_READ;
+						end if;
+					end if;
+				when DMA_READ =>
+					-- Held until the slave takes it
+					if avm_waitrequest = '0' then
+						if next_addr(1) = '1' then
+							value <= avm_readdata(31 downto 16);
+						else
+							value <= avm_readdata(15 downto 0);
+						end if;
+						state <= DMA_PUSH;
+					end if;
+				when DMA_PUSH =>
+					if stack_write = '1' and cpu_access = '0' then
+						Advance;
+					elsif stopping then
+						state <= DMA_IDLE;
+					end if;
+				when DMA_POP =>
+					if stack_read = '1' and cpu_access = '0' then
+						state <= DMA_CAPTURE;
+					elsif stopping then
+						state <= DMA_IDLE;
+					end if;
+				when DMA_CAPTURE =>
+					-- Popped value is valid during the clock after the read
+					value <= stack_readdata;
+					state <= DMA_WRITE;
+				when DMA_WRITE =>
+					if avm_waitrequest = '0' then
+						Advance;
+					end if;
+			end case;
+
+			-- Stop after the value in flight, waiting on the stack ends at once
+			if write = '1' and unsigned(address) = 0 and writedata(3) = '1' and state /= DMA_IDLE then
+				stopping <= '1';
+			end if;
+		end if;
+	end process;
+
+	stack: entity work.tis_stack_node
+		generic map (
+			buffer_length => buffer_length,
+			COMPACT       => COMPACT,
+			BLOCK_RAM     => BLOCK_RAM
+		)
+		port map (
+			clock          => clock,
+			resetn         => resetn,
+			read           => stack_read,
+			write          => stack_write,
+			address        => stack_address,
+			readdata       => stack_readdata,
+			writedata      => stack_wdata,
+			irq            => stack_irq,
+			full           => stack_full,
+			idle           => stack_idle,
+			tis_active     => tis_active,
+			tis_phase      => tis_phase,
+			i_left         => i_left,
+			i_left_active  => i_left_active,
+			o_left         => o_left,
+			o_left_active  => o_left_active,
+			i_right        => i_right,
+			i_right_active => i_right_active,
+			o_right        => o_right,
+			o_right_active => o_right_active,
+			i_up           => i_up,
+			i_up_active    => i_up_active,
+			o_up           => o_up,
+			o_up_active    => o_up_active,
+			i_down         => i_down,
+			i_down_active  => i_down_active,
+			o_down         => o_down,
+			o_down_active  => o_down_active
+		);
+end architecture;
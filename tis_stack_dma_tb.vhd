@@ -0,0 +1,235 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_stack_dma_tb is
+end entity;
+
+architecture rtl of tis_stack_dma_tb is
+	-- Shorter than the input, so the master has to wait for space
+	constant buffer_length : natural := 4;
+
+	type memory is array (0 to 31) of std_logic_vector(31 downto 0);
+	type value_list is array (natural range <>) of integer;
+
+	constant inputs : value_list(0 to 5) := (10, - 20, 30, - 40, 50, - 60);
+
+	signal clock_tb     : std_logic := '0';
+	signal resetn_tb    : std_logic := '1';
+	signal read_tb      : std_logic := '0';
+	signal write_tb     : std_logic := '0';
+	signal address_tb   : std_logic_vector(3 downto 0);
+	signal readdata_tb  : std_logic_vector(31 downto 0);
+	signal writedata_tb : std_logic_vector(31 downto 0);
+	-- Interrupt when a transfer completed
+	signal irq_tb : std_logic;
+	-- Memory master
+	signal avm_address_tb     : std_logic_vector(31 downto 0);
+	signal avm_read_tb        : std_logic;
+	signal avm_write_tb       : std_logic;
+	signal avm_byteenable_tb  : std_logic_vector(3 downto 0);
+	signal avm_readdata_tb    : std_logic_vector(31 downto 0);
+	signal avm_writedata_tb   : std_logic_vector(31 downto 0);
+	signal avm_waitrequest_tb : std_logic;
+	-- Used to avoid early start without initialized program
+	signal tis_active_tb : std_logic := '0';
+	-- Left conduit feeds values in, right conduit takes them
+	signal i_left_tb          : std_logic_vector(10 downto 0) := (others => '0');
+	signal i_left_active_tb   : std_logic := '0';
+	signal o_right_tb         : std_logic_vector(10 downto 0);
+	signal o_right_active_tb  : std_logic;
+	signal i_right_active_tb  : std_logic := '0';
+
+	-- Input values packed as halfwords, the rest of the memory is zero
+	signal mem     : memory := (
+		0 => std_logic_vector(to_signed(inputs(1), 16)) & std_logic_vector(to_signed(inputs(0), 16)),
+		1 => std_logic_vector(to_signed(inputs(3), 16)) & std_logic_vector(to_signed(inputs(2), 16)),
+		2 => std_logic_vector(to_signed(inputs(5), 16)) & std_logic_vector(to_signed(inputs(4), 16)),
+		others => (others => '0')
+	);
+	signal granted : std_logic := '0';
+
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Full TIS I/O Cycle
+	procedure TisPulse(signal clk : inout std_logic) is
+	begin
+		-- Each cycle needs 6 rising edges
+		for i in 1 to 6 loop
+			wait for 1 ns;
+			clk <= '0';
+			wait for 1 ns;
+			clk <= '1';
+		end loop;
+
+		wait for 1 ns;
+	end procedure;
+begin
+
+	dma: entity work.tis_stack_dma
+		generic map (
+			buffer_length => buffer_length
+		)
+		port map (
+			clock           => clock_tb,
+			resetn          => resetn_tb,
+			read            => read_tb,
+			write           => write_tb,
+			address         => address_tb,
+			readdata        => readdata_tb,
+			writedata       => writedata_tb,
+			irq             => irq_tb,
+			avm_address     => avm_address_tb,
+			avm_read        => avm_read_tb,
+			avm_write       => avm_write_tb,
+			avm_byteenable  => avm_byteenable_tb,
+			avm_readdata    => avm_readdata_tb,
+			avm_writedata   => avm_writedata_tb,
+			avm_waitrequest => avm_waitrequest_tb,
+			tis_active      => tis_active_tb,
+			i_left          => i_left_tb,
+			i_left_active   => i_left_active_tb,
+			o_left          => open,
+			o_left_active   => open,
+			i_right         => (others => '0'),
+			i_right_active  => i_right_active_tb,
+			o_right         => o_right_tb,
+			o_right_active  => o_right_active_tb,
+			i_up            => (others => '0'),
+			o_up            => open,
+			o_up_active     => open,
+			i_down          => (others => '0'),
+			o_down          => open,
+			o_down_active   => open
+		);
+
+	-- Memory slave with one wait state per transfer
+	avm_waitrequest_tb <= (avm_read_tb or avm_write_tb) and not granted;
+	avm_readdata_tb <= mem(to_integer(unsigned(avm_address_tb(6 downto 2))));
+
+	process (clock_tb)
+	begin
+		if rising_edge(clock_tb) then
+			granted <= (avm_read_tb or avm_write_tb) and not granted;
+			if avm_write_tb = '1' and avm_waitrequest_tb = '0' then
+				for b in 0 to 3 loop
+					if avm_byteenable_tb(b) = '1' then
+						mem(to_integer(unsigned(avm_address_tb(6 downto 2))))(8 * b + 7 downto 8 * b) <= avm_writedata_tb(8 * b + 7 downto 8 * b);
+					end if;
+				end loop;
+			end if;
+		end if;
+	end process;
+
+	process
+		procedure WriteRegister(signal clk : inout std_logic; reg : natural; data : integer) is
+		begin
+			address_tb <= std_logic_vector(to_unsigned(reg, address_tb'length));
+			writedata_tb <= std_logic_vector(to_signed(data, writedata_tb'length));
+			write_tb <= '1';
+			ClockPulse(clk);
+			write_tb <= '0';
+		end procedure;
+
+		variable edges    : natural := 0;
+		variable received : natural := 0;
+	begin
+		-- Reset
+		resetn_tb <= '0';
+		ClockPulse(clock_tb);
+		resetn_tb <= '1';
+		ClockPulse(clock_tb);
+
+		-- Stack writes to the grid
+		WriteRegister(clock_tb, 8, 1);
+
+		-- Six halfwords from address 0 into the stack, interrupt when done
+		WriteRegister(clock_tb, 1, 0);
+		WriteRegister(clock_tb, 2, inputs'length);
+		WriteRegister(clock_tb, 3, 2);
+		WriteRegister(clock_tb, 0, 2#101#);
+
+		-- The master fills the stack while the grid is stopped
+		for i in 1 to 20 loop
+			ClockPulse(clock_tb);
+		end loop;
+		assert irq_tb = '0' report "Got interrupt before the transfer completed" severity error;
+
+		address_tb <= "1010";
+		read_tb <= '1';
+		ClockPulse(clock_tb);
+		read_tb <= '0';
+		assert to_integer(unsigned(readdata_tb)) = buffer_length report "Expected a full stack, got count " & to_string(to_integer(unsigned(readdata_tb))) severity error;
+
+		-- Values reach the grid in memory order while the master keeps up.
+		-- Offers made in TIS_LEFT are seen after the second edge.
+		i_right_active_tb <= '1';
+		tis_active_tb <= '1';
+		while received < inputs'length and edges < 6 * 4 * inputs'length loop
+			ClockPulse(clock_tb);
+			edges := edges + 1;
+			if edges mod 6 = 2 and o_right_active_tb = '1' then
+				assert o_right_tb = std_logic_vector(to_signed(inputs(received), o_right_tb'length)) report "Expected value " & to_string(inputs(received)) & " on RIGHT, got " & to_string(to_integer(signed(o_right_tb))) severity error;
+				received := received + 1;
+			end if;
+		end loop;
+		assert received = inputs'length report "Expected " & to_string(inputs'length) & " values on RIGHT, got " & to_string(received) severity error;
+		assert irq_tb = '1' report "Didn't get interrupt for the completed transfer" severity error;
+
+		-- Finish the TIS cycle
+		while edges mod 6 /= 0 loop
+			ClockPulse(clock_tb);
+			edges := edges + 1;
+		end loop;
+		i_right_active_tb <= '0';
+		tis_active_tb <= '0';
+
+		address_tb <= "0000";
+		read_tb <= '1';
+		ClockPulse(clock_tb);
+		read_tb <= '0';
+		assert readdata_tb(4 downto 0) = "10100" report "Expected done and idle, got control " & to_string(readdata_tb(4 downto 0)) severity error;
+
+		-- Stack reads from the grid, three values to one word each from word 16
+		WriteRegister(clock_tb, 8, 2);
+		WriteRegister(clock_tb, 1, 64);
+		WriteRegister(clock_tb, 2, 3);
+		WriteRegister(clock_tb, 3, 4);
+		WriteRegister(clock_tb, 0, 2#111#);
+		assert irq_tb = '0' report "Starting didn't clear the interrupt" severity error;
+
+		i_left_active_tb <= '1';
+		tis_active_tb <= '1';
+		for k in 1 to 8 loop
+			i_left_tb <= std_logic_vector(to_signed(k, i_left_tb'length));
+			TisPulse(clock_tb);
+			exit when irq_tb = '1';
+		end loop;
+		i_left_active_tb <= '0';
+		tis_active_tb <= '0';
+		assert irq_tb = '1' report "Didn't get interrupt for the completed transfer" severity error;
+
+		for i in 0 to 2 loop
+			assert mem(16 + i) = std_logic_vector(to_unsigned(i + 1, 32)) report "Expected " & to_string(i + 1) & " in word " & to_string(16 + i) & ", got " & to_string(mem(16 + i)) severity error;
+		end loop;
+		assert mem(19) = x"00000000" report "Transfer went past its length" severity error;
+
+		-- Address moved on by a stride per value
+		address_tb <= "0001";
+		read_tb <= '1';
+		ClockPulse(clock_tb);
+		read_tb <= '0';
+		assert to_integer(unsigned(readdata_tb)) = 76 report "Expected address 76, got " & to_string(to_integer(unsigned(readdata_tb))) severity error;
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
@@ -5,38 +5,71 @@ library IEEE;
 
 entity tis_stack_node is
 	generic (
-		buffer_length : natural := 15
+		buffer_length : natural := 15;
+		-- Take the phase from tis_phase instead of a private state machine
+		COMPACT       : boolean := false;
+		-- Keep the values in block RAM for a deep buffer_length. Memory mapped
+		-- reads of a value are then only valid during the clock after the read.
+		BLOCK_RAM     : boolean := false;
+		-- Ready/valid protocol of the HANDSHAKE execution nodes instead of the
+		-- TIS phases. Each clock reads from one port and writes to another in
+		-- the ANY order of tis_execution_node (reads LEFT, RIGHT, UP, DOWN and
+		-- writes RIGHT, LEFT, DOWN, UP), so both sides agree on every transfer.
+		-- Not supported with BLOCK_RAM.
+		HANDSHAKE     : boolean := false
 	);
 	port (
 		clock, resetn  : in  std_logic;
 		read, write    : in  std_logic;
-		address        : in  std_logic_vector(0 downto 0);
+		-- 0: config
+		-- 1: data, reads as all ones when empty
+		-- 2: values in the buffer (read)
+		-- 3: status, bit 0 empty and bit 1 full. Writing sets the high-water
+		--    mark to the current count.
+		-- 4: high-water mark, most values held since reset or the last clear
+		-- 8 to 15: data window, every access pops or pushes one value so a
+		--    burst drains or fills the buffer
+		address        : in  std_logic_vector(3 downto 0);
 		readdata       : out std_logic_vector(15 downto 0);
 		writedata      : in  std_logic_vector(15 downto 0);
 		-- Interrupt when data is available for reading
 		irq            : out std_logic;
+		-- Buffer holds buffer_length values
+		full           : out std_logic;
+		-- Memory mapped accesses can't collide with grid I/O on this clock
+		idle           : out std_logic;
 		-- Used to avoid early start without initialized program
 		tis_active     : in  std_logic;
+		-- One-hot phase from tis_controller, only used when COMPACT
+		tis_phase      : in  std_logic_vector(5 downto 0) := (others => '0');
 		-- Left conduit
 		i_left         : in  std_logic_vector(10 downto 0);
 		i_left_active  : in  std_logic := '0';
 		o_left         : out std_logic_vector(10 downto 0);
 		o_left_active  : out std_logic;
+		i_left_ready   : in  std_logic := '0';
+		o_left_ready   : out std_logic;
 		-- Right conduit
 		i_right        : in  std_logic_vector(10 downto 0);
 		i_right_active : in  std_logic := '0';
 		o_right        : out std_logic_vector(10 downto 0);
 		o_right_active : out std_logic;
+		i_right_ready  : in  std_logic := '0';
+		o_right_ready  : out std_logic;
 		-- Up conduit
 		i_up           : in  std_logic_vector(10 downto 0);
 		i_up_active    : in  std_logic := '0';
 		o_up           : out std_logic_vector(10 downto 0);
 		o_up_active    : out std_logic;
+		i_up_ready     : in  std_logic := '0';
+		o_up_ready     : out std_logic;
 		-- Down conduit
 		i_down         : in  std_logic_vector(10 downto 0);
 		i_down_active  : in  std_logic := '0';
 		o_down         : out std_logic_vector(10 downto 0);
-		o_down_active  : out std_logic
+		o_down_active  : out std_logic;
+		i_down_ready   : in  std_logic := '0';
+		o_down_ready   : out std_logic
 	);
 end entity;
 
@@ -48,15 +81,39 @@ architecture rtl of tis_stack_node is
 
 	type tis_state is (TIS_RUN, TIS_LEFT, TIS_RIGHT, TIS_UP, TIS_DOWN, TIS_FINISH);
 
-	signal node_state  : tis_state := TIS_RUN; -- Write/Read direction of node
-	signal node_output : std_logic_vector(10 downto 0);
+	signal node_state    : tis_state := TIS_RUN; -- Write/Read direction of node
+	signal node_output   : std_logic_vector(10 downto 0);
+	signal stack_output  : std_logic_vector(10 downto 0);
+	signal node_readdata : std_logic_vector(15 downto 0);
 
 	signal tail_ptr : integer range 0 to buffer_length - 1 := 0; -- Written to (-) and read by (-) memory master
 	signal head_ptr : integer range 0 to buffer_length - 1 := 0; -- Written to (+) and read by (+) other nodes
 	signal count    : integer range 0 to buffer_length     := 0;
 
+	-- Offers of the phased I/O
+	signal left_active, right_active, up_active, down_active : std_logic := '0';
+
+	-- HANDSHAKE, conduits indexed LEFT, RIGHT, UP, DOWN
+	type conduit_values is array (0 to 3) of std_logic_vector(10 downto 0);
+	signal node_slot   : unsigned(1 downto 0) := (others => '0');
+	signal conduit_in  : conduit_values;
+	signal in_active   : std_logic_vector(0 to 3);
+	signal in_ready    : std_logic_vector(0 to 3);
+	signal read_offer  : std_logic_vector(0 to 3); -- o_*_ready
+	signal write_offer : std_logic_vector(0 to 3); -- o_*_active
+
+	signal high_water  : integer range 0 to buffer_length := 0;
+	signal data_access : boolean; -- Memory mapped access pops or pushes a value
+
 	subtype tis_integer is integer range - 999 to 999;
 
+	-- Write requested by the stack logic, block RAM takes it on the next clock
+	signal ram_write       : std_logic := '0';
+	signal ram_write_ptr   : integer range 0 to buffer_length - 1 := 0;
+	signal ram_write_value : tis_integer := 0;
+	signal ram_output      : tis_integer := 0;
+	signal read_from_ram   : std_logic := '0';
+
 	pure function to_tis_integer(a : signed) return tis_integer is
 	begin
 		if to_integer(a) > 999 then
@@ -90,78 +147,239 @@ architecture rtl of tis_stack_node is
 		end if;
 	end function;
 begin
-	o_left  <= node_output;
-	o_right <= node_output;
-	o_up    <= node_output;
-	o_down  <= node_output;
+	assert not (HANDSHAKE and BLOCK_RAM) report "HANDSHAKE needs the values in registers" severity failure;
+
+	stack_output <= std_logic_vector(to_signed(ram_output, stack_output'length)) when BLOCK_RAM else
+	                std_logic_vector(to_signed(values(head_ptr), stack_output'length)) when HANDSHAKE else
+	                node_output;
+
+	o_left  <= stack_output;
+	o_right <= stack_output;
+	o_up    <= stack_output;
+	o_down  <= stack_output;
+
+	o_left_active  <= write_offer(0) when HANDSHAKE else left_active;
+	o_right_active <= write_offer(1) when HANDSHAKE else right_active;
+	o_up_active    <= write_offer(2) when HANDSHAKE else up_active;
+	o_down_active  <= write_offer(3) when HANDSHAKE else down_active;
+
+	o_left_ready  <= read_offer(0);
+	o_right_ready <= read_offer(1);
+	o_up_ready    <= read_offer(2);
+	o_down_ready  <= read_offer(3);
+
+	conduit_in <= (i_left, i_right, i_up, i_down);
+	in_active <= i_left_active & i_right_active & i_up_active & i_down_active;
+	in_ready <= i_left_ready & i_right_ready & i_up_ready & i_down_ready;
+
+	-- HANDSHAKE offers only depend on registers and stay off during memory
+	-- mapped accesses, which then can't collide with a transfer
+	handshake_offers: for i in 0 to 3 generate
+		read_offer(i) <= '1' when HANDSHAKE and tis_active = '1' and read = '0' and write = '0' and
+		                          node_config(1) = '1' and count < buffer_length and node_slot = i else '0';
+		write_offer(i) <= '1' when HANDSHAKE and tis_active = '1' and read = '0' and write = '0' and
+		                           node_config(0) = '1' and count > 0 and (node_slot xor "01") = i else '0';
+	end generate;
+
+	readdata <= std_logic_vector(to_signed(ram_output, readdata'length)) when read_from_ram = '1' else node_readdata;
 
 	-- Interrupt when data is available for reading
 	irq <= '0' when count = 0 else '1';
+	full <= '1' when count = buffer_length else '0';
+	idle <= '1' when HANDSHAKE or tis_active = '0' or node_state = TIS_RUN else '0';
+
+	data_access <= unsigned(address) = 1 or address(3) = '1';
+
+	high_water_mark: process (clock, resetn)
+	begin
+		if not resetn then
+			high_water <= 0;
+		elsif rising_edge(clock) then
+			if write = '1' and unsigned(address) = 3 then
+				high_water <= count;
+			elsif count > high_water then
+				high_water <= count;
+			end if;
+		end if;
+	end process;
+
+	private_phase: if not COMPACT generate
+		sequencer: process (clock, resetn)
+		begin
+			if not resetn then
+				node_state <= TIS_RUN;
+			elsif rising_edge(clock) then
+				if tis_active then
+					case node_state is
+						when TIS_RUN =>
+							node_state <= TIS_LEFT;
+						when TIS_LEFT =>
+							node_state <= TIS_RIGHT;
+						when TIS_RIGHT =>
+							node_state <= TIS_UP;
+						when TIS_UP =>
+							node_state <= TIS_DOWN;
+						when TIS_DOWN =>
+							node_state <= TIS_FINISH;
+						when TIS_FINISH =>
+							node_state <= TIS_RUN;
+					end case;
+				end if;
+			end if;
+		end process;
+	end generate;
+
+	shared_phase: if COMPACT generate
+		node_state <= TIS_LEFT when tis_phase(1) = '1' else
+		              TIS_RIGHT when tis_phase(2) = '1' else
+		              TIS_UP when tis_phase(3) = '1' else
+		              TIS_DOWN when tis_phase(4) = '1' else
+		              TIS_FINISH when tis_phase(5) = '1' else
+		              TIS_RUN;
+	end generate;
+
+	-- Simple dual port RAM, the read port follows head_ptr unless the memory
+	-- master reads. Writes are forwarded to a read of the same entry.
+	block_memory: if BLOCK_RAM generate
+		type memory is array (0 to buffer_length - 1) of tis_integer;
+		signal ram      : memory;
+		signal read_ptr : integer range 0 to buffer_length - 1;
+	begin
+		read_ptr <= IncrementPTR(tail_ptr) when read = '1' else head_ptr;
+
+		process (clock)
+		begin
+			if rising_edge(clock) then
+				if ram_write = '1' then
+					ram(ram_write_ptr) <= ram_write_value;
+				end if;
+
+				if ram_write = '1' and ram_write_ptr = read_ptr then
+					ram_output <= ram_write_value;
+				else
+					ram_output <= ram(read_ptr);
+				end if;
+			end if;
+		end process;
+	end generate;
 
 	process (clock, resetn)
+		procedure Store(ptr : integer range 0 to buffer_length - 1; value : tis_integer) is
+		begin
+			if BLOCK_RAM then
+				ram_write <= '1';
+				ram_write_ptr <= ptr;
+				ram_write_value <= value;
+			else
+				values(ptr) <= value;
+			end if;
+		end procedure;
+
+		variable got, taken : boolean;
+		variable value      : tis_integer;
 	begin
 		if not resetn then
-			o_left_active <= '0';
-			o_right_active <= '0';
-			o_up_active <= '0';
-			o_down_active <= '0';
-			node_state <= TIS_RUN;
+			left_active <= '0';
+			right_active <= '0';
+			up_active <= '0';
+			down_active <= '0';
+			node_slot <= (others => '0');
 			node_config <= (others => '0');
 			count <= 0;
 			tail_ptr <= 0;
 			head_ptr <= 0;
-			readdata <= (others => '1');
-			for i in 0 to buffer_length - 1 loop
-				values(i) <= 0;
-			end loop;
+			node_readdata <= (others => '1');
+			read_from_ram <= '0';
+			ram_write <= '0';
+			if not BLOCK_RAM then
+				for i in 0 to buffer_length - 1 loop
+					values(i) <= 0;
+				end loop;
+			end if;
 		elsif rising_edge(clock) then
+			ram_write <= '0';
+
 			if read then
-				if address = "1" then
+				read_from_ram <= '0';
+				if data_access then
 					if count = 0 then
-						readdata <= (others => '1');
+						node_readdata <= (others => '1');
+					elsif BLOCK_RAM then
+						read_from_ram <= '1';
+						tail_ptr <= IncrementPTR(tail_ptr);
+						count <= count - 1;
 					else
-						readdata <= std_logic_vector(to_signed(values(IncrementPTR(tail_ptr)), readdata'length));
+						node_readdata <= std_logic_vector(to_signed(values(IncrementPTR(tail_ptr)), readdata'length));
 						tail_ptr <= IncrementPTR(tail_ptr);
 						count <= count - 1;
 					end if;
 				else
-					readdata <= node_config;
+					node_readdata <= (others => '0');
+					case to_integer(unsigned(address)) is
+						when 0 => node_readdata <= node_config;
+						when 2 => node_readdata <= std_logic_vector(to_unsigned(count, readdata'length));
+						when 3 =>
+							if count = 0 then
+								node_readdata(0) <= '1';
+							end if;
+							if count = buffer_length then
+								node_readdata(1) <= '1';
+							end if;
+						when 4 => node_readdata <= std_logic_vector(to_unsigned(high_water, readdata'length));
+						when others => null;
+					end case;
 				end if;
 			elsif write then
-				if address = "1" then
+				if data_access then
 					if count < buffer_length then
-						values(tail_ptr) <= to_tis_integer(signed(writedata));
+						Store(tail_ptr, to_tis_integer(signed(writedata)));
 						tail_ptr <= DecrementPTR(tail_ptr);
 						count <= count + 1;
 					end if;
-				else
+				elsif unsigned(address) = 0 then
 					node_config <= writedata;
 				end if;
 			end if;
 
-			if tis_active then
-				-- Update state
-				case node_state is
-					when TIS_RUN =>
-						node_state <= TIS_LEFT;
-					when TIS_LEFT =>
-						node_state <= TIS_RIGHT;
-					when TIS_RIGHT =>
-						node_state <= TIS_UP;
-					when TIS_UP =>
-						node_state <= TIS_DOWN;
-					when TIS_DOWN =>
-						node_state <= TIS_FINISH;
-					when TIS_FINISH =>
-						node_state <= TIS_RUN;
-				end case;
+			if tis_active = '1' and HANDSHAKE then
+				node_slot <= node_slot + 1;
+
+				-- Transfers of this clock, one read and one write at most
+				got := false;
+				taken := false;
+				value := 0;
+				for i in 0 to 3 loop
+					if read_offer(i) = '1' and in_active(i) = '1' then
+						got := true;
+						value := to_tis_integer(signed(conduit_in(i)));
+					end if;
+					if write_offer(i) = '1' and in_ready(i) = '1' then
+						taken := true;
+					end if;
+				end loop;
+
+				if got and taken then
+					-- tail_ptr, head_ptr and count stay the same after a simultaneous read/write
+					Store(head_ptr, value);
+				elsif got then
+					Store(IncrementPTR(head_ptr), value);
+					head_ptr <= IncrementPTR(head_ptr);
+					count <= count + 1;
+				elsif taken then
+					head_ptr <= DecrementPTR(head_ptr);
+					count <= count - 1;
+				end if;
+			end if;
 
+			if tis_active = '1' and not HANDSHAKE then
 				-- Default I/O state
-				o_left_active <= '0';
-				o_right_active <= '0';
-				o_up_active <= '0';
-				o_down_active <= '0';
-				node_output <= std_logic_vector(to_signed(values(head_ptr), node_output'length));
+				left_active <= '0';
+				right_active <= '0';
+				up_active <= '0';
+				down_active <= '0';
+				if not BLOCK_RAM then
+					node_output <= std_logic_vector(to_signed(values(head_ptr), node_output'length));
+				end if;
 
 				-- Stack I/O inactive when memory map I/O is ongoing
 				if read = '0' and write = '0' then
@@ -171,179 +389,179 @@ begin
 						when TIS_LEFT =>
 							-- Read if buffer can take another value
 							if node_config(1) = '1' and count < buffer_length then
-								o_left_active <= '1';
+								left_active <= '1';
 							end if;
 							-- Write if a value is still left in buffer
 							if node_config(0) = '1' and count > 0 then
-								o_right_active <= '1';
+								right_active <= '1';
 							end if;
 						when TIS_RIGHT =>
 							-- Check previous I/O result
-							if o_left_active = '1' and i_left_active = '1' and o_right_active = '1' and i_right_active = '1' then
+							if left_active = '1' and i_left_active = '1' and right_active = '1' and i_right_active = '1' then
 								-- We already know read and write are possible here
 								-- tail_ptr, head_ptr and count stay the same after a simultaneous read/write
 								assert not (count = 0 or count = buffer_length) report "The assumption was wrong!" severity failure;
 								-- Store value
-								values(head_ptr) <= to_tis_integer(signed(i_left));
+								Store(head_ptr, to_tis_integer(signed(i_left)));
 								-- Read/Write
-								o_left_active <= '1';
-								o_right_active <= '1';
+								left_active <= '1';
+								right_active <= '1';
 
-							elsif o_left_active = '1' and i_left_active = '1' then
+							elsif left_active = '1' and i_left_active = '1' then
 								-- Read value from LEFT
-								values(IncrementPTR(head_ptr)) <= to_tis_integer(signed(i_left));
-								head_ptr <= IncrementPTR(tail_ptr);
+								Store(IncrementPTR(head_ptr), to_tis_integer(signed(i_left)));
+								head_ptr <= IncrementPTR(head_ptr);
 								count <= count + 1;
 								-- Read if buffer can take another value
 								if count < (buffer_length - 1) then
 									-- Read from RIGHT
-									o_right_active <= '1';
+									right_active <= '1';
 								end if;
 								-- Write to LEFT
-								o_left_active <= '1';
+								left_active <= '1';
 
-							elsif o_right_active = '1' and i_right_active = '1' then
+							elsif right_active = '1' and i_right_active = '1' then
 								-- Written value to RIGHT
 								head_ptr <= DecrementPTR(head_ptr);
 								count <= count - 1;
 								-- Check if any values are left in buffer
 								if count > 1 then
 									-- Write to LEFT
-									o_left_active <= '1';
+									left_active <= '1';
 								end if;
 								-- Read from RIGHT
-								o_right_active <= '1';
+								right_active <= '1';
 
 							else -- No previous I/O
 
 								-- Write if a value is still left in buffer
 								if not (count = 0) then
 									-- Write to LEFT
-									o_left_active <= '1';
+									left_active <= '1';
 								end if;
 
 								-- Read if buffer can take another value
 								if not (count = buffer_length) then
 									-- Read from RIGHT
-									o_right_active <= '1';
+									right_active <= '1';
 								end if;
 							end if;
 						when TIS_UP =>
 							-- Check previous I/O result
-							if o_left_active = '1' and i_left_active = '1' and o_right_active = '1' and i_right_active = '1' then
+							if left_active = '1' and i_left_active = '1' and right_active = '1' and i_right_active = '1' then
 								-- We already know read and write are possible here
 								-- tail_ptr, head_ptr and count stay the same after a simultaneous read/write
 								assert not (count = 0 or count = buffer_length) report "The assumption was wrong!" severity failure;
 								-- Store value
-								values(head_ptr) <= to_tis_integer(signed(i_right));
+								Store(head_ptr, to_tis_integer(signed(i_right)));
 								-- Read/Write
-								o_down_active <= '1';
-								o_up_active <= '1';
+								down_active <= '1';
+								up_active <= '1';
 
-							elsif o_right_active = '1' and i_right_active = '1' then
+							elsif right_active = '1' and i_right_active = '1' then
 								-- Read value from RIGHT
-								values(IncrementPTR(head_ptr)) <= to_tis_integer(signed(i_right));
+								Store(IncrementPTR(head_ptr), to_tis_integer(signed(i_right)));
 								head_ptr <= IncrementPTR(head_ptr);
 								count <= count + 1;
 								-- Read if buffer can take another value
 								if count < (buffer_length - 1) then
 									-- Read from UP
-									o_up_active <= '1';
+									up_active <= '1';
 								end if;
 								-- Write to DOWN
-								o_down_active <= '1';
+								down_active <= '1';
 
-							elsif o_left_active = '1' and i_left_active = '1' then
+							elsif left_active = '1' and i_left_active = '1' then
 								-- Written value to LEFT
 								head_ptr <= DecrementPTR(head_ptr);
 								count <= count - 1;
 								-- Check if any values are left in buffer
 								if count > 1 then
 									-- Write to DOWN
-									o_down_active <= '1';
+									down_active <= '1';
 								end if;
 								-- Read from UP
-								o_up_active <= '1';
+								up_active <= '1';
 
 							else -- No previous I/O
 
 								-- Write if a value is still left in buffer
 								if not (count = 0) then
 									-- Write to DOWN
-									o_down_active <= '1';
+									down_active <= '1';
 								end if;
 
 								-- Read if buffer can take another value
 								if not (count = buffer_length) then
 									-- Read from UP
-									o_up_active <= '1';
+									up_active <= '1';
 								end if;
 							end if;
 
 						when TIS_DOWN =>
 							-- Check previous I/O result
-							if o_up_active = '1' and i_up_active = '1' and o_down_active = '1' and i_down_active = '1' then
+							if up_active = '1' and i_up_active = '1' and down_active = '1' and i_down_active = '1' then
 								-- We already know read and write are possible here
 								-- tail_ptr, head_ptr and count stay the same after a simultaneous read/write
 								assert not (count = 0 or count = buffer_length) report "The assumption was wrong!" severity failure;
 								-- Store value
-								values(head_ptr) <= to_tis_integer(signed(i_up));
+								Store(head_ptr, to_tis_integer(signed(i_up)));
 								-- Read/Write
-								o_up_active <= '1';
-								o_down_active <= '1';
+								up_active <= '1';
+								down_active <= '1';
 
-							elsif o_up_active = '1' and i_up_active = '1' then
+							elsif up_active = '1' and i_up_active = '1' then
 								-- Read value from UP
-								values(IncrementPTR(head_ptr)) <= to_tis_integer(signed(i_up));
+								Store(IncrementPTR(head_ptr), to_tis_integer(signed(i_up)));
 								head_ptr <= IncrementPTR(head_ptr);
 								count <= count + 1;
 								-- Read if buffer can take another value
 								if count < (buffer_length - 1) then
 									-- Read from DOWN
-									o_down_active <= '1';
+									down_active <= '1';
 								end if;
 								-- Write to UP
-								o_up_active <= '1';
+								up_active <= '1';
 
-							elsif o_down_active = '1' and i_down_active = '1' then
+							elsif down_active = '1' and i_down_active = '1' then
 								-- Written value to DOWN
 								head_ptr <= DecrementPTR(head_ptr);
 								count <= count - 1;
 								-- Check if any values are left in buffer
 								if count > 1 then
 									-- Write to UP
-									o_up_active <= '1';
+									up_active <= '1';
 								end if;
 								-- Read from DOWN
-								o_down_active <= '1';
+								down_active <= '1';
 
 							else -- No previous I/O
 
 								-- Write if a value is still left in buffer
 								if not (count = 0) then
 									-- Write to RIGHT
-									o_right_active <= '1';
+									right_active <= '1';
 								end if;
 
 								-- Read if buffer can take another value
 								if not (count = buffer_length) then
 									-- Read from DOWN
-									o_down_active <= '1';
+									down_active <= '1';
 								end if;
 							end if;
 
 						when TIS_FINISH =>
 							-- Check previous I/O result
-							if o_down_active = '1' and i_down_active = '1' and o_up_active = '1' and i_up_active = '1' then
+							if down_active = '1' and i_down_active = '1' and up_active = '1' and i_up_active = '1' then
 								-- We already know read and write are possible here
 								-- tail_ptr, head_ptr and count stay the same after a simultaneous read/write
-								values(head_ptr) <= to_tis_integer(signed(i_down));
-							elsif o_down_active = '1' and i_down_active = '1' then
+								Store(head_ptr, to_tis_integer(signed(i_down)));
+							elsif down_active = '1' and i_down_active = '1' then
 								-- Read value from DOWN
-								values(IncrementPTR(head_ptr)) <= to_tis_integer(signed(i_down));
+								Store(IncrementPTR(head_ptr), to_tis_integer(signed(i_down)));
 								head_ptr <= IncrementPTR(head_ptr);
 								count <= count + 1;
-							elsif o_up_active = '1' and i_up_active = '1' then
+							elsif up_active = '1' and i_up_active = '1' then
 								-- Written value to UP
 								head_ptr <= DecrementPTR(head_ptr);
 								count <= count - 1;
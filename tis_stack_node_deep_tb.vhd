@@ -0,0 +1,138 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_stack_node_deep_tb is
+end entity;
+
+architecture rtl of tis_stack_node_deep_tb is
+	constant buffer_length : natural := 1024;
+	constant value_count   : natural := 1000;
+
+	signal clock_tb     : std_logic := '0';
+	signal resetn_tb    : std_logic := '1';
+	signal read_tb      : std_logic := '0';
+	signal write_tb     : std_logic := '0';
+	signal address_tb   : std_logic_vector(3 downto 0);
+	signal readdata_tb  : std_logic_vector(15 downto 0);
+	signal writedata_tb : std_logic_vector(15 downto 0);
+	-- Interrupt when data is available for reading
+	signal irq_tb : std_logic;
+	-- Used to avoid early start without initialized program
+	signal tis_active_tb : std_logic := '0';
+	-- Right conduit, the only one taking values
+	signal o_right_tb        : std_logic_vector(10 downto 0);
+	signal o_right_active_tb : std_logic;
+	signal i_right_active_tb : std_logic := '0';
+
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Value written by the memory master at index i
+	function StagedValue(i : natural) return integer is
+	begin
+		return i - 500;
+	end function;
+begin
+
+	stack: entity work.tis_stack_node
+		generic map (
+			buffer_length => buffer_length,
+			BLOCK_RAM     => true
+		)
+		port map (
+			clock          => clock_tb,
+			resetn         => resetn_tb,
+			read           => read_tb,
+			write          => write_tb,
+			address        => address_tb,
+			readdata       => readdata_tb,
+			writedata      => writedata_tb,
+			irq            => irq_tb,
+			tis_active     => tis_active_tb,
+			i_left         => (others => '0'),
+			o_left         => open,
+			o_left_active  => open,
+			i_right        => (others => '0'),
+			i_right_active => i_right_active_tb,
+			o_right        => o_right_tb,
+			o_right_active => o_right_active_tb,
+			i_up           => (others => '0'),
+			o_up           => open,
+			o_up_active    => open,
+			i_down         => (others => '0'),
+			o_down         => open,
+			o_down_active  => open
+		);
+
+	process
+		variable edges    : natural := 0;
+		variable received : natural := 0;
+	begin
+		-- Reset
+		resetn_tb <= '0';
+		ClockPulse(clock_tb);
+		resetn_tb <= '1';
+		ClockPulse(clock_tb);
+
+		-- Write to the grid
+		address_tb <= "0000";
+		write_tb <= '1';
+		writedata_tb <= x"0001";
+		ClockPulse(clock_tb);
+
+		-- Stage more values than the register stack could hold
+		address_tb <= "0001";
+		for i in 0 to value_count - 1 loop
+			writedata_tb <= std_logic_vector(to_signed(StagedValue(i), writedata_tb'length));
+			ClockPulse(clock_tb);
+		end loop;
+		write_tb <= '0';
+		assert irq_tb = '1' report "Didn't get interrupt from values in buffer" severity error;
+
+		-- Count of staged values
+		address_tb <= "0010";
+		read_tb <= '1';
+		ClockPulse(clock_tb);
+		read_tb <= '0';
+		assert to_integer(unsigned(readdata_tb)) = value_count report "Expected count " & to_string(value_count) & ", got " & to_string(to_integer(unsigned(readdata_tb))) severity error;
+
+		-- Memory master reads back the value it wrote last
+		address_tb <= "0001";
+		read_tb <= '1';
+		ClockPulse(clock_tb);
+		read_tb <= '0';
+		assert readdata_tb = std_logic_vector(to_signed(StagedValue(value_count - 1), readdata_tb'length)) report "Expected readdata " & to_string(StagedValue(value_count - 1)) & ", got " & to_string(readdata_tb) severity error;
+
+		-- Values leave in the order they were written, one per cycle through
+		-- RIGHT. Offers made in TIS_LEFT are seen after the second edge.
+		i_right_active_tb <= '1';
+		tis_active_tb <= '1';
+		while received < value_count - 1 and edges < 6 * value_count loop
+			ClockPulse(clock_tb);
+			edges := edges + 1;
+			if edges mod 6 = 2 and o_right_active_tb = '1' then
+				assert o_right_tb = std_logic_vector(to_signed(StagedValue(received), o_right_tb'length)) report "Expected value " & to_string(StagedValue(received)) & " on RIGHT, got " & to_string(to_integer(signed(o_right_tb))) severity error;
+				received := received + 1;
+			end if;
+		end loop;
+		assert received = value_count - 1 report "Expected " & to_string(value_count - 1) & " values on RIGHT, got " & to_string(received) severity error;
+
+		-- Let the last write retire
+		for i in 1 to 6 loop
+			ClockPulse(clock_tb);
+		end loop;
+		tis_active_tb <= '0';
+		assert irq_tb = '0' report "Got interrupt for empty buffer" severity error;
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;
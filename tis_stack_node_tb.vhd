@@ -10,7 +10,7 @@ architecture rtl of tis_stack_node_tb is
 	signal resetn_tb    : std_logic := '1';
 	signal read_tb      : std_logic := '0';
 	signal write_tb     : std_logic := '0';
-	signal address_tb   : std_logic_vector(0 downto 0);
+	signal address_tb   : std_logic_vector(3 downto 0);
 	signal readdata_tb  : std_logic_vector(15 downto 0);
 	signal writedata_tb : std_logic_vector(15 downto 0);
 	-- Interrupt when data is available for reading
@@ -104,7 +104,7 @@ begin
 		TisPulse(clock_tb);
 
 		-- Read from empty buffer
-		address_tb <= "1";
+		address_tb <= "0001";
 		read_tb <= '1';
 		write_tb <= '0';
 		TisPulse(clock_tb);
@@ -112,7 +112,7 @@ begin
 		assert irq_tb = '0' report "Got interrupt for empty buffer" severity error;
 
 		-- Add value to buffer
-		address_tb <= "1";
+		address_tb <= "0001";
 		read_tb <= '0';
 		write_tb <= '1';
 		writedata_tb <= std_logic_vector(to_signed(1000, writedata_tb'length));
@@ -120,7 +120,7 @@ begin
 		assert irq_tb = '1' report "Didn't get interrupt from value in buffer" severity error;
 
 		-- Read value from buffer
-		address_tb <= "1";
+		address_tb <= "0001";
 		read_tb <= '1';
 		write_tb <= '0';
 		TisPulse(clock_tb);
@@ -128,14 +128,14 @@ begin
 		assert irq_tb = '0' report "Got interrupt for empty buffer" severity error;
 
 		-- Read from empty buffer
-		address_tb <= "1";
+		address_tb <= "0001";
 		read_tb <= '1';
 		write_tb <= '0';
 		TisPulse(clock_tb);
 		assert readdata_tb = x"FFFF" report "Expected readdata 0xFFFF, got " & to_string(readdata_tb) severity error;
 
 		-- Add value to buffer
-		address_tb <= "1";
+		address_tb <= "0001";
 		read_tb <= '0';
 		write_tb <= '1';
 		writedata_tb <= std_logic_vector(to_signed(- 1000, writedata_tb'length));
@@ -143,7 +143,7 @@ begin
 		assert irq_tb = '1' report "Didn't get interrupt from value in buffer" severity error;
 
 		-- Read value from buffer
-		address_tb <= "1";
+		address_tb <= "0001";
 		read_tb <= '1';
 		write_tb <= '0';
 		TisPulse(clock_tb);
@@ -151,12 +151,95 @@ begin
 		assert irq_tb = '0' report "Got interrupt for empty buffer" severity error;
 
 		-- Read from empty buffer
-		address_tb <= "1";
+		address_tb <= "0001";
 		read_tb <= '1';
 		write_tb <= '0';
 		TisPulse(clock_tb);
 		assert readdata_tb = x"FFFF" report "Expected readdata 0xFFFF, got " & to_string(readdata_tb) severity error;
 
+		-- Status of the empty buffer
+		address_tb <= "0011";
+		read_tb <= '1';
+		write_tb <= '0';
+		ClockPulse(clock_tb);
+		assert readdata_tb = x"0001" report "Expected empty status, got " & to_string(readdata_tb) severity error;
+
+		-- High-water mark of the single buffered value
+		address_tb <= "0100";
+		ClockPulse(clock_tb);
+		assert readdata_tb = x"0001" report "Expected high-water mark 1, got " & to_string(readdata_tb) severity error;
+
+		-- Clear the high-water mark
+		address_tb <= "0011";
+		read_tb <= '0';
+		write_tb <= '1';
+		ClockPulse(clock_tb);
+
+		-- Fill the buffer through the data window
+		for i in 0 to 14 loop
+			address_tb <= std_logic_vector(to_unsigned(8 + i mod 8, address_tb'length));
+			writedata_tb <= std_logic_vector(to_signed(i, writedata_tb'length));
+			ClockPulse(clock_tb);
+		end loop;
+		write_tb <= '0';
+
+		address_tb <= "0011";
+		read_tb <= '1';
+		ClockPulse(clock_tb);
+		assert readdata_tb = x"0002" report "Expected full status, got " & to_string(readdata_tb) severity error;
+
+		address_tb <= "0010";
+		ClockPulse(clock_tb);
+		assert to_integer(unsigned(readdata_tb)) = 15 report "Expected count 15, got " & to_string(to_integer(unsigned(readdata_tb))) severity error;
+
+		address_tb <= "0100";
+		ClockPulse(clock_tb);
+		assert to_integer(unsigned(readdata_tb)) = 15 report "Expected high-water mark 15, got " & to_string(to_integer(unsigned(readdata_tb))) severity error;
+
+		-- Drain it in a burst, the value written last comes back first
+		for i in 14 downto 0 loop
+			address_tb <= std_logic_vector(to_unsigned(8 + i mod 8, address_tb'length));
+			ClockPulse(clock_tb);
+			assert readdata_tb = std_logic_vector(to_signed(i, readdata_tb'length)) report "Expected readdata " & to_string(i) & ", got " & to_string(readdata_tb) severity error;
+		end loop;
+
+		address_tb <= "0011";
+		ClockPulse(clock_tb);
+		read_tb <= '0';
+		assert readdata_tb = x"0001" report "Expected empty status, got " & to_string(readdata_tb) severity error;
+		assert irq_tb = '0' report "Got interrupt for empty buffer" severity error;
+
+		-- Read three values from LEFT before any of them is drained. head_ptr
+		-- used to follow tail_ptr, so the third read overwrote the second.
+		address_tb <= "0000";
+		write_tb <= '1';
+		writedata_tb <= x"0002";
+		ClockPulse(clock_tb);
+		write_tb <= '0';
+
+		tis_active_tb <= '1';
+		i_left_active_tb <= '1';
+		for i in 1 to 3 loop
+			i_left_tb <= std_logic_vector(to_signed(i * 100, i_left_tb'length));
+			TisPulse(clock_tb);
+		end loop;
+		i_left_active_tb <= '0';
+		tis_active_tb <= '0';
+
+		address_tb <= "0010";
+		read_tb <= '1';
+		ClockPulse(clock_tb);
+		assert to_integer(unsigned(readdata_tb)) = 3 report "Expected count 3, got " & to_string(to_integer(unsigned(readdata_tb))) severity error;
+
+		-- All come out in the order they arrived
+		for i in 1 to 3 loop
+			address_tb <= "0001";
+			ClockPulse(clock_tb);
+			assert readdata_tb = std_logic_vector(to_signed(i * 100, readdata_tb'length)) report "Expected readdata " & to_string(i * 100) & ", got " & to_string(to_integer(signed(readdata_tb))) severity error;
+		end loop;
+		read_tb <= '0';
+
+		report "Testbench success!!!" severity note;
 		std.env.stop;
 	end process;
 end architecture;
@@ -0,0 +1,287 @@
+-- altera vhdl_input_version vhdl_2008
+library IEEE;
+	use IEEE.std_logic_1164.all;
+	use IEEE.numeric_std.all;
+
+	-- Records the state of selected grid nodes at the end of every TIS cycle
+	-- into on-chip RAM, so full speed runs can be inspected afterwards. Takes
+	-- the debug outputs of tis_grid and the phase of tis_controller. Entries
+	-- are two words, drained oldest first through the data register:
+	--   word 0: ACC (10..0), BAK (21..11), PC (28..22)
+	--   word 1: transfers (3..0), node (12..8), cycle (31..16)
+	-- Transfers are the ports with both sides active during the cycle, bit 0
+	-- for UP up to bit 3 for RIGHT. Registers:
+	--   0: control, bit 0 enable, bit 1 wrap, bits 3..2 trigger, writing
+	--      bit 4 clears the buffer, the cycle count and the flags. Reads
+	--      back bit 5 triggered and bit 6 overflow.
+	--   1: node select mask
+	--   2: trigger node
+	--   3: trigger value
+	--   4: cycle count (read)
+	--   5: entries in the buffer (read)
+	--   6: next word of the oldest entry, 0 when empty (read)
+	-- Recording starts with the cycle that meets the trigger: 0 right away,
+	-- 1 PC of the trigger node equal to the value, 2 ACC of the trigger node
+	-- equal to the value, 3 cycle count at least the value. A full buffer
+	-- drops new entries, or the oldest ones with wrap. Entries are written
+	-- one per clock, so more than 6 selected nodes can't keep up at full
+	-- speed. Either case sets overflow.
+
+entity tis_trace is
+	generic (
+		-- Node count of the traced grid
+		nodes      : positive range 1 to 32  := 3;
+		-- Holds 2 ** depth_bits entries
+		depth_bits : positive range 1 to 14 := 9
+	);
+	port (
+		clock, resetn   : in  std_logic;
+		read, write     : in  std_logic;
+		address         : in  std_logic_vector(2 downto 0);
+		readdata        : out std_logic_vector(31 downto 0);
+		writedata       : in  std_logic_vector(31 downto 0);
+
+		-- From tis_controller
+		tis_active      : in  std_logic;
+		tis_phase       : in  std_logic_vector(5 downto 0);
+
+		-- From tis_grid
+		debug_pc        : in  std_logic_vector(7 * nodes - 1 downto 0);
+		debug_acc       : in  std_logic_vector(11 * nodes - 1 downto 0);
+		debug_bak       : in  std_logic_vector(11 * nodes - 1 downto 0);
+		debug_transfers : in  std_logic_vector(4 * nodes - 1 downto 0)
+	);
+end entity;
+
+architecture rtl of tis_trace is
+	constant entries : positive := 2 ** depth_bits;
+
+	type memory is array (0 to entries - 1) of std_logic_vector(63 downto 0);
+
+	-- Lowest selected node still waiting to be written
+	pure function NextNode(pending : std_logic_vector) return natural is
+	begin
+		for n in 0 to nodes - 1 loop
+			if pending(n) = '1' then
+				return n;
+			end if;
+		end loop;
+		return 0;
+	end function;
+
+	-- Settings
+	signal enable        : std_logic                            := '0';
+	signal wrap          : std_logic                            := '0';
+	signal trigger_mode  : std_logic_vector(1 downto 0)         := "00";
+	signal node_select   : std_logic_vector(nodes - 1 downto 0) := (others => '0');
+	signal trigger_node  : natural range 0 to nodes - 1         := 0;
+	signal trigger_value : std_logic_vector(31 downto 0)        := (others => '0');
+
+	-- Status
+	signal triggered     : std_logic             := '0';
+	signal overflow      : std_logic             := '0';
+	signal cycle         : unsigned(31 downto 0) := (others => '0');
+
+	-- Last clock was TIS_FINISH, the debug outputs hold the finished cycle
+	signal cycle_done    : std_logic := '0';
+	signal transfers     : std_logic_vector(4 * nodes - 1 downto 0) := (others => '0');
+
+	-- Cycle being written out
+	signal pending       : std_logic_vector(nodes - 1 downto 0) := (others => '0');
+	signal snapshot_pc   : std_logic_vector(7 * nodes - 1 downto 0);
+	signal snapshot_acc  : std_logic_vector(11 * nodes - 1 downto 0);
+	signal snapshot_bak  : std_logic_vector(11 * nodes - 1 downto 0);
+	signal snapshot_io   : std_logic_vector(4 * nodes - 1 downto 0);
+	signal snapshot_time : std_logic_vector(15 downto 0);
+
+	-- Buffer
+	signal write_ptr     : unsigned(depth_bits - 1 downto 0) := (others => '0');
+	signal read_ptr      : unsigned(depth_bits - 1 downto 0) := (others => '0');
+	signal count         : natural range 0 to entries        := 0;
+	signal upper_half    : std_logic := '0'; -- Next read returns word 1
+
+	signal pop           : std_logic; -- Data read that finishes the oldest entry
+
+	signal ram             : memory;
+	signal ram_write       : std_logic;
+	signal ram_write_value : std_logic_vector(63 downto 0);
+	signal ram_output      : std_logic_vector(63 downto 0);
+
+	-- Readdata comes from the RAM after a data read
+	signal read_from_ram   : std_logic := '0';
+	signal read_upper      : std_logic := '0';
+	signal reg_readdata    : std_logic_vector(31 downto 0) := (others => '0');
+begin
+
+	readdata <= reg_readdata when read_from_ram = '0' else
+	            ram_output(63 downto 32) when read_upper = '1' else
+	            ram_output(31 downto 0);
+
+	pop <= '1' when read = '1' and address = "110" and count > 0 and upper_half = '1' else '0';
+
+	-- Entry of the lowest pending node. A full buffer only drops its oldest
+	-- entry between reads, so the two words of an entry always match.
+	ram_write <= '1' when pending /= (pending'range => '0') and
+	                      (count < entries or pop = '1' or (wrap = '1' and upper_half = '0')) else '0';
+
+	entry: process (all)
+		variable n : natural range 0 to nodes - 1;
+	begin
+		n := NextNode(pending);
+		ram_write_value <= (others => '0');
+		ram_write_value(10 downto 0) <= snapshot_acc(11 * n + 10 downto 11 * n);
+		ram_write_value(21 downto 11) <= snapshot_bak(11 * n + 10 downto 11 * n);
+		ram_write_value(28 downto 22) <= snapshot_pc(7 * n + 6 downto 7 * n);
+		ram_write_value(35 downto 32) <= snapshot_io(4 * n + 3 downto 4 * n);
+		ram_write_value(44 downto 40) <= std_logic_vector(to_unsigned(n, 5));
+		ram_write_value(63 downto 48) <= snapshot_time;
+	end process;
+
+	-- Simple dual port RAM, the read port follows the oldest entry
+	block_memory: process (clock)
+	begin
+		if rising_edge(clock) then
+			if ram_write = '1' then
+				ram(to_integer(write_ptr)) <= ram_write_value;
+			end if;
+			ram_output <= ram(to_integer(read_ptr));
+		end if;
+	end process;
+
+	process (clock, resetn)
+		variable hit        : boolean;
+		variable remaining  : std_logic_vector(nodes - 1 downto 0);
+		variable next_count : natural range 0 to entries;
+		variable next_read  : unsigned(depth_bits - 1 downto 0);
+	begin
+		if resetn = '0' then
+			enable <= '0';
+			wrap <= '0';
+			trigger_mode <= "00";
+			node_select <= (others => '0');
+			trigger_node <= 0;
+			trigger_value <= (others => '0');
+			triggered <= '0';
+			overflow <= '0';
+			cycle <= (others => '0');
+			cycle_done <= '0';
+			transfers <= (others => '0');
+			pending <= (others => '0');
+			write_ptr <= (others => '0');
+			read_ptr <= (others => '0');
+			count <= 0;
+			upper_half <= '0';
+			read_from_ram <= '0';
+			read_upper <= '0';
+			reg_readdata <= (others => '0');
+		elsif rising_edge(clock) then
+			next_count := count;
+			next_read := read_ptr;
+
+			-- Write out one pending node
+			remaining := pending;
+			if pending /= (pending'range => '0') then
+				remaining(NextNode(pending)) := '0';
+				if ram_write = '0' or (count = entries and pop = '0') then
+					overflow <= '1';
+				end if;
+				if ram_write = '1' then
+					write_ptr <= write_ptr + 1;
+					if count = entries and pop = '0' then
+						-- Oldest entry makes room
+						next_read := next_read + 1;
+					else
+						next_count := next_count + 1;
+					end if;
+				end if;
+			end if;
+			pending <= remaining;
+
+			-- Capture the finished cycle
+			cycle_done <= tis_active and tis_phase(5);
+			transfers <= transfers or debug_transfers;
+
+			if cycle_done = '1' then
+				transfers <= debug_transfers;
+				cycle <= cycle + 1;
+
+				case trigger_mode is
+					when "01" => hit := debug_pc(7 * trigger_node + 6 downto 7 * trigger_node) = trigger_value(6 downto 0);
+					when "10" => hit := debug_acc(11 * trigger_node + 10 downto 11 * trigger_node) = trigger_value(10 downto 0);
+					when "11" => hit := cycle >= unsigned(trigger_value);
+					when others => hit := true;
+				end case;
+
+				if enable = '1' and (triggered = '1' or hit) then
+					triggered <= '1';
+					-- Previous cycle is still being written
+					if remaining /= (remaining'range => '0') then
+						overflow <= '1';
+					end if;
+					pending <= node_select;
+					snapshot_pc <= debug_pc;
+					snapshot_acc <= debug_acc;
+					snapshot_bak <= debug_bak;
+					snapshot_io <= transfers;
+					snapshot_time <= std_logic_vector(cycle(15 downto 0));
+				end if;
+			end if;
+
+			-- Avalon slave
+			read_from_ram <= '0';
+			if read = '1' then
+				reg_readdata <= (others => '0');
+				case to_integer(unsigned(address)) is
+					when 0 =>
+						reg_readdata(0) <= enable;
+						reg_readdata(1) <= wrap;
+						reg_readdata(3 downto 2) <= trigger_mode;
+						reg_readdata(5) <= triggered;
+						reg_readdata(6) <= overflow;
+					when 1 => reg_readdata(nodes - 1 downto 0) <= node_select;
+					when 2 => reg_readdata <= std_logic_vector(to_unsigned(trigger_node, 32));
+					when 3 => reg_readdata <= trigger_value;
+					when 4 => reg_readdata <= std_logic_vector(cycle);
+					when 5 => reg_readdata <= std_logic_vector(to_unsigned(count, 32));
+					when 6 =>
+						if count > 0 then
+							read_from_ram <= '1';
+							read_upper <= upper_half;
+							upper_half <= not upper_half;
+						end if;
+					when others => null;
+				end case;
+			end if;
+
+			if pop = '1' then
+				next_read := next_read + 1;
+				next_count := next_count - 1;
+			end if;
+			read_ptr <= next_read;
+			count <= next_count;
+
+			if write = '1' then
+				case to_integer(unsigned(address)) is
+					when 0 =>
+						enable <= writedata(0);
+						wrap <= writedata(1);
+						trigger_mode <= writedata(3 downto 2);
+						if writedata(4) = '1' then
+							triggered <= '0';
+							overflow <= '0';
+							cycle <= (others => '0');
+							pending <= (others => '0');
+							write_ptr <= (others => '0');
+							read_ptr <= (others => '0');
+							count <= 0;
+							upper_half <= '0';
+						end if;
+					when 1 => node_select <= writedata(nodes - 1 downto 0);
+					when 2 => trigger_node <= to_integer(unsigned(writedata(4 downto 0))) mod nodes;
+					when 3 => trigger_value <= writedata;
+					when others => null;
+				end case;
+			end if;
+		end if;
+	end process;
+end architecture;
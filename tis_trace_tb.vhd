@@ -0,0 +1,245 @@
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+entity tis_trace_tb is
+end entity;
+
+architecture rtl of tis_trace_tb is
+	-- Signle rising edge
+	procedure ClockPulse(signal clk : inout std_logic) is
+	begin
+		wait for 1 ns;
+		clk <= '0';
+		wait for 1 ns;
+		clk <= '1';
+		wait for 1 ns;
+	end procedure;
+
+	-- Full TIS I/O Cycle
+	procedure TisPulse(signal clk : inout std_logic) is
+	begin
+		-- Each cycle needs 6 rising edges
+		for i in 1 to 6 loop
+			wait for 1 ns;
+			clk <= '0';
+			wait for 1 ns;
+			clk <= '1';
+		end loop;
+
+		wait for 1 ns;
+	end procedure;
+
+	-- Word address of a register in the node at index (row * cols + col)
+	function NodeAddress(node : natural; word : natural) return std_logic_vector is
+	begin
+		return std_logic_vector(to_unsigned(node * 8 + word, 5));
+	end function;
+
+	-- Word address of a tis_trace register
+	function TraceAddress(word : natural) return std_logic_vector is
+	begin
+		return std_logic_vector(to_unsigned(word, 3));
+	end function;
+
+	-- Avalon slave signals
+	signal clock_tb      : std_logic;
+	signal resetn_tb     : std_logic;
+	signal read_tb       : std_logic;
+	signal write_tb      : std_logic;
+	signal address_tb    : std_logic_vector(4 downto 0);
+	signal readdata_tb   : std_logic_vector(31 downto 0);
+	signal writedata_tb  : std_logic_vector(31 downto 0);
+	signal byteenable_tb : std_logic_vector(3 downto 0);
+	signal irq_tb        : std_logic;
+
+	-- Trace slave, shares writedata
+	signal trace_read_tb     : std_logic;
+	signal trace_write_tb    : std_logic;
+	signal trace_address_tb  : std_logic_vector(2 downto 0);
+	signal trace_readdata_tb : std_logic_vector(31 downto 0);
+
+	-- Debug outputs of the grid
+	signal debug_pc_tb        : std_logic_vector(20 downto 0);
+	signal debug_acc_tb       : std_logic_vector(32 downto 0);
+	signal debug_bak_tb       : std_logic_vector(32 downto 0);
+	signal debug_transfers_tb : std_logic_vector(11 downto 0);
+
+	-- TIS signals
+	signal tis_active_tb : std_logic;
+	signal tis_phase_tb  : std_logic_vector(5 downto 0) := "000001";
+begin
+	-- Same layout as tis_system: stack input, execution node, stack output
+	grid: entity work.tis_grid
+		generic map (
+			rows        => 3,
+			cols        => 1,
+			stack_nodes => "101"
+		)
+		port map (
+			clock           => clock_tb,
+			resetn          => resetn_tb,
+			read            => read_tb,
+			write           => write_tb,
+			address         => address_tb,
+			readdata        => readdata_tb,
+			writedata       => writedata_tb,
+			byteenable      => byteenable_tb,
+			irq             => irq_tb,
+			tis_active      => tis_active_tb,
+			debug_pc        => debug_pc_tb,
+			debug_acc       => debug_acc_tb,
+			debug_bak       => debug_bak_tb,
+			debug_transfers => debug_transfers_tb
+		);
+
+	trace: entity work.tis_trace
+		generic map (
+			nodes      => 3,
+			depth_bits => 4
+		)
+		port map (
+			clock           => clock_tb,
+			resetn          => resetn_tb,
+			read            => trace_read_tb,
+			write           => trace_write_tb,
+			address         => trace_address_tb,
+			readdata        => trace_readdata_tb,
+			writedata       => writedata_tb,
+			tis_active      => tis_active_tb,
+			tis_phase       => tis_phase_tb,
+			debug_pc        => debug_pc_tb,
+			debug_acc       => debug_acc_tb,
+			debug_bak       => debug_bak_tb,
+			debug_transfers => debug_transfers_tb
+		);
+
+	-- Phase bus as driven by tis_controller
+	phase: process (clock_tb)
+	begin
+		if rising_edge(clock_tb) and tis_active_tb = '1' then
+			tis_phase_tb <= tis_phase_tb(4 downto 0) & tis_phase_tb(5);
+		end if;
+	end process;
+
+	process
+		variable entries : natural;
+
+		procedure TraceWrite(word : natural; value : std_logic_vector(31 downto 0)) is
+		begin
+			trace_write_tb <= '1';
+			trace_address_tb <= TraceAddress(word);
+			writedata_tb <= value;
+			ClockPulse(clock_tb);
+			trace_write_tb <= '0';
+		end procedure;
+
+		procedure TraceRead(word : natural) is
+		begin
+			trace_read_tb <= '1';
+			trace_address_tb <= TraceAddress(word);
+			ClockPulse(clock_tb);
+			trace_read_tb <= '0';
+		end procedure;
+	begin
+		-- Reset
+		clock_tb <= '0';
+		resetn_tb <= '0';
+		read_tb <= '0';
+		write_tb <= '0';
+		trace_read_tb <= '0';
+		trace_write_tb <= '0';
+		trace_address_tb <= (others => '0');
+		tis_active_tb <= '0';
+		byteenable_tb <= (others => '1');
+		writedata_tb <= (others => '0');
+		address_tb <= (others => '0');
+		ClockPulse(clock_tb);
+		resetn_tb <= '1';
+		ClockPulse(clock_tb);
+
+		-- MOV UP, ACC / ADD ACC / MOV ACC, DOWN
+		write_tb <= '1';
+		address_tb <= NodeAddress(1, 0);
+		writedata_tb <= x"C802" & x"0002";
+		ClockPulse(clock_tb);
+
+		address_tb <= NodeAddress(1, 1);
+		writedata_tb <= x"D801" & x"0801";
+		ClockPulse(clock_tb);
+
+		-- Stack input writes to the grid, stack output reads from it
+		byteenable_tb <= "0011";
+		address_tb <= NodeAddress(0, 0);
+		writedata_tb <= x"0000" & x"0001";
+		ClockPulse(clock_tb);
+
+		address_tb <= NodeAddress(2, 0);
+		writedata_tb <= x"0000" & x"0002";
+		ClockPulse(clock_tb);
+
+		-- Push 21 through the upper halfword
+		byteenable_tb <= "1100";
+		address_tb <= NodeAddress(0, 0);
+		writedata_tb <= std_logic_vector(to_signed(21, 16)) & x"0000";
+		ClockPulse(clock_tb);
+		write_tb <= '0';
+		byteenable_tb <= (others => '1');
+
+		-- Trace the execution node from the cycle that doubled the value
+		TraceWrite(1, x"00000002");
+		TraceWrite(2, x"00000001");
+		TraceWrite(3, std_logic_vector(to_signed(42, 32)));
+		TraceWrite(0, x"00000009");
+
+		tis_active_tb <= '1';
+		for i in 1 to 8 loop
+			TisPulse(clock_tb);
+		end loop;
+		tis_active_tb <= '0';
+
+		-- Capture and write out the last cycle
+		ClockPulse(clock_tb);
+		ClockPulse(clock_tb);
+
+		TraceRead(0);
+		assert trace_readdata_tb(5) = '1' report "Trace didn't trigger on ACC = 42" severity error;
+		assert trace_readdata_tb(6) = '0' report "Trace overflowed" severity error;
+
+		TraceRead(4);
+		assert unsigned(trace_readdata_tb) = 8 report "Expected 8 cycles, got " & to_string(to_integer(unsigned(trace_readdata_tb))) severity error;
+
+		TraceRead(5);
+		entries := to_integer(unsigned(trace_readdata_tb));
+		assert entries > 0 and entries < 8 report "Expected an entry per cycle after the trigger, got " & to_string(entries) severity error;
+
+		-- Oldest entry is the trigger cycle
+		TraceRead(6);
+		assert trace_readdata_tb(10 downto 0) = std_logic_vector(to_signed(42, 11)) report "Expected ACC 42 in the first entry, got " & to_hstring(trace_readdata_tb) severity error;
+		TraceRead(6);
+		assert trace_readdata_tb(12 downto 8) = "00001" report "Expected node 1 in the first entry, got " & to_hstring(trace_readdata_tb) severity error;
+		assert unsigned(trace_readdata_tb(31 downto 16)) = 8 - entries report "Expected first entry at cycle " & to_string(8 - entries) & ", got " & to_hstring(trace_readdata_tb) severity error;
+
+		for i in 2 to entries loop
+			TraceRead(6);
+			TraceRead(6);
+			assert unsigned(trace_readdata_tb(31 downto 16)) = 8 - entries + i - 1 report "Expected entry " & to_string(i) & " one cycle after the last, got " & to_hstring(trace_readdata_tb) severity error;
+		end loop;
+
+		TraceRead(5);
+		assert unsigned(trace_readdata_tb) = 0 report "Expected drained trace, got " & to_hstring(trace_readdata_tb) severity error;
+		TraceRead(6);
+		assert unsigned(trace_readdata_tb) = 0 report "Expected 0 from an empty trace, got " & to_hstring(trace_readdata_tb) severity error;
+
+		-- The result made it through while tracing
+		read_tb <= '1';
+		byteenable_tb <= "1100";
+		address_tb <= NodeAddress(2, 0);
+		ClockPulse(clock_tb);
+		read_tb <= '0';
+		assert readdata_tb(31 downto 16) = std_logic_vector(to_signed(42, 16)) report "Expected readdata 42, got " & to_string(readdata_tb(31 downto 16)) severity error;
+
+		report "Testbench success!!!" severity note;
+		std.env.stop;
+	end process;
+end architecture;